@@ -1,16 +1,19 @@
 #include "Iso14443aAskAnalyzer.h"
 #include "Iso14443aAskAnalyzerSettings.h"
 #include "Iso14443aAskAnalyzerResults.h"
+#include "Iso14443aBlockFields.h"
 #include "AnalyzerHelpers.h"
 #include <AnalyzerChannelData.h>
-#include <deque>
-#include <tuple>
-#include <algorithm>
 
-U32 FREQ_CARRIER = 13560000;
+static const U32 COMMIT_MAX_PENDING_FRAMES = 1024;
 
 
-Iso14443aAskAnalyzer::Iso14443aAskAnalyzer() : Analyzer2(), mSettings( new Iso14443aAskAnalyzerSettings() ), mSimulationInitilized( false )
+Iso14443aAskAnalyzer::Iso14443aAskAnalyzer()
+    : Analyzer2(),
+      mSettings( new Iso14443aAskAnalyzerSettings() ),
+      mAskDecoder( mAskEdgeSource, *this ),
+      mBlockDecoder( *this ),
+      mSimulationInitilized( false )
 {
     SetAnalyzerSettings( mSettings.get() );
     UseFrameV2();
@@ -31,281 +34,139 @@ void Iso14443aAskAnalyzer::SetupResults()
 }
 
 
-std::tuple<U8, U64> Iso14443aAskAnalyzer::ReceiveAskSeq( AskFrame& ask_frame )
+void Iso14443aAskAnalyzer::OnMarker( U64 sample, Iso14443a::MarkerType type )
 {
-    U32 bit_changes = 0;
-    U8 seq = 0;
-
-    U64 seq_start_sample = ask_frame.frame_start_sample + U64( ask_frame.seq_num * mAskSamplesPerBit );
-    ask_frame.seq_num++;
-
-    // mark start of sequence
-    mResults->AddMarker( U64( seq_start_sample ), AnalyzerResults::Start, mSettings->mAskInputChannel );
-
-    // wait for first bit half
-    ask_frame.frame_end_sample = seq_start_sample + U64( mAskOffsetToFrameStart );
-    bit_changes = mAskSerial->AdvanceToAbsPosition( ask_frame.frame_end_sample );
-    if( bit_changes > 1 )
-    {
-        return { ASK_SEQ_ERROR, seq_start_sample };
-    }
-
-    // mark sampling point
-    mResults->AddMarker( mAskSerial->GetSampleNumber(), AnalyzerResults::Dot, mSettings->mAskInputChannel );
-    if( mAskSerial->GetBitState() != mAskIdleState )
+    switch( type )
     {
-        seq |= 0b10;
-    }
-
-    // wait for second bit half
-    ask_frame.frame_end_sample = seq_start_sample + U64( mAskOffsetToFrameStart + ( mAskSamplesPerBit / 2 ) );
-    bit_changes = mAskSerial->AdvanceToAbsPosition( ask_frame.frame_end_sample );
-    if( bit_changes > 1 )
-    {
-        return { ASK_SEQ_ERROR, seq_start_sample };
+    case Iso14443a::MarkerType::SequenceStart:
+        mResults->AddMarker( sample, AnalyzerResults::Start, mSettings->mAskInputChannel );
+        break;
+    case Iso14443a::MarkerType::SamplingPoint:
+        mResults->AddMarker( sample, AnalyzerResults::Dot, mSettings->mAskInputChannel );
+        break;
+    case Iso14443a::MarkerType::Error:
+        mResults->AddMarker( sample, AnalyzerResults::ErrorX, mSettings->mAskInputChannel );
+        break;
     }
+}
 
-    // mark sampling point
-    mResults->AddMarker( mAskSerial->GetSampleNumber(), AnalyzerResults::Dot, mSettings->mAskInputChannel );
-    if( mAskSerial->GetBitState() != mAskIdleState )
+void Iso14443aAskAnalyzer::AddResultFrame( Frame& frame )
+{
+    mResults->AddFrame( frame );
+    if( mCommitScheduler.AddFrame( frame.mEndingSampleInclusive ) )
     {
-        seq |= 0b01;
+        mResults->CommitResults();
+        ReportProgress( frame.mEndingSampleInclusive );
     }
+}
 
+void Iso14443aAskAnalyzer::OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+{
     if( mAskOutputFormat == AskOutputFormat::Sequences )
     {
         Frame frame;
         frame.mType = FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE;
         frame.mData1 = seq;
-        frame.mStartingSampleInclusive = seq_start_sample;
-        frame.mEndingSampleInclusive = S64( seq_start_sample + mAskSamplesPerBit ) - 1;
-        mResults->AddFrame( frame );
-        mResults->CommitResults();
-        ReportProgress( frame.mEndingSampleInclusive );
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
-
-    return { seq, seq_start_sample };
 }
 
-
-Iso14443aAskAnalyzer::AskFrame::AskError Iso14443aAskAnalyzer::ReceiveAskFrameStartOfCommunication( AskFrame& ask_frame )
+void Iso14443aAskAnalyzer::OnStartOfCommunication( U64 start_sample, U64 end_sample )
 {
-    // wait for edge as start condition (eg. rising edge)
-    mAskSerial->AdvanceToNextEdge();
-    ask_frame.frame_start_sample = mAskSerial->GetSampleNumber();
-    ask_frame.seq_num = 0;
-
-    // detect start of communication
-    auto seq = ReceiveAskSeq( ask_frame );
-
-    if( std::get<0>( seq ) != ASK_SEQ_Z )
+    if( mAskOutputFormat == AskOutputFormat::Bytes )
     {
-        // ERROR
-        ask_frame.error = AskFrame::AskError::ErrorWrongSoc;
-        return ask_frame.error;
+        Frame frame;
+        frame.mType = FRAME_TYPE_VIEW_BYTES_SOC;
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
+}
 
-    ask_frame.frame_data_start_sample = U64( ask_frame.frame_start_sample + mAskSamplesPerBit );
-
-    // Save SOC
+void Iso14443aAskAnalyzer::OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+{
     if( mAskOutputFormat == AskOutputFormat::Bytes )
     {
         Frame frame;
-        frame.mType = FRAME_TYPE_VIEW_BYTES_SOC;
-        frame.mStartingSampleInclusive = ask_frame.frame_start_sample;
-        frame.mEndingSampleInclusive = ask_frame.frame_data_start_sample - 1;
-        mResults->AddFrame( frame );
-        mResults->CommitResults();
-        ReportProgress( frame.mEndingSampleInclusive );
+        frame.mData1 = byte;
+        frame.mData2 = valid_bits;
+        frame.mType = FRAME_TYPE_VIEW_BYTES_BYTE;
+        frame.mFlags = parity_error ? FRAME_FLAG_PARITY_ERROR : 0;
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
-
-    return AskFrame::AskError::Ok;
 }
 
+void Iso14443aAskAnalyzer::OnEndOfCommunication( U64 start_sample, U64 end_sample )
+{
+    if( mAskOutputFormat == AskOutputFormat::Bytes )
+    {
+        Frame frame;
+        frame.mType = FRAME_TYPE_VIEW_BYTES_EOC;
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
+    }
+}
 
-Iso14443aAskAnalyzer::AskFrame::AskError Iso14443aAskAnalyzer::ReceiveAskFrameData( AskFrame& ask_frame )
+void Iso14443aAskAnalyzer::OnFrame( const Iso14443a::DecodedFrame& ask_frame, U64 start_sample, U64 end_sample )
 {
-    bool end_of_communication = false;
+    // ISO14443-3 state after this frame
+    Iso14443a::CommandType type = mCommandDecoder.DecodeCommand( ask_frame );
 
-    std::deque<std::tuple<U8, U64>> bit_buffer;
+    // ISO14443-4 block, a finished APDU is queued in front of the frame of its first block
+    Iso14443a::BlockInfo block;
+    bool has_block = false;
+    if( type == Iso14443a::CommandType::Unknown )
+    {
+        has_block = mBlockDecoder.DecodeBlock( ask_frame, false, start_sample, end_sample, block );
+    }
+    else
+    {
+        // an ISO14443-3 frame leaves the ISO14443-4 protocol, an unfinished chain was aborted
+        mBlockDecoder.Reset();
+    }
 
+    Iso14443aFrameV2Queue::Record& frameV2 = mFramesV2.Add( "ask_frame", start_sample, end_sample );
 
-    // last_bit must be 0, because a logic "0" followed by the start of communication must begin with SeqZ instead of SeqY
-    std::tuple<U8, U64> last_bit = { 0, ask_frame.frame_data_start_sample };
-    bool last_bit_available{ false };
+    frameV2.AddByteArray( "value", ask_frame.data.data(), ask_frame.data.size() );
+    frameV2.AddString( "status", Iso14443a::GetFrameStatusString( ask_frame.error ) );
+    frameV2.AddString( "crc", Iso14443a::GetCrcStatusString( ask_frame.crc ) );
+    frameV2.AddInteger( "valid_bits_of_last_byte", ask_frame.data_valid_bits_in_last_byte );
+    frameV2.AddInteger( "bit_rate", Iso14443a::GetBitRateKbps( ask_frame.bit_rate ) );
 
-    while( true )
+    frameV2.AddString( "type", Iso14443a::GetCommandTypeString( type ) );
+    frameV2.AddInteger( "cascade_level", mCommandDecoder.GetCascadeLevel() );
+    if( mCommandDecoder.GetUidLength() > 0 )
     {
-        auto seq = ReceiveAskSeq( ask_frame );
-
-        if( std::get<0>( seq ) == ASK_SEQ_X )
-        {
-            // logic "1"
-            last_bit = { 1, std::get<1>( seq ) };
-            last_bit_available = true;
-        }
-        else if( ( ( std::get<0>( last_bit ) == 0 ) && ( std::get<0>( seq ) == ASK_SEQ_Z ) ) ||
-                 ( ( std::get<0>( last_bit ) == 1 ) && ( std::get<0>( seq ) == ASK_SEQ_Y ) ) )
-        {
-            // logic "0"
-            last_bit = { 0, std::get<1>( seq ) };
-            last_bit_available = true;
-        }
-        else if( ( std::get<0>( last_bit ) == 0 ) && ( std::get<0>( seq ) == ASK_SEQ_Y ) )
-        {
-            end_of_communication = true;
-        }
-        else
-        {
-            // ERROR
-            ask_frame.error = AskFrame::AskError::ErrorWrongSequence;
-            return ask_frame.error;
-        }
-
-        bool byte_complete = bit_buffer.size() == 9; // 8 data bits + 1 parity bit
-
-        // If a byte is completely recevied or an "end of communication" is detected (incomplete bytes are valid) show it
-        if( byte_complete || end_of_communication )
-        {
-            S8 bits_in_byte = S8( bit_buffer.size() );
-
-            if( end_of_communication )
-            {
-                bits_in_byte--; // last bit belogs to eoc
-            }
-
-            if( bits_in_byte > 0 )
-            {
-                U64 bit_starting_sample = std::get<1>( bit_buffer[ 0 ] );
-                U64 bit_ending_sample = 0;
-                U8 byte = 0;
-                for( U8 i = 0; i < std::min( U8( bits_in_byte ), U8( 8 ) ); i++ )
-                {
-                    byte |= std::get<0>( bit_buffer[ 0 ] ) << i;
-                    bit_ending_sample = std::get<1>( bit_buffer[ 0 ] );
-                    bit_buffer.pop_front();
-                }
-
-                U8 frame_flags = 0;
-                if( bits_in_byte == 9 )
-                {
-                    U8 parity_bit = std::get<0>( bit_buffer[ 0 ] );
-                    bit_ending_sample = std::get<1>( bit_buffer[ 0 ] );
-                    bit_buffer.pop_front();
-                    bits_in_byte--;
-
-                    if( AnalyzerHelpers::IsOdd( AnalyzerHelpers::GetOnesCount( byte ) ) == bool( parity_bit ) )
-                    {
-                        frame_flags = FRAME_FLAG_PARITY_ERROR;
-                        ask_frame.error = AskFrame::AskError::ErrorParity;
-                    }
-                }
-
-                bit_ending_sample += U64( mAskSamplesPerBit );
-
-                ask_frame.data.push_back( byte );
-                ask_frame.data_valid_bits_in_last_byte = bits_in_byte;
-
-                if( mAskOutputFormat == AskOutputFormat::Bytes )
-                {
-                    Frame frame;
-                    frame.mData1 = byte;
-                    frame.mData2 = bits_in_byte;
-                    frame.mType = FRAME_TYPE_VIEW_BYTES_BYTE;
-                    frame.mFlags = frame_flags;
-                    frame.mStartingSampleInclusive = bit_starting_sample;
-                    frame.mEndingSampleInclusive = bit_ending_sample;
-                    mResults->AddFrame( frame );
-                    mResults->CommitResults();
-                    ReportProgress( frame.mEndingSampleInclusive );
-                }
-            }
-        }
-
-        if( end_of_communication == true )
-        {
-            U64 eoc_starting_sample = std::get<1>( last_bit );
-            U64 eoc_ending_sample{ 0U };
-            if( last_bit_available )
-            {
-                // last bit is available, so the eoc is only one bit wide
-                eoc_ending_sample = U64( eoc_starting_sample + ( 2 * mAskSamplesPerBit ) );
-            }
-            else
-            {
-                // no last bit availabe, so the eoc is only one bit wide
-                eoc_ending_sample = U64( eoc_starting_sample + ( 1 * mAskSamplesPerBit ) );
-            }
-
-            // wait until the end of the frame
-            ask_frame.frame_end_sample = eoc_ending_sample;
-            mAskSerial->AdvanceToAbsPosition( ask_frame.frame_end_sample );
-
-            if( mAskOutputFormat == AskOutputFormat::Bytes )
-            {
-                Frame frame;
-                frame.mType = FRAME_TYPE_VIEW_BYTES_EOC;
-                frame.mStartingSampleInclusive = eoc_starting_sample;
-                frame.mEndingSampleInclusive = eoc_ending_sample - 1;
-                mResults->AddFrame( frame );
-                mResults->CommitResults();
-                ReportProgress( frame.mEndingSampleInclusive );
-            }
-
-            // End of communication
-            break;
-        }
-        else
-        {
-            // If no eoc is detected, the last bit is valid.
-            bit_buffer.push_back( last_bit );
-        }
+        frameV2.AddByteArray( "uid", mCommandDecoder.GetUid(), mCommandDecoder.GetUidLength() );
     }
 
-    return ask_frame.error;
-}
-
-void Iso14443aAskAnalyzer::ReportAskFrame( AskFrame& ask_frame )
-{
-    FrameV2 frameV2;
+    if( has_block )
+    {
+        AddBlockFields( frameV2, block );
+    }
 
-    frameV2.AddByteArray( "value", ask_frame.data.data(), ask_frame.data.size() );
-    const char* status = "";
-    switch( ask_frame.error )
+    // the frames of a chain wait for their APDU
+    if( !mBlockDecoder.IsChaining() )
     {
-    case AskFrame::AskError::Ok:
-        status = "OK";
-        break;
-    case AskFrame::AskError::ErrorWrongSoc:
-        status = "SOC_ERROR";
-        break;
-    case AskFrame::AskError::ErrorWrongSequence:
-        status = "SEQUENCE_ERROR";
-        break;
-    case AskFrame::AskError::ErrorParity:
-        status = "PARITY_ERROR";
-        break;
-    };
-    frameV2.AddString( "status", status );
-    frameV2.AddInteger( "valid_bits_of_last_byte", ask_frame.data_valid_bits_in_last_byte );
-    mResults->AddFrameV2( frameV2, "ask_frame", ask_frame.frame_start_sample, ask_frame.frame_end_sample - 1 );
+        mFramesV2.Flush( *mResults );
+    }
 
     mResults->CommitResults();
-    ReportProgress( ask_frame.frame_end_sample );
+    ReportProgress( end_sample );
+    mCommitScheduler.Flush( end_sample );
 }
 
-void Iso14443aAskAnalyzer::ReceiveAskFrame()
+void Iso14443aAskAnalyzer::OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample )
 {
-    AskFrame ask_frame;
-    AskFrame::AskError ask_error;
+    Iso14443aFrameV2Queue::Record& frameV2 = mFramesV2.Insert( "apdu", start_sample, end_sample );
 
-    ask_error = ReceiveAskFrameStartOfCommunication( ask_frame );
-    if( ask_error == AskFrame::AskError::Ok )
-    {
-        ask_error = ReceiveAskFrameData( ask_frame );
-    }
-
-    ReportAskFrame( ask_frame );
+    frameV2.AddByteArray( "data", data, length );
+    frameV2.AddInteger( "blocks", block_count );
 }
 
 void Iso14443aAskAnalyzer::WorkerThread()
@@ -313,18 +174,55 @@ void Iso14443aAskAnalyzer::WorkerThread()
     mSampleRateHz = GetSampleRate();
 
     mAskSerial = GetAnalyzerChannelData( mSettings->mAskInputChannel );
-    mAskSamplesPerBit = double( mSampleRateHz ) * ( double( 128 ) / double( FREQ_CARRIER ) );
-    mAskOffsetToFrameStart = mAskSamplesPerBit / 6;
     mAskIdleState = mSettings->mAskIdleState;
     mAskOutputFormat = mSettings->mAskOutputFormat;
 
+    mAskEdgeSource.SetChannelData( mAskSerial );
+    mAskDecoder.Setup( mSampleRateHz, mSettings->mAskCarrierHz, mAskIdleState == BIT_HIGH ? Iso14443a::LINE_HIGH : Iso14443a::LINE_LOW,
+                       mSettings->mAskDecodingMode == AskDecodingMode::PauseEdges ? Iso14443a::AskSequenceDetection::PauseEdges
+                                                                                  : Iso14443a::AskSequenceDetection::SamplingPoints );
+    mAskDecoder.SetCarrierCalibration( mSettings->mAskCalibrationFrames );
+
+    mCommandDecoder.Reset();
+    mBlockDecoder.Reset();
+    mFramesV2.Clear();
+
+    // commit at least every 10 ms of signal
+    mCommitScheduler.Setup( mSampleRateHz / 100, COMMIT_MAX_PENDING_FRAMES );
+
+    switch( mSettings->mAskMarkerDetail )
+    {
+    case AskMarkerDetail::NoMarkers:
+        mAskDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::None );
+        break;
+    case AskMarkerDetail::ErrorMarkers:
+        mAskDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::Errors );
+        break;
+    case AskMarkerDetail::SequenceStartMarkers:
+        mAskDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::SequenceStarts );
+        break;
+    case AskMarkerDetail::SamplingPointMarkers:
+        mAskDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::SamplingPoints );
+        break;
+    }
+
+    if( mSettings->mAskBitRate == AskBitRate::BitRateDetect )
+    {
+        mAskDecoder.SetBitRateDetection( true );
+    }
+    else
+    {
+        // the fixed bit rates are listed in the same order as in the core
+        mAskDecoder.SetBitRateDetection( false );
+        mAskDecoder.SetBitRate( Iso14443a::BitRate( U32( mSettings->mAskBitRate ) ) );
+    }
+
     // Wait for idle state (eg. low)
-    if( mAskSerial->GetBitState() != mAskIdleState )
-        mAskSerial->AdvanceToNextEdge();
+    mAskDecoder.WaitForIdle();
 
     for( ;; )
     {
-        ReceiveAskFrame();
+        mAskDecoder.DecodeFrame();
     }
 }
 
@@ -338,7 +236,7 @@ U32 Iso14443aAskAnalyzer::GenerateSimulationData( U64 minimum_sample_index, U32
 {
     if( mSimulationInitilized == false )
     {
-        mSimulationDataGenerator.Initialize( GetSimulationSampleRate(), mSettings.get() );
+        mSimulationDataGenerator.Initialize( GetSimulationSampleRate(), mSettings->mAskCarrierHz, mSettings.get() );
         mSimulationInitilized = true;
     }
 
@@ -347,10 +245,15 @@ U32 Iso14443aAskAnalyzer::GenerateSimulationData( U64 minimum_sample_index, U32
 
 U32 Iso14443aAskAnalyzer::GetMinimumSampleRateHz()
 {
-    // Subcarrier = (13,56 MHz / 16) = ca. 848kHz
-    // Multiplikator = 4;
-    //   => 3,39 MHz
-    return ( FREQ_CARRIER * 4 ) / 16;
+    // The bit grid follows the pauses, at 106 kBit/s 16 samples per bit are enough:
+    //   13,56 MHz / 8 = ca. 1,7 MHz
+    // The pauses of the higher bit rates are only a few carrier periods long, they keep 4 samples per subcarrier period:
+    //   (13,56 MHz / 16) * 4 = ca. 3,39 MHz
+    if( mSettings->mAskBitRate == AskBitRate::BitRate106 )
+    {
+        return mSettings->mAskCarrierHz / 8;
+    }
+    return ( mSettings->mAskCarrierHz * 4 ) / 16;
 }
 
 const char* Iso14443aAskAnalyzer::GetAnalyzerName() const
@@ -5,10 +5,16 @@
 #include "Iso14443aAskAnalyzerResults.h"
 #include "Iso14443aAskAnalyzerSettings.h"
 #include "Iso14443aAskSimulationDataGenerator.h"
+#include "Iso14443aChannelEdgeSource.h"
+#include "Iso14443aAskDecoder.h"
+#include "Iso14443aCommitScheduler.h"
+#include "Iso14443aCommandDecoder.h"
+#include "Iso14443aBlockDecoder.h"
+#include "Iso14443aFrameV2Queue.h"
 
 
 class Iso14443aAskAnalyzerSettings;
-class ANALYZER_EXPORT Iso14443aAskAnalyzer : public Analyzer2
+class ANALYZER_EXPORT Iso14443aAskAnalyzer : public Analyzer2, public Iso14443a::DecoderSink, public Iso14443a::ApduSink
 {
   public:
     Iso14443aAskAnalyzer();
@@ -23,38 +29,30 @@ class ANALYZER_EXPORT Iso14443aAskAnalyzer : public Analyzer2
     virtual const char* GetAnalyzerName() const;
     virtual bool NeedsRerun();
 
-  protected: // vars
-    struct AskFrame
-    {
-        U64 frame_start_sample{ 0U }; // first sample of frame
-        U64 frame_end_sample{ 0U };   // last sample of frame
-
-        U64 frame_data_start_sample{ 0U }; // first sample of data bits
-
-        U32 seq_num{ 0U }; // sequence count of complete frame
-
-        std::vector<U8> data;                  // data of the frame
-        U8 data_valid_bits_in_last_byte{ 0U }; // the last data byte can be incomplete, so here are the valid bit count saved
-
-        enum class AskError
-        {
-            Ok = 0,
-            ErrorWrongSoc = 1,
-            ErrorWrongSequence = 2,
-            ErrorParity = 3,
-        };
-        AskError error{ AskError::Ok };
-    };
-
-    std::tuple<U8, U64> ReceiveAskSeq( AskFrame& ask_fram );
-    AskFrame::AskError ReceiveAskFrameStartOfCommunication( AskFrame& ask_frame );
-    AskFrame::AskError ReceiveAskFrameData( AskFrame& ask_frame );
-    void ReportAskFrame( AskFrame& ask_frame );
-    void ReceiveAskFrame();
+  protected: // decoder sink
+    virtual void OnMarker( U64 sample, Iso14443a::MarkerType type );
+    virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample );
+    virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample );
+    virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample );
+    virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample );
+    virtual void OnFrame( const Iso14443a::DecodedFrame& ask_frame, U64 start_sample, U64 end_sample );
+
+  protected: // apdu sink
+    virtual void OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample );
 
+  protected: // functions
+    void AddResultFrame( Frame& frame );
+
+  protected: // vars
     std::unique_ptr<Iso14443aAskAnalyzerSettings> mSettings;
     std::unique_ptr<Iso14443aAskAnalyzerResults> mResults;
     AnalyzerChannelData* mAskSerial;
+    Iso14443aChannelEdgeSource mAskEdgeSource;
+    Iso14443a::AskDecoder mAskDecoder;
+    Iso14443a::CommitScheduler mCommitScheduler;
+    Iso14443a::CommandDecoder mCommandDecoder;
+    Iso14443a::BlockDecoder mBlockDecoder;
+    Iso14443aFrameV2Queue mFramesV2;
 
     Iso14443aAskSimulationDataGenerator mSimulationDataGenerator;
     bool mSimulationInitilized;
@@ -62,8 +60,6 @@ class ANALYZER_EXPORT Iso14443aAskAnalyzer : public Analyzer2
     // Serial analysis vars:
     U32 mSampleRateHz;
 
-    double mAskSamplesPerBit;
-    double mAskOffsetToFrameStart;
     BitState mAskIdleState;
     AskOutputFormat mAskOutputFormat;
 
@@ -1,34 +1,16 @@
 #include "Iso14443aAskAnalyzerResults.h"
-#include <AnalyzerHelpers.h>
 #include "Iso14443aAskAnalyzer.h"
 #include "Iso14443aAskAnalyzerSettings.h"
-#include <iostream>
-#include <fstream>
-#include <stdio.h>
-#include <cstdarg>
-#include <string>
+#include "Iso14443aResultsExport.h"
 
-std::string format_string( char const* const format, ... )
-{
-    // see https://stackoverflow.com/a/52184144
-
-    // get length of output
-    va_list args;
-    va_start( args, format );
-    size_t len = std::vsnprintf( NULL, 0, format, args );
-    va_end( args );
-
-    // create vector and print the output to the vector
-    std::vector<char> vec( len + 1 );
-    va_start( args, format );
-    std::vsnprintf( &vec[ 0 ], len + 1, format, args );
-    va_end( args );
-
-    return std::string( &vec[ 0 ] );
-}
+// indexed by the sequence value, ASK_SEQ_Y = 0, ASK_SEQ_X = 1, ASK_SEQ_Z = 2
+static const char* const SEQUENCE_NAMES[] = { "Y", "X", "Z" };
 
 Iso14443aAskAnalyzerResults::Iso14443aAskAnalyzerResults( Iso14443aAskAnalyzer* analyzer, Iso14443aAskAnalyzerSettings* settings )
-    : AnalyzerResults(), mSettings( settings ), mAnalyzer( analyzer )
+    : AnalyzerResults(),
+      mSettings( settings ),
+      mAnalyzer( analyzer ),
+      mResultText( SEQUENCE_NAMES, sizeof( SEQUENCE_NAMES ) / sizeof( SEQUENCE_NAMES[ 0 ] ) )
 {
 }
 
@@ -42,93 +24,38 @@ void Iso14443aAskAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel&
     ClearResultStrings();
     Frame frame = GetFrame( frame_index );
 
-    if( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_BYTES_BYTE )
-    {
-        char number_str[ 128 ];
-        AnalyzerHelpers::GetNumberString( frame.mData1, display_base, U32( frame.mData2 ), number_str, 128 );
-
-        std::string hint_str = "";
-        if( frame.mData2 != 8 )
-        {
-            hint_str = format_string( " (%d Bits)", U8( frame.mData2 ) );
-        }
+    mResultText.AddBubbleText( *this, frame, display_base );
+}
 
-        std::string error_str = "";
-        if( frame.mFlags & FRAME_FLAG_PARITY_ERROR )
-        {
-            error_str = format_string( " (Parity Error)" );
-        }
-        AddResultString( number_str, hint_str.c_str(), error_str.c_str() );
-    }
-    else if( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_BYTES_SOC )
-    {
-        AddResultString( "SOC" );
-    }
-    else if( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_BYTES_EOC )
-    {
-        AddResultString( "EOC" );
-    }
-    else if( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE )
+void Iso14443aAskAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+{
+    Iso14443aResultsExport exporter( *this, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate(), false, false );
+    switch( export_type_user_id )
     {
-        switch( frame.mData1 )
-        {
-        case ASK_SEQ_X:
-            AddResultString( "X" );
+        case ExportSequences:
+            exporter.ExportSequences( file, SEQUENCE_NAMES, sizeof( SEQUENCE_NAMES ) / sizeof( SEQUENCE_NAMES[ 0 ] ) );
+            break;
+        case ExportBytes:
+            exporter.ExportBytes( file, display_base );
             break;
-        case ASK_SEQ_Y:
-            AddResultString( "Y" );
+        case ExportFrames:
+            exporter.ExportFrames( file );
             break;
-        case ASK_SEQ_Z:
-            AddResultString( "Z" );
+        case ExportPcapng:
+            exporter.ExportPcapng( file );
             break;
         default:
-            AddResultString( "ERROR" );
+            exporter.ExportValues( file, display_base, false );
             break;
-        }
     }
 }
 
-void Iso14443aAskAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
-{
-    std::ofstream file_stream( file, std::ios::out );
-
-    U64 trigger_sample = mAnalyzer->GetTriggerSample();
-    U32 sample_rate = mAnalyzer->GetSampleRate();
-
-    file_stream << "Time [s],Value" << std::endl;
-
-    U64 num_frames = GetNumFrames();
-    for( U32 i = 0; i < num_frames; i++ )
-    {
-        Frame frame = GetFrame( i );
-
-        char time_str[ 128 ];
-        AnalyzerHelpers::GetTimeString( frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128 );
-
-        char number_str[ 128 ];
-        AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
-
-        file_stream << time_str << "," << number_str << std::endl;
-
-        if( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true )
-        {
-            file_stream.close();
-            return;
-        }
-    }
-
-    file_stream.close();
-}
-
 void Iso14443aAskAnalyzerResults::GenerateFrameTabularText( U64 frame_index, DisplayBase display_base )
 {
 #ifdef SUPPORTS_PROTOCOL_SEARCH
     Frame frame = GetFrame( frame_index );
     ClearTabularText();
-
-    char number_str[ 128 ];
-    AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
-    AddTabularText( number_str );
+    mResultText.AddTabularText( *this, frame, display_base, "" );
 #endif
 }
 
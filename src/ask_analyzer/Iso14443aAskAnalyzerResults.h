@@ -2,21 +2,14 @@
 #define ISO14443A_ASK_ANALYZER_RESULTS
 
 #include <AnalyzerResults.h>
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aResultFrames.h"
+#include "Iso14443aResultText.h"
 
-static const U8 FRAME_TYPE_VIEW_MASK = 0b00000011;
-static const U8 FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE = 0b00000000;
-static const U8 FRAME_TYPE_VIEW_BYTES_BYTE = 0b00000001;
-static const U8 FRAME_TYPE_VIEW_BYTES_SOC = 0b00000010;
-static const U8 FRAME_TYPE_VIEW_BYTES_EOC = 0b00000011;
-
-static const U8 FRAME_FLAG_PARITY_ERROR = 1;
-
-static const U8 ASK_SEQ_X = 0b01;
-static const U8 ASK_SEQ_Y = 0b00;
-static const U8 ASK_SEQ_Z = 0b10;
-static const U8 ASK_SEQ_ERROR = 0b100;
-
-std::string format_string( char const* const format, ... );
+using Iso14443a::ASK_SEQ_X;
+using Iso14443a::ASK_SEQ_Y;
+using Iso14443a::ASK_SEQ_Z;
+using Iso14443a::ASK_SEQ_ERROR;
 
 class Iso14443aAskAnalyzer;
 class Iso14443aAskAnalyzerSettings;
@@ -38,6 +31,7 @@ class Iso14443aAskAnalyzerResults : public AnalyzerResults
   protected: // vars
     Iso14443aAskAnalyzerSettings* mSettings;
     Iso14443aAskAnalyzer* mAnalyzer;
+    Iso14443aResultText mResultText;
 };
 
 #endif // ISO14443A_ASK_ANALYZER_RESULTS
@@ -1,9 +1,17 @@
 #include "Iso14443aAskAnalyzerSettings.h"
 #include <AnalyzerHelpers.h>
+#include "Iso14443aDecoderTypes.h"
 
 
 Iso14443aAskAnalyzerSettings::Iso14443aAskAnalyzerSettings()
-    : mAskInputChannel( UNDEFINED_CHANNEL ), mAskIdleState( BIT_HIGH ), mAskOutputFormat( AskOutputFormat::Bytes )
+    : mAskInputChannel( UNDEFINED_CHANNEL ),
+      mAskIdleState( BIT_HIGH ),
+      mAskOutputFormat( AskOutputFormat::Bytes ),
+      mAskDecodingMode( AskDecodingMode::PauseEdges ),
+      mAskMarkerDetail( AskMarkerDetail::SamplingPointMarkers ),
+      mAskBitRate( AskBitRate::BitRate106 ),
+      mAskCarrierHz( Iso14443a::NOMINAL_CARRIER_HZ ),
+      mAskCalibrationFrames( 0 )
 {
     mAskInputChannelInterface.reset( new AnalyzerSettingInterfaceChannel() );
     mAskInputChannelInterface->SetTitleAndTooltip( "Channel", "" );
@@ -21,13 +29,63 @@ Iso14443aAskAnalyzerSettings::Iso14443aAskAnalyzerSettings()
     mAskOutputFormatInterface->AddNumber( AskOutputFormat::Bytes, "Bytes", "" );
     mAskOutputFormatInterface->SetNumber( mAskOutputFormat );
 
+    mAskDecodingModeInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mAskDecodingModeInterface->SetTitleAndTooltip( "Decoding", "" );
+    mAskDecodingModeInterface->AddNumber( AskDecodingMode::SamplingPoints, "Sampling Points", "" );
+    mAskDecodingModeInterface->AddNumber( AskDecodingMode::PauseEdges, "Pause Edges", "" );
+    mAskDecodingModeInterface->SetNumber( mAskDecodingMode );
+
+    mAskMarkerDetailInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mAskMarkerDetailInterface->SetTitleAndTooltip( "Markers", "" );
+    mAskMarkerDetailInterface->AddNumber( AskMarkerDetail::NoMarkers, "None", "" );
+    mAskMarkerDetailInterface->AddNumber( AskMarkerDetail::ErrorMarkers, "Errors Only", "" );
+    mAskMarkerDetailInterface->AddNumber( AskMarkerDetail::SequenceStartMarkers, "Sequence Starts", "" );
+    mAskMarkerDetailInterface->AddNumber( AskMarkerDetail::SamplingPointMarkers, "Sampling Points", "" );
+    mAskMarkerDetailInterface->SetNumber( mAskMarkerDetail );
+
+    mAskBitRateInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mAskBitRateInterface->SetTitleAndTooltip( "Bit Rate", "" );
+    mAskBitRateInterface->AddNumber( AskBitRate::BitRate106, "106 kBit/s (fc/128)", "" );
+    mAskBitRateInterface->AddNumber( AskBitRate::BitRate212, "212 kBit/s (fc/64)", "" );
+    mAskBitRateInterface->AddNumber( AskBitRate::BitRate424, "424 kBit/s (fc/32)", "" );
+    mAskBitRateInterface->AddNumber( AskBitRate::BitRate848, "848 kBit/s (fc/16)", "" );
+    mAskBitRateInterface->AddNumber( AskBitRate::BitRateDetect, "Detect per Frame", "" );
+    mAskBitRateInterface->SetNumber( mAskBitRate );
+
+    mAskCarrierHzInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mAskCarrierHzInterface->SetTitleAndTooltip( "Carrier (Hz)", "" );
+    mAskCarrierHzInterface->SetMin( Iso14443a::MIN_CARRIER_HZ );
+    mAskCarrierHzInterface->SetMax( Iso14443a::MAX_CARRIER_HZ );
+    mAskCarrierHzInterface->SetInteger( mAskCarrierHz );
+
+    mAskCalibrationFramesInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mAskCalibrationFramesInterface->SetTitleAndTooltip( "Carrier Calibration", "" );
+    mAskCalibrationFramesInterface->AddNumber( 0, "Off", "" );
+    mAskCalibrationFramesInterface->AddNumber( 8, "First 8 Frames", "" );
+    mAskCalibrationFramesInterface->AddNumber( 32, "First 32 Frames", "" );
+    mAskCalibrationFramesInterface->AddNumber( 128, "First 128 Frames", "" );
+    mAskCalibrationFramesInterface->SetNumber( mAskCalibrationFrames );
+
     AddInterface( mAskInputChannelInterface.get() );
     AddInterface( mAskIdleStateInterface.get() );
     AddInterface( mAskOutputFormatInterface.get() );
-
-    AddExportOption( 0, "Export as text/csv file" );
-    AddExportExtension( 0, "text", "txt" );
-    AddExportExtension( 0, "csv", "csv" );
+    AddInterface( mAskDecodingModeInterface.get() );
+    AddInterface( mAskMarkerDetailInterface.get() );
+    AddInterface( mAskBitRateInterface.get() );
+    AddInterface( mAskCarrierHzInterface.get() );
+    AddInterface( mAskCalibrationFramesInterface.get() );
+
+    AddExportOption( ExportText, "Export as text/csv file" );
+    AddExportExtension( ExportText, "text", "txt" );
+    AddExportExtension( ExportText, "csv", "csv" );
+    AddExportOption( ExportPcapng, "Export as pcapng file (Wireshark)" );
+    AddExportExtension( ExportPcapng, "pcapng", "pcapng" );
+    AddExportOption( ExportSequences, "Export sequences as text/csv file" );
+    AddExportExtension( ExportSequences, "csv", "csv" );
+    AddExportOption( ExportBytes, "Export bytes as text/csv file" );
+    AddExportExtension( ExportBytes, "csv", "csv" );
+    AddExportOption( ExportFrames, "Export frames as text/csv file" );
+    AddExportExtension( ExportFrames, "csv", "csv" );
 
     ClearChannels();
     AddChannel( mAskInputChannel, "ASK", false );
@@ -39,9 +97,20 @@ Iso14443aAskAnalyzerSettings::~Iso14443aAskAnalyzerSettings()
 
 bool Iso14443aAskAnalyzerSettings::SetSettingsFromInterfaces()
 {
+    if( !Iso14443a::IsValidCarrier( U32( mAskCarrierHzInterface->GetInteger() ) ) )
+    {
+        SetErrorText( "The carrier must be between 13 and 14 MHz." );
+        return false;
+    }
+
     mAskInputChannel = mAskInputChannelInterface->GetChannel();
     mAskIdleState = ( BitState )U32( mAskIdleStateInterface->GetNumber() );
     mAskOutputFormat = ( AskOutputFormat )U32( mAskOutputFormatInterface->GetNumber() );
+    mAskDecodingMode = ( AskDecodingMode )U32( mAskDecodingModeInterface->GetNumber() );
+    mAskMarkerDetail = ( AskMarkerDetail )U32( mAskMarkerDetailInterface->GetNumber() );
+    mAskBitRate = ( AskBitRate )U32( mAskBitRateInterface->GetNumber() );
+    mAskCarrierHz = U32( mAskCarrierHzInterface->GetInteger() );
+    mAskCalibrationFrames = U32( mAskCalibrationFramesInterface->GetNumber() );
 
     ClearChannels();
     AddChannel( mAskInputChannel, "ASK", true );
@@ -54,6 +123,11 @@ void Iso14443aAskAnalyzerSettings::UpdateInterfacesFromSettings()
     mAskInputChannelInterface->SetChannel( mAskInputChannel );
     mAskIdleStateInterface->SetNumber( mAskIdleState );
     mAskOutputFormatInterface->SetNumber( mAskOutputFormat );
+    mAskDecodingModeInterface->SetNumber( mAskDecodingMode );
+    mAskMarkerDetailInterface->SetNumber( mAskMarkerDetail );
+    mAskBitRateInterface->SetNumber( mAskBitRate );
+    mAskCarrierHzInterface->SetInteger( int( mAskCarrierHz ) );
+    mAskCalibrationFramesInterface->SetNumber( mAskCalibrationFrames );
 }
 
 void Iso14443aAskAnalyzerSettings::LoadSettings( const char* settings )
@@ -65,6 +139,28 @@ void Iso14443aAskAnalyzerSettings::LoadSettings( const char* settings )
     text_archive >> *( U32* )&mAskIdleState;
     text_archive >> *( U32* )&mAskOutputFormat;
 
+    // settings saved by older versions end here
+    if( !( text_archive >> *( U32* )&mAskDecodingMode ) )
+    {
+        mAskDecodingMode = AskDecodingMode::SamplingPoints;
+    }
+    if( !( text_archive >> *( U32* )&mAskMarkerDetail ) )
+    {
+        mAskMarkerDetail = AskMarkerDetail::SamplingPointMarkers;
+    }
+    if( !( text_archive >> *( U32* )&mAskBitRate ) )
+    {
+        mAskBitRate = AskBitRate::BitRate106;
+    }
+    if( !( text_archive >> mAskCarrierHz ) || !Iso14443a::IsValidCarrier( mAskCarrierHz ) )
+    {
+        mAskCarrierHz = Iso14443a::NOMINAL_CARRIER_HZ;
+    }
+    if( !( text_archive >> mAskCalibrationFrames ) )
+    {
+        mAskCalibrationFrames = 0;
+    }
+
     ClearChannels();
     AddChannel( mAskInputChannel, "ASK", true );
 
@@ -78,6 +174,11 @@ const char* Iso14443aAskAnalyzerSettings::SaveSettings()
     text_archive << mAskInputChannel;
     text_archive << mAskIdleState;
     text_archive << mAskOutputFormat;
+    text_archive << mAskDecodingMode;
+    text_archive << mAskMarkerDetail;
+    text_archive << mAskBitRate;
+    text_archive << mAskCarrierHz;
+    text_archive << mAskCalibrationFrames;
 
     return SetReturnString( text_archive.GetString() );
 }
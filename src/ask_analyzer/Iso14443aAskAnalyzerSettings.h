@@ -10,6 +10,38 @@ enum AskOutputFormat
     Bytes = 1,
 };
 
+enum AskDecodingMode
+{
+    SamplingPoints = 0,
+    PauseEdges = 1,
+};
+
+enum AskMarkerDetail
+{
+    NoMarkers = 0,
+    ErrorMarkers = 1,
+    SequenceStartMarkers = 2,
+    SamplingPointMarkers = 3,
+};
+
+enum AskBitRate
+{
+    BitRate106 = 0,
+    BitRate212 = 1,
+    BitRate424 = 2,
+    BitRate848 = 3,
+    BitRateDetect = 4,
+};
+
+enum AskExportType
+{
+    ExportText = 0,
+    ExportPcapng = 1,
+    ExportSequences = 2,
+    ExportBytes = 3,
+    ExportFrames = 4,
+};
+
 class Iso14443aAskAnalyzerSettings : public AnalyzerSettings
 {
   public:
@@ -25,11 +57,21 @@ class Iso14443aAskAnalyzerSettings : public AnalyzerSettings
     Channel mAskInputChannel;
     BitState mAskIdleState;
     AskOutputFormat mAskOutputFormat;
+    AskDecodingMode mAskDecodingMode;
+    AskMarkerDetail mAskMarkerDetail;
+    AskBitRate mAskBitRate;
+    U32 mAskCarrierHz;
+    U32 mAskCalibrationFrames;
 
   protected:
     std::unique_ptr<AnalyzerSettingInterfaceChannel> mAskInputChannelInterface;
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mAskIdleStateInterface;
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mAskOutputFormatInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mAskDecodingModeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mAskMarkerDetailInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mAskBitRateInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mAskCarrierHzInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mAskCalibrationFramesInterface;
 };
 
 #endif // ISO14443A_ASK_ANALYZER_SETTINGS
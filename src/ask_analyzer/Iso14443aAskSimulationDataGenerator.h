@@ -2,28 +2,26 @@
 #define ISO14443A_ASK_SIMULATION_DATA_GENERATOR
 
 #include <SimulationChannelDescriptor.h>
-#include <string>
+#include "Iso14443aSessionGenerator.h"
+#include "Iso14443aSimulationSink.h"
 class Iso14443aAskAnalyzerSettings;
 
 class Iso14443aAskSimulationDataGenerator
 {
-public:
-	Iso14443aAskSimulationDataGenerator();
-	~Iso14443aAskSimulationDataGenerator();
+  public:
+    Iso14443aAskSimulationDataGenerator();
+    ~Iso14443aAskSimulationDataGenerator();
 
-	void Initialize( U32 simulation_sample_rate, Iso14443aAskAnalyzerSettings* settings );
-	U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channel );
+    void Initialize( U32 simulation_sample_rate, U32 carrier_hz, Iso14443aAskAnalyzerSettings* settings );
+    U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channel );
 
-protected:
-	Iso14443aAskAnalyzerSettings* mSettings;
-	U32 mSimulationSampleRateHz;
-
-protected:
-	void CreateSerialByte();
-	std::string mSerialText;
-	U32 mStringIndex;
-
-	SimulationChannelDescriptor mSerialSimulationData;
+  protected:
+    Iso14443aAskAnalyzerSettings* mSettings;
+    U32 mSimulationSampleRateHz;
 
+    SimulationChannelDescriptor mSimulationData;
+    Iso14443aSimulationSink mSimulationSink;
+    Iso14443a::NullWaveformSink mNullSink;
+    Iso14443a::SessionGenerator mSessionGenerator;
 };
-#endif //ISO14443A_ASK_SIMULATION_DATA_GENERATOR
\ No newline at end of file
+#endif // ISO14443A_ASK_SIMULATION_DATA_GENERATOR
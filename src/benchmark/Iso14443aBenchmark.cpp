@@ -0,0 +1,652 @@
+#include "Iso14443aAskDecoder.h"
+#include "Iso14443aLoadmodDecoder.h"
+#include "Iso14443aReplayEdgeSource.h"
+#include "Iso14443aSessionGenerator.h"
+#include "Iso14443aBitAccumulator.h"
+#include "Iso14443aCommandDecoder.h"
+#include "Iso14443aBlockDecoder.h"
+#include "Iso14443aCrc.h"
+#include "Iso14443aSegmentedDecoder.h"
+#include "Iso14443aSequenceTables.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Iso14443a;
+
+// GetMinimumSampleRateHz() of the LOADMOD analyzer: 3 samples per subcarrier period
+static const U32 MIN_SAMPLE_RATE_HZ = ( NOMINAL_CARRIER_HZ * 3 ) / 16;
+
+// the byte and frame stages repeat their input until they ran at least this long
+static const double MIN_STAGE_SECONDS = 0.2;
+
+// Collects the edges of one generated line.
+class EdgeVectorSink : public WaveformSink
+{
+  public:
+    virtual void OnEdge( U64 sample )
+    {
+        mEdges.push_back( sample );
+    }
+
+    std::vector<U64> mEdges;
+};
+
+// Only counts, so the measurement is the decoder and not the result handling.
+class CountingSink : public DecoderSink
+{
+  public:
+    virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+    {
+        mSequences++;
+    }
+    virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+    {
+        mBytes++;
+    }
+    virtual void OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample )
+    {
+        mFrames++;
+        if( frame.error != DecodedFrame::Error::Ok )
+        {
+            mErrorFrames++;
+        }
+    }
+
+    U64 mSequences{ 0U };
+    U64 mBytes{ 0U };
+    U64 mFrames{ 0U };
+    U64 mErrorFrames{ 0U };
+};
+
+class CountingApduSink : public ApduSink
+{
+  public:
+    virtual void OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample )
+    {
+        mApdus++;
+    }
+
+    U64 mApdus{ 0U };
+};
+
+struct StageResult
+{
+    StageResult( const char* stage_name, const std::string& variant_name, U32 rate_hz )
+        : stage( stage_name ), variant( variant_name ), sample_rate_hz( rate_hz )
+    {
+    }
+
+    const char* stage;
+    std::string variant;
+    U32 sample_rate_hz;
+    U64 edges{ 0U };
+    U64 frames{ 0U };
+    U64 bytes{ 0U };
+    U64 error_frames{ 0U };
+    double seconds{ 0.0 };
+    double capture_seconds{ 0.0 }; // traffic in the generated edges
+};
+
+static void PrintHeader()
+{
+    printf( "stage,variant,sample_rate_hz,edges,frames,bytes,error_frames,seconds,edges_per_s,bytes_per_s,realtime\n" );
+}
+
+static void PrintResult( const StageResult& result )
+{
+    double seconds = result.seconds > 0.0 ? result.seconds : 1e-9;
+    printf( "%s,%s,%u,%llu,%llu,%llu,%llu,%.6f,%.0f,%.0f,%.1f\n", result.stage, result.variant.c_str(), result.sample_rate_hz, result.edges,
+            result.frames, result.bytes, result.error_frames, result.seconds, result.edges / seconds, result.bytes / seconds,
+            result.capture_seconds / seconds );
+    fflush( stdout );
+}
+
+static double GetSecondsSince( std::chrono::steady_clock::time_point start_time )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+}
+
+// Sequence classification, byte assembly and frame checks of the ASK decoder, best of repeat runs.
+static StageResult RunAskStage( const std::vector<U64>& edges, U32 sample_rate_hz, AskSequenceDetection detection, U32 repeat )
+{
+    StageResult result( "ask", detection == AskSequenceDetection::PauseEdges ? "pause_edges" : "sampling_points", sample_rate_hz );
+    result.edges = edges.size();
+    result.capture_seconds = edges.empty() ? 0.0 : double( edges.back() ) / sample_rate_hz;
+    for( U32 pass = 0; pass < repeat; pass++ )
+    {
+        CountingSink sink;
+        ReplayEdgeSource source( edges.data(), edges.size(), LINE_HIGH );
+        AskDecoder decoder( source, sink );
+        decoder.Setup( sample_rate_hz, NOMINAL_CARRIER_HZ, LINE_HIGH, detection );
+        decoder.SetMarkerDetail( MarkerDetail::None );
+
+        auto start_time = std::chrono::steady_clock::now();
+        decoder.WaitForIdle();
+        while( decoder.DecodeFrame() )
+        {
+        }
+        double seconds = GetSecondsSince( start_time );
+
+        if( ( pass == 0 ) || ( seconds < result.seconds ) )
+        {
+            result.seconds = seconds;
+        }
+        result.frames = sink.mFrames;
+        result.bytes = sink.mBytes;
+        result.error_frames = sink.mErrorFrames;
+    }
+    return result;
+}
+
+static const char* GetLoadmodVariant( LoadmodSequenceDetection detection )
+{
+    switch( detection )
+    {
+    case LoadmodSequenceDetection::SubcarrierEdges:
+        return "subcarrier_edges";
+    case LoadmodSequenceDetection::Envelope:
+        return "envelope";
+    default:
+        return "sampling_points";
+    }
+}
+
+// Subcarrier detection, byte assembly and frame checks of the LOADMOD decoder, best of repeat runs.
+static StageResult RunLoadmodStage( const std::vector<U64>& edges, U32 sample_rate_hz, LoadmodSequenceDetection detection, U32 repeat )
+{
+    StageResult result( "loadmod", GetLoadmodVariant( detection ), sample_rate_hz );
+    result.edges = edges.size();
+    result.capture_seconds = edges.empty() ? 0.0 : double( edges.back() ) / sample_rate_hz;
+    for( U32 pass = 0; pass < repeat; pass++ )
+    {
+        CountingSink sink;
+        ReplayEdgeSource source( edges.data(), edges.size(), LINE_LOW );
+        LoadmodDecoder decoder( source, sink );
+        decoder.Setup( sample_rate_hz, NOMINAL_CARRIER_HZ, LINE_LOW, detection );
+        decoder.SetMarkerDetail( MarkerDetail::None );
+
+        auto start_time = std::chrono::steady_clock::now();
+        decoder.WaitForIdle();
+        while( decoder.DecodeFrame() )
+        {
+        }
+        double seconds = GetSecondsSince( start_time );
+
+        if( ( pass == 0 ) || ( seconds < result.seconds ) )
+        {
+            result.seconds = seconds;
+        }
+        result.frames = sink.mFrames;
+        result.bytes = sink.mBytes;
+        result.error_frames = sink.mErrorFrames;
+    }
+    return result;
+}
+
+// Both decoders on segments between idle gaps on thread_count threads, merged in order into one sink, best of repeat runs.
+static StageResult RunSegmentedStage( const std::vector<U64>& edges, U32 sample_rate_hz, bool is_ask, U32 thread_count, U32 repeat )
+{
+    StageResult result( is_ask ? "ask_segmented" : "loadmod_segmented", "threads_" + std::to_string( thread_count ), sample_rate_hz );
+    result.edges = edges.size();
+    result.capture_seconds = edges.empty() ? 0.0 : double( edges.back() ) / sample_rate_hz;
+
+    LineState idle_state = is_ask ? LINE_HIGH : LINE_LOW;
+    SegmentedDecoder::SegmentDecodeFunction decode = [&]( EdgeSource& source, DecoderSink& sink ) {
+        if( is_ask )
+        {
+            AskDecoder decoder( source, sink );
+            decoder.Setup( sample_rate_hz, NOMINAL_CARRIER_HZ, idle_state, AskSequenceDetection::SamplingPoints );
+            decoder.SetMarkerDetail( MarkerDetail::None );
+            decoder.WaitForIdle();
+            while( decoder.DecodeFrame() )
+            {
+            }
+        }
+        else
+        {
+            LoadmodDecoder decoder( source, sink );
+            decoder.Setup( sample_rate_hz, NOMINAL_CARRIER_HZ, idle_state, LoadmodSequenceDetection::SamplingPoints );
+            decoder.SetMarkerDetail( MarkerDetail::None );
+            decoder.WaitForIdle();
+            while( decoder.DecodeFrame() )
+            {
+            }
+        }
+    };
+
+    for( U32 pass = 0; pass < repeat; pass++ )
+    {
+        CountingSink sink;
+        SegmentedDecoder decoder( thread_count );
+        decoder.Setup( GetMinFrameDelaySamples( sample_rate_hz, NOMINAL_CARRIER_HZ ), idle_state );
+
+        auto start_time = std::chrono::steady_clock::now();
+        decoder.Decode( edges.data(), edges.size(), idle_state, decode, sink );
+        double seconds = GetSecondsSince( start_time );
+
+        if( ( pass == 0 ) || ( seconds < result.seconds ) )
+        {
+            result.seconds = seconds;
+        }
+        result.frames = sink.mFrames;
+        result.bytes = sink.mBytes;
+        result.error_frames = sink.mErrorFrames;
+    }
+    return result;
+}
+
+// Assembles the bytes of the frames bit by bit with their parity, like the decoders do after the sequence classification.
+static StageResult RunByteStage( const std::vector<ScriptFrame>& frames )
+{
+    StageResult result( "bytes", "bit_accumulator", 0 );
+    BitAccumulator accumulator;
+    DecodedFrame frame;
+    auto start_time = std::chrono::steady_clock::now();
+    do
+    {
+        for( const ScriptFrame& script_frame : frames )
+        {
+            if( script_frame.idle_us != 0 )
+            {
+                continue;
+            }
+
+            frame.Reset();
+            for( U8 byte : script_frame.data )
+            {
+                accumulator.Clear();
+                for( U32 bit = 0; bit < 8; bit++ )
+                {
+                    accumulator.PushBit( U8( byte >> bit ), result.bytes );
+                }
+                accumulator.PushBit( HasOddOnesCount( byte ) ? 0 : 1, result.bytes );
+
+                // odd parity over the data bits and the parity bit
+                if( accumulator.IsFull() && ( HasOddOnesCount( accumulator.GetDataByte() ) == ( accumulator.GetParityBit() != 0 ) ) )
+                {
+                    frame.error = DecodedFrame::Error::ErrorParity;
+                }
+                frame.data.push_back( accumulator.GetDataByte() );
+                result.bytes++;
+            }
+            result.frames++;
+            if( frame.error != DecodedFrame::Error::Ok )
+            {
+                result.error_frames++;
+            }
+        }
+        result.seconds = GetSecondsSince( start_time );
+    } while( result.seconds < MIN_STAGE_SECONDS );
+    return result;
+}
+
+// The sequence classification and parity check as they were before the lookup tables, for comparison.
+static U8 ClassifyAskSequenceBranches( U8 last_bit, U8 seq )
+{
+    if( seq == ASK_SEQ_X )
+    {
+        return SEQ_RESULT_BIT_1;
+    }
+    else if( ( ( last_bit == 0 ) && ( seq == ASK_SEQ_Z ) ) || ( ( last_bit == 1 ) && ( seq == ASK_SEQ_Y ) ) )
+    {
+        return SEQ_RESULT_BIT_0;
+    }
+    else if( ( last_bit == 0 ) && ( seq == ASK_SEQ_Y ) )
+    {
+        return SEQ_RESULT_EOC;
+    }
+    return SEQ_RESULT_ERROR;
+}
+
+static U8 ClassifyLoadmodSequenceBranches( U8 seq )
+{
+    if( seq == LOADMOD_SEQ_D )
+    {
+        return SEQ_RESULT_BIT_1;
+    }
+    else if( seq == LOADMOD_SEQ_E )
+    {
+        return SEQ_RESULT_BIT_0;
+    }
+    else if( seq == LOADMOD_SEQ_F )
+    {
+        return SEQ_RESULT_EOC;
+    }
+    return SEQ_RESULT_ERROR;
+}
+
+static bool HasOddOnesCountFold( U8 byte )
+{
+    byte ^= byte >> 4;
+    byte ^= byte >> 2;
+    byte ^= byte >> 1;
+    return ( byte & 1 ) != 0;
+}
+
+// The sequences of the frames as the decoders receive them after the start of communication: 8 data bits and the parity bit
+// per byte, then the end of communication.
+static void EncodeSequences( const std::vector<ScriptFrame>& frames, bool is_ask, std::vector<U8>& sequences )
+{
+    for( const ScriptFrame& script_frame : frames )
+    {
+        if( script_frame.idle_us != 0 )
+        {
+            continue;
+        }
+
+        U8 last_bit = 0;
+        auto add_bit = [&]( U8 bit ) {
+            if( is_ask )
+            {
+                sequences.push_back( bit ? ASK_SEQ_X : ( last_bit ? ASK_SEQ_Y : ASK_SEQ_Z ) );
+            }
+            else
+            {
+                sequences.push_back( bit ? LOADMOD_SEQ_D : LOADMOD_SEQ_E );
+            }
+            last_bit = bit;
+        };
+        for( U8 byte : script_frame.data )
+        {
+            for( U32 bit = 0; bit < 8; bit++ )
+            {
+                add_bit( ( byte >> bit ) & 1 );
+            }
+            add_bit( HasOddOnesCountFold( byte ) ? 0 : 1 );
+        }
+        if( is_ask )
+        {
+            // logic "0" followed by Y
+            add_bit( 0 );
+            sequences.push_back( ASK_SEQ_Y );
+        }
+        else
+        {
+            sequences.push_back( LOADMOD_SEQ_F );
+        }
+    }
+}
+
+// Classifies sequences into bits and assembles the bytes with their parity, like ReceiveData() of the decoders. The branches
+// variant uses the compare chains and the parity fold, the table variant the lookups of Iso14443aSequenceTables.h.
+template <bool USE_TABLES>
+static StageResult RunSequenceStage( const std::vector<ScriptFrame>& frames, bool is_ask )
+{
+    StageResult result( is_ask ? "ask_sequences" : "loadmod_sequences", USE_TABLES ? "table" : "branches", 0 );
+    std::vector<U8> sequences;
+    EncodeSequences( frames, is_ask, sequences );
+
+    BitAccumulator accumulator;
+    DecodedFrame frame;
+    auto start_time = std::chrono::steady_clock::now();
+    do
+    {
+        U8 last_bit = 0;
+        frame.Reset();
+        accumulator.Clear();
+        for( size_t i = 0; i < sequences.size(); i++ )
+        {
+            U8 seq_result;
+            if( is_ask )
+            {
+                seq_result = USE_TABLES ? LookupAskSequence( last_bit, sequences[ i ] )
+                                        : ClassifyAskSequenceBranches( last_bit, sequences[ i ] );
+            }
+            else
+            {
+                seq_result = USE_TABLES ? LookupLoadmodSequence( sequences[ i ] ) : ClassifyLoadmodSequenceBranches( sequences[ i ] );
+            }
+
+            if( seq_result <= SEQ_RESULT_BIT_1 )
+            {
+                last_bit = seq_result;
+                accumulator.PushBit( seq_result, i );
+            }
+            else
+            {
+                if( seq_result == SEQ_RESULT_EOC )
+                {
+                    accumulator.DropLastBit();
+                }
+                else
+                {
+                    frame.error = DecodedFrame::Error::ErrorWrongSequence;
+                }
+                if( frame.error != DecodedFrame::Error::Ok )
+                {
+                    result.error_frames++;
+                }
+                result.frames++;
+                last_bit = 0;
+                frame.Reset();
+                accumulator.Clear();
+                continue;
+            }
+
+            if( accumulator.IsFull() )
+            {
+                U8 byte = accumulator.GetDataByte();
+                bool odd_ones_count = USE_TABLES ? HasOddOnesCount( byte ) : HasOddOnesCountFold( byte );
+                if( odd_ones_count == ( accumulator.GetParityBit() != 0 ) )
+                {
+                    frame.error = DecodedFrame::Error::ErrorParity;
+                }
+                frame.data.push_back( byte );
+                result.bytes++;
+                accumulator.Clear();
+            }
+        }
+        result.seconds = GetSecondsSince( start_time );
+    } while( result.seconds < MIN_STAGE_SECONDS );
+    return result;
+}
+
+// What the analyzers do with every decoded frame: CRC_A check, ISO14443-3 command and ISO14443-4 block decoding.
+static StageResult RunFrameStage( const std::vector<ScriptFrame>& frames )
+{
+    StageResult result( "frames", "crc_command_block", 0 );
+
+    std::vector<DecodedFrame> decoded_frames;
+    for( const ScriptFrame& script_frame : frames )
+    {
+        if( script_frame.idle_us == 0 )
+        {
+            DecodedFrame frame;
+            frame.data = script_frame.data;
+            frame.data_valid_bits_in_last_byte = script_frame.valid_bits_in_last_byte;
+            decoded_frames.push_back( frame );
+        }
+    }
+
+    CountingApduSink apdu_sink;
+    CommandDecoder command_decoder;
+    BlockDecoder block_decoder( apdu_sink );
+    BlockInfo info;
+    size_t frame_index = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    do
+    {
+        for( const ScriptFrame& script_frame : frames )
+        {
+            if( script_frame.idle_us != 0 )
+            {
+                continue;
+            }
+
+            DecodedFrame& frame = decoded_frames[ frame_index++ % decoded_frames.size() ];
+            CheckCrcA( frame, script_frame.is_response && command_decoder.IsUidResponseExpected() );
+            if( frame.crc == DecodedFrame::CrcStatus::Wrong )
+            {
+                result.error_frames++;
+            }
+            if( script_frame.is_response )
+            {
+                command_decoder.DecodeResponse( frame );
+            }
+            else
+            {
+                command_decoder.DecodeCommand( frame );
+            }
+            block_decoder.DecodeBlock( frame, script_frame.is_response, 0, 0, info );
+            result.frames++;
+            result.bytes += frame.data.size();
+        }
+        result.seconds = GetSecondsSince( start_time );
+    } while( result.seconds < MIN_STAGE_SECONDS );
+    return result;
+}
+
+static void PrintUsage()
+{
+    fprintf( stderr, "usage: Iso14443aBenchmark [options]\n"
+                     "  --sample-rates <hz,...>   sample rates of the decoder stages (default: %u,12500000,50000000,100000000,500000000)\n"
+                     "  --duration <s>            generated traffic per sample rate (default: 10)\n"
+                     "  --repeat <n>              decoder runs per stage, the fastest one is reported (default: 3)\n"
+                     "  --stage ask|loadmod|segmented|sequences|bytes|frames   run only this stage\n"
+                     "  --threads <n>             segmented: up to n threads, doubled from 1 (default: all cores, %u)\n"
+                     "prints one csv row per stage and sample rate to stdout, segmented runs at the highest sample rate only\n",
+             MIN_SAMPLE_RATE_HZ, std::max( std::thread::hardware_concurrency(), 1U ) );
+}
+
+int main( int argc, char* argv[] )
+{
+    std::vector<U32> sample_rates = { MIN_SAMPLE_RATE_HZ, 12500000, 50000000, 100000000, 500000000 };
+    double duration_s = 10.0;
+    U32 repeat = 3;
+    U32 max_threads = std::max( std::thread::hardware_concurrency(), 1U );
+    const char* only_stage = nullptr;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "--sample-rates" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            sample_rates.clear();
+            const char* text = argv[ ++i ];
+            while( *text != '\0' )
+            {
+                char* end = nullptr;
+                U32 sample_rate_hz = U32( strtoul( text, &end, 10 ) );
+                if( ( end == text ) || ( sample_rate_hz == 0 ) )
+                {
+                    PrintUsage();
+                    return 1;
+                }
+                sample_rates.push_back( sample_rate_hz );
+                text = *end == ',' ? end + 1 : end;
+            }
+        }
+        else if( ( strcmp( argv[ i ], "--duration" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            duration_s = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--repeat" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            repeat = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--threads" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            max_threads = std::max( U32( strtoul( argv[ ++i ], nullptr, 10 ) ), 1U );
+        }
+        else if( ( strcmp( argv[ i ], "--stage" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            only_stage = argv[ ++i ];
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if( repeat == 0 )
+    {
+        repeat = 1;
+    }
+
+    std::vector<ScriptFrame> frames;
+    std::string error;
+    ParseFrameScript( GetDefaultFrameScript(), frames, error );
+
+    PrintHeader();
+    bool run_ask = ( only_stage == nullptr ) || ( strcmp( only_stage, "ask" ) == 0 );
+    bool run_loadmod = ( only_stage == nullptr ) || ( strcmp( only_stage, "loadmod" ) == 0 );
+    bool run_segmented = ( only_stage == nullptr ) || ( strcmp( only_stage, "segmented" ) == 0 );
+    U32 max_sample_rate_hz = *std::max_element( sample_rates.begin(), sample_rates.end() );
+    if( run_ask || run_loadmod || run_segmented )
+    {
+        for( U32 sample_rate_hz : sample_rates )
+        {
+            if( !run_ask && !run_loadmod && ( sample_rate_hz != max_sample_rate_hz ) )
+            {
+                continue;
+            }
+
+            EdgeVectorSink pcd_edges;
+            EdgeVectorSink picc_edges;
+            SessionGenerator generator( pcd_edges, picc_edges );
+            generator.Setup( sample_rate_hz, NOMINAL_CARRIER_HZ, frames );
+            U64 end_sample = U64( duration_s * sample_rate_hz );
+            while( generator.GetPosition() < end_sample )
+            {
+                generator.AddNextFrame();
+            }
+
+            if( run_ask )
+            {
+                PrintResult( RunAskStage( pcd_edges.mEdges, sample_rate_hz, AskSequenceDetection::SamplingPoints, repeat ) );
+                PrintResult( RunAskStage( pcd_edges.mEdges, sample_rate_hz, AskSequenceDetection::PauseEdges, repeat ) );
+            }
+            if( run_loadmod )
+            {
+                PrintResult( RunLoadmodStage( picc_edges.mEdges, sample_rate_hz, LoadmodSequenceDetection::SamplingPoints, repeat ) );
+                PrintResult( RunLoadmodStage( picc_edges.mEdges, sample_rate_hz, LoadmodSequenceDetection::SubcarrierEdges, repeat ) );
+
+                // the same session as demodulated envelope
+                NullWaveformSink null_sink;
+                EdgeVectorSink envelope_edges;
+                SessionGenerator envelope_generator( null_sink, envelope_edges );
+                envelope_generator.Setup( sample_rate_hz, NOMINAL_CARRIER_HZ, frames );
+                envelope_generator.SetPiccEnvelope( true );
+                while( envelope_generator.GetPosition() < end_sample )
+                {
+                    envelope_generator.AddNextFrame();
+                }
+                PrintResult( RunLoadmodStage( envelope_edges.mEdges, sample_rate_hz, LoadmodSequenceDetection::Envelope, repeat ) );
+            }
+            if( run_segmented && ( sample_rate_hz == max_sample_rate_hz ) )
+            {
+                // scaling from one thread up to all of them
+                for( U32 thread_count = 1;; thread_count = std::min( thread_count * 2, max_threads ) )
+                {
+                    PrintResult( RunSegmentedStage( pcd_edges.mEdges, sample_rate_hz, true, thread_count, repeat ) );
+                    PrintResult( RunSegmentedStage( picc_edges.mEdges, sample_rate_hz, false, thread_count, repeat ) );
+                    if( thread_count == max_threads )
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    if( ( only_stage == nullptr ) || ( strcmp( only_stage, "sequences" ) == 0 ) )
+    {
+        PrintResult( RunSequenceStage<false>( frames, true ) );
+        PrintResult( RunSequenceStage<true>( frames, true ) );
+        PrintResult( RunSequenceStage<false>( frames, false ) );
+        PrintResult( RunSequenceStage<true>( frames, false ) );
+    }
+    if( ( only_stage == nullptr ) || ( strcmp( only_stage, "bytes" ) == 0 ) )
+    {
+        PrintResult( RunByteStage( frames ) );
+    }
+    if( ( only_stage == nullptr ) || ( strcmp( only_stage, "frames" ) == 0 ) )
+    {
+        PrintResult( RunFrameStage( frames ) );
+    }
+
+    return 0;
+}
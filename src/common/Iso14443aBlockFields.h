@@ -0,0 +1,36 @@
+#ifndef ISO14443A_BLOCK_FIELDS
+#define ISO14443A_BLOCK_FIELDS
+
+#include <AnalyzerResults.h>
+#include "Iso14443aBlockDecoder.h"
+
+// Adds the fields of an ISO14443-4 block to the FrameV2 of its frame (or its queued record), the fields a block type does not have
+// are left out.
+template <typename FrameV2Fields>
+inline void AddBlockFields( FrameV2Fields& frame_v2, const Iso14443a::BlockInfo& block )
+{
+    frame_v2.AddString( "block", Iso14443a::GetBlockTypeString( block.type ) );
+    if( ( block.type == Iso14443a::BlockType::I ) || ( block.type == Iso14443a::BlockType::RAck ) ||
+        ( block.type == Iso14443a::BlockType::RNak ) )
+    {
+        frame_v2.AddInteger( "block_number", block.block_number );
+    }
+    if( block.type == Iso14443a::BlockType::I )
+    {
+        frame_v2.AddBoolean( "chaining", block.chaining );
+    }
+    if( block.has_cid )
+    {
+        frame_v2.AddInteger( "cid", block.cid );
+    }
+    if( block.has_nad )
+    {
+        frame_v2.AddInteger( "nad", block.nad );
+    }
+    if( block.type == Iso14443a::BlockType::SWtx )
+    {
+        frame_v2.AddInteger( "wtxm", block.wtxm );
+    }
+}
+
+#endif // ISO14443A_BLOCK_FIELDS
@@ -0,0 +1,64 @@
+#ifndef ISO14443A_CHANNEL_EDGE_SOURCE
+#define ISO14443A_CHANNEL_EDGE_SOURCE
+
+#include <AnalyzerChannelData.h>
+#include "Iso14443aEdgeSource.h"
+
+// Hands an AnalyzerChannelData to the decoding core.
+class Iso14443aChannelEdgeSource : public Iso14443a::EdgeSource
+{
+  public:
+    Iso14443aChannelEdgeSource() : mChannelData( nullptr )
+    {
+    }
+
+    void SetChannelData( AnalyzerChannelData* channel_data )
+    {
+        mChannelData = channel_data;
+    }
+
+    virtual Iso14443a::U64 GetSampleNumber()
+    {
+        return mChannelData->GetSampleNumber();
+    }
+
+    virtual Iso14443a::LineState GetBitState()
+    {
+        return mChannelData->GetBitState() == BIT_HIGH ? Iso14443a::LINE_HIGH : Iso14443a::LINE_LOW;
+    }
+
+    virtual Iso14443a::U32 AdvanceToAbsPosition( Iso14443a::U64 sample_number )
+    {
+        return mChannelData->AdvanceToAbsPosition( sample_number );
+    }
+
+    virtual void AdvanceToNextEdge()
+    {
+        mChannelData->AdvanceToNextEdge();
+    }
+
+    virtual Iso14443a::U64 GetSampleOfNextEdge()
+    {
+        return mChannelData->GetSampleOfNextEdge();
+    }
+
+    virtual bool WouldAdvancingToAbsPositionCauseTransition( Iso14443a::U64 sample_number )
+    {
+        return mChannelData->WouldAdvancingToAbsPositionCauseTransition( sample_number );
+    }
+
+    virtual bool IsEndOfStream()
+    {
+        return false;
+    }
+
+    virtual bool HasEdgesLeft()
+    {
+        return true;
+    }
+
+  protected:
+    AnalyzerChannelData* mChannelData;
+};
+
+#endif // ISO14443A_CHANNEL_EDGE_SOURCE
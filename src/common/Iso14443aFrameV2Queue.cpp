@@ -0,0 +1,98 @@
+#include "Iso14443aFrameV2Queue.h"
+#include <algorithm>
+
+void Iso14443aFrameV2Queue::Record::AddString( const char* key, const char* value )
+{
+    mFields.push_back( Field{ key, FieldType::String, value, 0, 0 } );
+}
+
+void Iso14443aFrameV2Queue::Record::AddInteger( const char* key, S64 value )
+{
+    mFields.push_back( Field{ key, FieldType::Integer, nullptr, value, 0 } );
+}
+
+void Iso14443aFrameV2Queue::Record::AddBoolean( const char* key, bool value )
+{
+    mFields.push_back( Field{ key, FieldType::Boolean, nullptr, value ? 1 : 0, 0 } );
+}
+
+void Iso14443aFrameV2Queue::Record::AddByteArray( const char* key, const U8* data, U64 length )
+{
+    mFields.push_back( Field{ key, FieldType::ByteArray, nullptr, S64( mData.size() ), size_t( length ) } );
+    mData.insert( mData.end(), data, data + length );
+}
+
+void Iso14443aFrameV2Queue::Record::Reset( const char* type, U64 start_sample, U64 end_sample )
+{
+    mType = type;
+    mStartSample = start_sample;
+    mEndSample = end_sample;
+    mFields.clear();
+    mData.clear();
+}
+
+void Iso14443aFrameV2Queue::Record::AddTo( FrameV2& frame_v2 ) const
+{
+    for( const Field& field : mFields )
+    {
+        switch( field.type )
+        {
+        case FieldType::String:
+            frame_v2.AddString( field.key, field.string );
+            break;
+        case FieldType::Integer:
+            frame_v2.AddInteger( field.key, field.integer );
+            break;
+        case FieldType::Boolean:
+            frame_v2.AddBoolean( field.key, field.integer != 0 );
+            break;
+        case FieldType::ByteArray:
+            frame_v2.AddByteArray( field.key, mData.data() + field.integer, field.length );
+            break;
+        }
+    }
+}
+
+Iso14443aFrameV2Queue::Iso14443aFrameV2Queue() : mCount( 0 )
+{
+}
+
+void Iso14443aFrameV2Queue::Clear()
+{
+    mCount = 0;
+}
+
+Iso14443aFrameV2Queue::Record& Iso14443aFrameV2Queue::Add( const char* type, U64 start_sample, U64 end_sample )
+{
+    if( mCount == mRecords.size() )
+    {
+        mRecords.emplace_back();
+    }
+    Record& record = mRecords[ mCount++ ];
+    record.Reset( type, start_sample, end_sample );
+    return record;
+}
+
+Iso14443aFrameV2Queue::Record& Iso14443aFrameV2Queue::Insert( const char* type, U64 start_sample, U64 end_sample )
+{
+    Add( type, start_sample, end_sample );
+
+    // the records are swapped into place, so they keep their memory
+    std::vector<Record>::iterator end = mRecords.begin() + mCount;
+    std::vector<Record>::iterator position =
+        std::find_if( mRecords.begin(), end - 1, [start_sample]( const Record& record ) { return record.mStartSample >= start_sample; } );
+    std::rotate( position, end - 1, end );
+    return *position;
+}
+
+void Iso14443aFrameV2Queue::Flush( AnalyzerResults& results )
+{
+    for( size_t i = 0; i < mCount; i++ )
+    {
+        const Record& record = mRecords[ i ];
+        FrameV2 frame_v2;
+        record.AddTo( frame_v2 );
+        results.AddFrameV2( frame_v2, record.mType, record.mStartSample, record.mEndSample );
+    }
+    mCount = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef ISO14443A_FRAME_V2_QUEUE
+#define ISO14443A_FRAME_V2_QUEUE
+
+#include <AnalyzerResults.h>
+#include <vector>
+
+// Holds FrameV2s back until the ones that span them are known, e.g. the FrameV2s of chained ISO14443-4 blocks until their APDU
+// is complete, and adds them in the order of their start. A FrameV2 can not be copied, so the queue keeps its fields and only
+// builds the FrameV2 when it is added. The records keep their memory, once the queue held its longest run it does not allocate.
+class Iso14443aFrameV2Queue
+{
+  public:
+    // Fields of a queued FrameV2. The keys and the string values must outlive the queue (e.g. string literals).
+    class Record
+    {
+      public:
+        void AddString( const char* key, const char* value );
+        void AddInteger( const char* key, S64 value );
+        void AddBoolean( const char* key, bool value );
+        void AddByteArray( const char* key, const U8* data, U64 length );
+
+      protected:
+        friend class Iso14443aFrameV2Queue;
+
+        enum class FieldType : U8
+        {
+            String,
+            Integer,
+            Boolean,
+            ByteArray,
+        };
+
+        struct Field
+        {
+            const char* key;
+            FieldType type;
+            const char* string;
+            S64 integer; // value, or the offset of a byte array in mData
+            size_t length;
+        };
+
+        void Reset( const char* type, U64 start_sample, U64 end_sample );
+        void AddTo( FrameV2& frame_v2 ) const;
+
+        const char* mType;
+        U64 mStartSample;
+        U64 mEndSample;
+        std::vector<Field> mFields;
+        std::vector<U8> mData;
+    };
+
+    Iso14443aFrameV2Queue();
+
+    void Clear();
+
+    // Queues a FrameV2 after the others. The returned record is valid until the next FrameV2 is queued.
+    Record& Add( const char* type, U64 start_sample, U64 end_sample );
+    // Queues a FrameV2 before the queued ones that start at or after it, e.g. an APDU before the FrameV2 of its first block.
+    Record& Insert( const char* type, U64 start_sample, U64 end_sample );
+
+    // Adds the queued FrameV2s to the results, in the order of the queue.
+    void Flush( AnalyzerResults& results );
+
+  protected:
+    std::vector<Record> mRecords;
+    size_t mCount;
+};
+
+#endif // ISO14443A_FRAME_V2_QUEUE
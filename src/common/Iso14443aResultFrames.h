@@ -0,0 +1,16 @@
+#ifndef ISO14443A_RESULT_FRAMES
+#define ISO14443A_RESULT_FRAMES
+
+#include <LogicPublicTypes.h>
+
+// Types and flags of the result frames, the same for all analyzers.
+static const U8 FRAME_TYPE_VIEW_MASK = 0b00000011;
+static const U8 FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE = 0b00000000;
+static const U8 FRAME_TYPE_VIEW_BYTES_BYTE = 0b00000001;
+static const U8 FRAME_TYPE_VIEW_BYTES_SOC = 0b00000010;
+static const U8 FRAME_TYPE_VIEW_BYTES_EOC = 0b00000011;
+
+static const U8 FRAME_FLAG_PARITY_ERROR = 1;
+static const U8 FRAME_FLAG_PICC = 2; // only set by the dual analyzer, the others have a single direction
+
+#endif // ISO14443A_RESULT_FRAMES
@@ -0,0 +1,89 @@
+#include "Iso14443aResultText.h"
+#include <AnalyzerHelpers.h>
+
+static const char* const BITS_HINTS[] = { " (0 Bits)", " (1 Bits)", " (2 Bits)", " (3 Bits)",
+                                          " (4 Bits)", " (5 Bits)", " (6 Bits)", " (7 Bits)" };
+static const char* const PARITY_ERROR_TEXT = " (Parity Error)";
+
+static const char* GetBitsHint( U64 bits )
+{
+    return bits < 8 ? BITS_HINTS[ bits ] : "";
+}
+
+Iso14443aResultText::Iso14443aResultText( const char* const* sequence_names, U32 sequence_count )
+    : mSequenceNames( sequence_names ), mSequenceCount( sequence_count ), mByteStringsValid{}, mNumberString{}
+{
+}
+
+const char* Iso14443aResultText::GetNumberString( U64 value, U32 bits, DisplayBase display_base )
+{
+    U32 base = U32( display_base );
+    if( ( bits != 8 ) || ( base >= DISPLAY_BASE_COUNT ) )
+    {
+        AnalyzerHelpers::GetNumberString( value, display_base, bits, mNumberString, NUMBER_STRING_SIZE );
+        return mNumberString;
+    }
+
+    if( !mByteStringsValid[ base ] )
+    {
+        for( U32 byte = 0; byte < 256; byte++ )
+        {
+            AnalyzerHelpers::GetNumberString( byte, display_base, 8, mByteStrings[ base ][ byte ], NUMBER_STRING_SIZE );
+        }
+        mByteStringsValid[ base ] = true;
+    }
+    return mByteStrings[ base ][ value & 0xFF ];
+}
+
+const char* Iso14443aResultText::GetSequenceString( U64 value ) const
+{
+    return value < mSequenceCount ? mSequenceNames[ value ] : "ERROR";
+}
+
+void Iso14443aResultText::AddBubbleText( AnalyzerResults& results, const Frame& frame, DisplayBase display_base )
+{
+    switch( frame.mType & FRAME_TYPE_VIEW_MASK )
+    {
+        case FRAME_TYPE_VIEW_BYTES_BYTE:
+        {
+            const char* number = GetNumberString( frame.mData1, U32( frame.mData2 ), display_base );
+            const char* error = ( frame.mFlags & FRAME_FLAG_PARITY_ERROR ) ? PARITY_ERROR_TEXT : "";
+            // the shorter one for narrow bubbles
+            if( ( frame.mData2 != 8 ) || ( error[ 0 ] != '\0' ) )
+            {
+                results.AddResultString( number );
+            }
+            results.AddResultString( number, GetBitsHint( frame.mData2 ), error );
+            break;
+        }
+        case FRAME_TYPE_VIEW_BYTES_SOC:
+            results.AddResultString( "SOC" );
+            break;
+        case FRAME_TYPE_VIEW_BYTES_EOC:
+            results.AddResultString( "EOC" );
+            break;
+        default:
+            results.AddResultString( GetSequenceString( frame.mData1 ) );
+            break;
+    }
+}
+
+void Iso14443aResultText::AddTabularText( AnalyzerResults& results, const Frame& frame, DisplayBase display_base, const char* prefix )
+{
+    switch( frame.mType & FRAME_TYPE_VIEW_MASK )
+    {
+        case FRAME_TYPE_VIEW_BYTES_BYTE:
+            results.AddTabularText( prefix, GetNumberString( frame.mData1, U32( frame.mData2 ), display_base ), GetBitsHint( frame.mData2 ),
+                                    ( frame.mFlags & FRAME_FLAG_PARITY_ERROR ) ? PARITY_ERROR_TEXT : "" );
+            break;
+        case FRAME_TYPE_VIEW_BYTES_SOC:
+            results.AddTabularText( prefix, "SOC" );
+            break;
+        case FRAME_TYPE_VIEW_BYTES_EOC:
+            results.AddTabularText( prefix, "EOC" );
+            break;
+        default:
+            results.AddTabularText( prefix, GetSequenceString( frame.mData1 ) );
+            break;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef ISO14443A_RESULT_TEXT
+#define ISO14443A_RESULT_TEXT
+
+#include <AnalyzerResults.h>
+#include "Iso14443aResultFrames.h"
+
+// Bubble and tabular text of the result frames, shared by the Results classes. Logic 2 asks for them all the time while scrolling
+// and zooming, so nothing is allocated: the strings are constants or the number strings of the bytes, which are built once per
+// display base and then looked up.
+class Iso14443aResultText
+{
+  public:
+    // sequence_names is indexed by the sequence value, the ones past sequence_count are errors
+    Iso14443aResultText( const char* const* sequence_names, U32 sequence_count );
+
+    void AddBubbleText( AnalyzerResults& results, const Frame& frame, DisplayBase display_base );
+    // prefix is e.g. the direction, can be empty
+    void AddTabularText( AnalyzerResults& results, const Frame& frame, DisplayBase display_base, const char* prefix );
+
+  protected:
+    static const U32 NUMBER_STRING_SIZE = 32;
+    static const U32 DISPLAY_BASE_COUNT = 5;
+
+    const char* GetNumberString( U64 value, U32 bits, DisplayBase display_base );
+    const char* GetSequenceString( U64 value ) const;
+
+    const char* const* mSequenceNames;
+    U32 mSequenceCount;
+
+    // complete bytes, per display base
+    char mByteStrings[ DISPLAY_BASE_COUNT ][ 256 ][ NUMBER_STRING_SIZE ];
+    bool mByteStringsValid[ DISPLAY_BASE_COUNT ];
+    // incomplete bytes
+    char mNumberString[ NUMBER_STRING_SIZE ];
+};
+
+#endif // ISO14443A_RESULT_TEXT
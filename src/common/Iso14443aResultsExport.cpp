@@ -0,0 +1,186 @@
+#include "Iso14443aResultsExport.h"
+#include "Iso14443aExportWriter.h"
+#include "Iso14443aPcapngWriter.h"
+
+using Iso14443a::ExportWriter;
+using Iso14443a::NumberFormat;
+using Iso14443a::PcapngWriter;
+
+static NumberFormat GetNumberFormat( DisplayBase display_base )
+{
+    switch( display_base )
+    {
+        case Decimal:
+            return NumberFormat::Decimal;
+        case Binary:
+            return NumberFormat::Binary;
+        case ASCII:
+            return NumberFormat::Ascii;
+        default:
+            return NumberFormat::Hexadecimal;
+    }
+}
+
+Iso14443aResultsExport::Iso14443aResultsExport( AnalyzerResults& results, U64 trigger_sample, U32 sample_rate_hz,
+                                                bool default_is_response, bool with_direction )
+    : mResults( results ),
+      mTriggerSample( trigger_sample ),
+      mSampleRateHz( sample_rate_hz ),
+      mDefaultIsResponse( default_is_response ),
+      mWithDirection( with_direction )
+{
+}
+
+bool Iso14443aResultsExport::UpdateProgress( U64 frame_index, U64 frame_count )
+{
+    // the SDK call is not free, so only every few frames
+    if( ( frame_index & 0x3FF ) != 0 )
+    {
+        return false;
+    }
+    return mResults.UpdateExportProgressAndCheckForCancel( frame_index, frame_count );
+}
+
+void Iso14443aResultsExport::ExportValues( const char* file, DisplayBase display_base, bool bytes_only )
+{
+    ExportWriter writer;
+    writer.Open( file, mTriggerSample, mSampleRateHz, GetNumberFormat( display_base ), mWithDirection );
+    writer.WriteValueHeader();
+
+    U64 num_frames = mResults.GetNumFrames();
+    for( U64 i = 0; i < num_frames; i++ )
+    {
+        Frame frame = mResults.GetFrame( i );
+        if( !bytes_only || ( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_BYTES_BYTE ) )
+        {
+            writer.WriteValueRow( frame.mStartingSampleInclusive, IsResponse( frame ), frame.mData1, 8 );
+        }
+
+        if( UpdateProgress( i, num_frames ) )
+        {
+            break;
+        }
+    }
+
+    writer.Close();
+}
+
+void Iso14443aResultsExport::ExportSequences( const char* file, const char* const* sequence_names, U32 sequence_count )
+{
+    ExportWriter writer;
+    writer.Open( file, mTriggerSample, mSampleRateHz, NumberFormat::Hexadecimal, mWithDirection );
+    writer.WriteSequenceHeader();
+
+    U64 num_frames = mResults.GetNumFrames();
+    for( U64 i = 0; i < num_frames; i++ )
+    {
+        Frame frame = mResults.GetFrame( i );
+        if( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE )
+        {
+            const char* name = frame.mData1 < sequence_count ? sequence_names[ frame.mData1 ] : "ERROR";
+            writer.WriteSequenceRow( frame.mStartingSampleInclusive, frame.mEndingSampleInclusive, IsResponse( frame ), name );
+        }
+
+        if( UpdateProgress( i, num_frames ) )
+        {
+            break;
+        }
+    }
+
+    writer.Close();
+}
+
+void Iso14443aResultsExport::ExportBytes( const char* file, DisplayBase display_base )
+{
+    ExportWriter writer;
+    writer.Open( file, mTriggerSample, mSampleRateHz, GetNumberFormat( display_base ), mWithDirection );
+    writer.WriteByteHeader();
+
+    U64 num_frames = mResults.GetNumFrames();
+    for( U64 i = 0; i < num_frames; i++ )
+    {
+        Frame frame = mResults.GetFrame( i );
+        if( ( frame.mType & FRAME_TYPE_VIEW_MASK ) == FRAME_TYPE_VIEW_BYTES_BYTE )
+        {
+            writer.WriteByteRow( frame.mStartingSampleInclusive, frame.mEndingSampleInclusive, IsResponse( frame ), U8( frame.mData1 ),
+                                 U8( frame.mData2 ), ( frame.mFlags & FRAME_FLAG_PARITY_ERROR ) != 0 );
+        }
+
+        if( UpdateProgress( i, num_frames ) )
+        {
+            break;
+        }
+    }
+
+    writer.Close();
+}
+
+void Iso14443aResultsExport::ExportFrames( const char* file )
+{
+    ExportWriter writer;
+    writer.Open( file, mTriggerSample, mSampleRateHz, NumberFormat::Hexadecimal, mWithDirection );
+    writer.WriteFrameHeader();
+
+    U64 num_frames = mResults.GetNumFrames();
+    for( U64 i = 0; i < num_frames; i++ )
+    {
+        Frame frame = mResults.GetFrame( i );
+        switch( frame.mType & FRAME_TYPE_VIEW_MASK )
+        {
+            case FRAME_TYPE_VIEW_BYTES_SOC:
+                writer.StartFrame( IsResponse( frame ), frame.mStartingSampleInclusive, frame.mEndingSampleInclusive );
+                break;
+            case FRAME_TYPE_VIEW_BYTES_BYTE:
+                writer.AddByte( IsResponse( frame ), U8( frame.mData1 ), U8( frame.mData2 ),
+                                ( frame.mFlags & FRAME_FLAG_PARITY_ERROR ) != 0, frame.mEndingSampleInclusive );
+                break;
+            case FRAME_TYPE_VIEW_BYTES_EOC:
+                writer.EndFrame( IsResponse( frame ), frame.mEndingSampleInclusive );
+                break;
+            default:
+                break;
+        }
+
+        if( UpdateProgress( i, num_frames ) )
+        {
+            break;
+        }
+    }
+
+    writer.Close();
+}
+
+void Iso14443aResultsExport::ExportPcapng( const char* file )
+{
+    // one packet per SOC ... EOC, only the bytes output has them
+    PcapngWriter writer;
+    writer.Open( file, mSampleRateHz );
+
+    U64 num_frames = mResults.GetNumFrames();
+    for( U64 i = 0; i < num_frames; i++ )
+    {
+        Frame frame = mResults.GetFrame( i );
+        switch( frame.mType & FRAME_TYPE_VIEW_MASK )
+        {
+            case FRAME_TYPE_VIEW_BYTES_SOC:
+                writer.StartPacket( IsResponse( frame ), frame.mStartingSampleInclusive );
+                break;
+            case FRAME_TYPE_VIEW_BYTES_BYTE:
+                writer.AddByte( IsResponse( frame ), U8( frame.mData1 ), U8( frame.mData2 ),
+                                ( frame.mFlags & FRAME_FLAG_PARITY_ERROR ) != 0 );
+                break;
+            case FRAME_TYPE_VIEW_BYTES_EOC:
+                writer.EndPacket( IsResponse( frame ) );
+                break;
+            default:
+                break;
+        }
+
+        if( UpdateProgress( i, num_frames ) )
+        {
+            break;
+        }
+    }
+
+    writer.Close();
+}
@@ -0,0 +1,38 @@
+#ifndef ISO14443A_RESULTS_EXPORT
+#define ISO14443A_RESULTS_EXPORT
+
+#include <AnalyzerResults.h>
+#include "Iso14443aResultFrames.h"
+
+// Exports the result frames of an analyzer through the buffered writers of the core. The frames of the dual analyzer carry
+// FRAME_FLAG_PICC, the ones of the other analyzers all have the default direction.
+class Iso14443aResultsExport
+{
+  public:
+    Iso14443aResultsExport( AnalyzerResults& results, U64 trigger_sample, U32 sample_rate_hz, bool default_is_response,
+                            bool with_direction );
+
+    // one row per result frame (or only per byte), the value in the display base
+    void ExportValues( const char* file, DisplayBase display_base, bool bytes_only );
+    // sequence_names is indexed by the sequence value, the ones past sequence_count are errors
+    void ExportSequences( const char* file, const char* const* sequence_names, U32 sequence_count );
+    void ExportBytes( const char* file, DisplayBase display_base );
+    // one row per SOC ... EOC with its status, CRC and data
+    void ExportFrames( const char* file );
+    void ExportPcapng( const char* file );
+
+  protected:
+    bool IsResponse( const Frame& frame ) const
+    {
+        return mDefaultIsResponse || ( ( frame.mFlags & FRAME_FLAG_PICC ) != 0 );
+    }
+    bool UpdateProgress( U64 frame_index, U64 frame_count );
+
+    AnalyzerResults& mResults;
+    U64 mTriggerSample;
+    U32 mSampleRateHz;
+    bool mDefaultIsResponse;
+    bool mWithDirection;
+};
+
+#endif // ISO14443A_RESULTS_EXPORT
@@ -0,0 +1,40 @@
+#ifndef ISO14443A_SIMULATION_SINK
+#define ISO14443A_SIMULATION_SINK
+
+#include <SimulationChannelDescriptor.h>
+#include "Iso14443aWaveformGenerator.h"
+
+// Hands the generated edges to a simulation channel.
+class Iso14443aSimulationSink : public Iso14443a::WaveformSink
+{
+  public:
+    Iso14443aSimulationSink() : mChannel( nullptr )
+    {
+    }
+
+    void SetChannel( SimulationChannelDescriptor* channel )
+    {
+        mChannel = channel;
+    }
+
+    virtual void OnEdge( Iso14443a::U64 sample )
+    {
+        AdvanceTo( sample );
+        mChannel->Transition();
+    }
+
+    // the line stays as it is up to the sample
+    void AdvanceTo( Iso14443a::U64 sample )
+    {
+        U64 current_sample = mChannel->GetCurrentSampleNumber();
+        if( sample > current_sample )
+        {
+            mChannel->Advance( U32( sample - current_sample ) );
+        }
+    }
+
+  protected:
+    SimulationChannelDescriptor* mChannel;
+};
+
+#endif // ISO14443A_SIMULATION_SINK
@@ -0,0 +1,474 @@
+#include "Iso14443aAskDecoder.h"
+#include "Iso14443aCrc.h"
+#include "Iso14443aSequenceTables.h"
+#include <algorithm>
+
+namespace Iso14443a
+{
+    AskDecoder::AskDecoder( EdgeSource& source, DecoderSink& sink )
+        : mSource( source ),
+          mSink( sink ),
+          mBitGrid( &mBitGrids[ 0 ] ),
+          mBitRate( BitRate::Fc128 ),
+          mDetectBitRate( false ),
+          mIdleState( LINE_HIGH ),
+          mMarkerDetail( MarkerDetail::SamplingPoints ),
+          mResyncGapBits( 3 ),
+          mDetection( AskSequenceDetection::SamplingPoints ),
+          mClockRecovery( true ),
+          mSampleRateHz( 0 ),
+          mCarrierHz( NOMINAL_CARRIER_HZ )
+    {
+    }
+
+    void AskDecoder::Setup( U32 sample_rate_hz, U32 carrier_hz, LineState idle_state, AskSequenceDetection detection )
+    {
+        mSampleRateHz = sample_rate_hz;
+        SetupBitGrid( carrier_hz );
+        mIdleState = idle_state;
+        mDetection = detection;
+    }
+
+    // all timing derives from the carrier, the grids precompute it once per carrier
+    void AskDecoder::SetupBitGrid( U32 carrier_hz )
+    {
+        mCarrierHz = carrier_hz;
+        for( U32 i = 0; i < BIT_RATE_COUNT; i++ )
+        {
+            mBitGrids[ i ].Setup( mSampleRateHz, carrier_hz, GetCarrierCyclesPerBit( BitRate( i ) ) );
+        }
+    }
+
+    void AskDecoder::SetCarrierCalibration( U32 frame_count )
+    {
+        mCalibration.Setup( mSampleRateHz, mCarrierHz, frame_count );
+        for( U32 i = 0; i < BIT_RATE_COUNT; i++ )
+        {
+            mBitGrids[ i ].SetCalibration( frame_count > 0 ? &mCalibration : nullptr );
+        }
+    }
+
+    void AskDecoder::FinishCalibration()
+    {
+        U32 carrier_hz = mCalibration.GetCarrierHz();
+        if( carrier_hz != 0 )
+        {
+            SetupBitGrid( carrier_hz );
+        }
+        for( U32 i = 0; i < BIT_RATE_COUNT; i++ )
+        {
+            mBitGrids[ i ].SetCalibration( nullptr );
+        }
+    }
+
+    void AskDecoder::SetMarkerDetail( MarkerDetail marker_detail )
+    {
+        mMarkerDetail = marker_detail;
+    }
+
+    void AskDecoder::SetBitRate( BitRate bit_rate )
+    {
+        mBitRate = bit_rate;
+    }
+
+    void AskDecoder::SetBitRateDetection( bool detect_bit_rate )
+    {
+        mDetectBitRate = detect_bit_rate;
+    }
+
+    void AskDecoder::SetResyncGap( U32 gap_bits )
+    {
+        mResyncGapBits = gap_bits;
+    }
+
+    void AskDecoder::SetClockRecovery( bool clock_recovery )
+    {
+        mClockRecovery = clock_recovery;
+    }
+
+    void AskDecoder::WaitForIdle()
+    {
+        if( mSource.GetBitState() != mIdleState )
+            mSource.AdvanceToNextEdge();
+    }
+
+    std::tuple<U8, U64> AskDecoder::ReceiveSeq( DecodedFrame& ask_frame )
+    {
+        if( mDetection == AskSequenceDetection::PauseEdges )
+        {
+            return ReceiveSeqFromPauseEdges( ask_frame );
+        }
+
+        return ReceiveSeqAtSamplingPoints( ask_frame );
+    }
+
+    std::tuple<U8, U64> AskDecoder::ReceiveSeqAtSamplingPoints( DecodedFrame& ask_frame )
+    {
+        U32 bit_changes = 0;
+        U8 seq = 0;
+
+        U64 seq_start_sample = mBitGrid->GetSeqStartSample();
+        mBitGrid->NextSeq();
+        ask_frame.seq_num++;
+
+        // mark start of sequence
+        AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+
+        // wait for first bit half
+        U64 pause_start_sample = 0;
+        ask_frame.frame_end_sample = seq_start_sample + mBitGrid->GetOffset( BitGrid::SIXTH_BIT );
+        bool pause_start_seen = PeekPauseStart( ask_frame.frame_end_sample, pause_start_sample );
+        bit_changes = mSource.AdvanceToAbsPosition( ask_frame.frame_end_sample );
+        if( bit_changes > 1 )
+        {
+            return { ASK_SEQ_ERROR, seq_start_sample };
+        }
+
+        // mark sampling point
+        AddMarker( ask_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+        if( mSource.GetBitState() != mIdleState )
+        {
+            seq |= 0b10;
+
+            // the pause of a Z starts with the bit
+            if( pause_start_seen )
+            {
+                mBitGrid->Align( pause_start_sample, 0 );
+            }
+        }
+
+        // wait for second bit half
+        ask_frame.frame_end_sample = seq_start_sample + mBitGrid->GetOffset( BitGrid::TWO_THIRD_BIT );
+        pause_start_seen = PeekPauseStart( ask_frame.frame_end_sample, pause_start_sample );
+        bit_changes = mSource.AdvanceToAbsPosition( ask_frame.frame_end_sample );
+        if( bit_changes > 1 )
+        {
+            return { ASK_SEQ_ERROR, seq_start_sample };
+        }
+
+        // mark sampling point
+        AddMarker( ask_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+        if( mSource.GetBitState() != mIdleState )
+        {
+            seq |= 0b01;
+
+            // the pause of a X starts in the middle of the bit
+            if( pause_start_seen )
+            {
+                mBitGrid->Align( pause_start_sample, BitGrid::HALF_BIT );
+            }
+        }
+
+        mSink.OnSequence( seq, seq_start_sample, seq_start_sample + mBitGrid->GetOffset( BitGrid::ONE_BIT ) - 1 );
+
+        return { seq, seq_start_sample };
+    }
+
+    // Every pause that starts within [-1/4, 3/4) of a bit belongs to it: a pause around the bit start is a Z, a pause around the
+    // middle of the bit is a X and no pause at all is a Y. Only the pause edges are visited, so idle lines cost nothing.
+    std::tuple<U8, U64> AskDecoder::ReceiveSeqFromPauseEdges( DecodedFrame& ask_frame )
+    {
+        U8 seq = ASK_SEQ_Y;
+
+        U64 seq_start_sample = mBitGrid->GetSeqStartSample();
+        mBitGrid->NextSeq();
+        ask_frame.seq_num++;
+
+        U64 quarter_bit = mBitGrid->GetOffset( BitGrid::QUARTER_BIT );
+        U64 half_bit = mBitGrid->GetOffset( BitGrid::HALF_BIT );
+        U64 window_end_sample = seq_start_sample + mBitGrid->GetOffset( BitGrid::THREE_QUARTER_BIT );
+
+        // the pause of the start of communication has already been entered while waiting for the frame
+        bool in_pause = mSource.GetBitState() != mIdleState;
+
+        if( in_pause || mSource.WouldAdvancingToAbsPositionCauseTransition( window_end_sample - 1 ) )
+        {
+            U64 pause_start_sample = in_pause ? mSource.GetSampleNumber() : mSource.GetSampleOfNextEdge();
+            if( pause_start_sample + quarter_bit < seq_start_sample )
+            {
+                // pause belongs to the previous bit, so it had two pauses. The frame breaks at the start of this bit, the
+                // markers of the previous bit can lie behind the pause.
+                AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+                ask_frame.frame_end_sample = std::max( seq_start_sample, ask_frame.frame_start_sample + 1 );
+                return { ASK_SEQ_ERROR, seq_start_sample };
+            }
+
+            if( !in_pause )
+            {
+                mSource.AdvanceToNextEdge();
+            }
+
+            // the pause of a Z may start before its sequence, the markers are added in sample order
+            if( pause_start_sample < seq_start_sample )
+            {
+                AddMarker( pause_start_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+            }
+            AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+
+            // a pause must be over before the next bit half starts
+            if( !mSource.WouldAdvancingToAbsPositionCauseTransition( pause_start_sample + half_bit ) )
+            {
+                ask_frame.frame_end_sample = std::max( pause_start_sample + half_bit, ask_frame.frame_start_sample + 1 );
+                return { ASK_SEQ_ERROR, seq_start_sample };
+            }
+            mSource.AdvanceToNextEdge();
+
+            // mark pause
+            if( pause_start_sample >= seq_start_sample )
+            {
+                AddMarker( pause_start_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+            }
+
+            seq = ( pause_start_sample < seq_start_sample + quarter_bit ) ? ASK_SEQ_Z : ASK_SEQ_X;
+            if( mClockRecovery )
+            {
+                mBitGrid->Align( pause_start_sample, seq == ASK_SEQ_Z ? 0 : BitGrid::HALF_BIT );
+            }
+        }
+        else
+        {
+            // mark start of sequence
+            AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+        }
+
+        ask_frame.frame_end_sample = window_end_sample;
+
+        mSink.OnSequence( seq, seq_start_sample, seq_start_sample + mBitGrid->GetOffset( BitGrid::ONE_BIT ) - 1 );
+
+        return { seq, seq_start_sample };
+    }
+
+    // The pause lasts about a quarter of a bit at every bit rate, so the fastest bit rate for which the pause of the start of
+    // communication is not longer than 3/8 of a bit is taken. The source must be at the start of the pause.
+    BitRate AskDecoder::DetectBitRate()
+    {
+        U64 pause_samples = mSource.GetSampleOfNextEdge() - mSource.GetSampleNumber();
+
+        for( U32 i = BIT_RATE_COUNT - 1; i > 0; i-- )
+        {
+            if( pause_samples <= ( mBitGrids[ i ].GetOffset( BitGrid::ONE_BIT ) * 3 ) / 8 )
+            {
+                return BitRate( i );
+            }
+        }
+        return BitRate::Fc128;
+    }
+
+    DecodedFrame::Error AskDecoder::ReceiveStartOfCommunication( DecodedFrame& ask_frame )
+    {
+        // wait for edge as start condition (eg. rising edge)
+        mSource.AdvanceToNextEdge();
+        if( mSource.IsEndOfStream() )
+        {
+            // nothing to classify, DecodeFrame stops without reporting anything
+            return DecodedFrame::Error::ErrorWrongSoc;
+        }
+        ask_frame.frame_start_sample = mSource.GetSampleNumber();
+        ask_frame.seq_num = 0;
+
+        ask_frame.bit_rate = mDetectBitRate ? DetectBitRate() : mBitRate;
+        mBitGrid = &mBitGrids[ U32( ask_frame.bit_rate ) ];
+        mBitGrid->Start( ask_frame.frame_start_sample );
+
+        // detect start of communication
+        auto seq = ReceiveSeq( ask_frame );
+
+        if( std::get<0>( seq ) != ASK_SEQ_Z )
+        {
+            // ERROR
+            ask_frame.error = DecodedFrame::Error::ErrorWrongSoc;
+            return ask_frame.error;
+        }
+
+        ask_frame.frame_data_start_sample = ask_frame.frame_start_sample + mBitGrid->GetOffset( BitGrid::ONE_BIT );
+
+        mSink.OnStartOfCommunication( ask_frame.frame_start_sample, ask_frame.frame_data_start_sample - 1 );
+
+        return DecodedFrame::Error::Ok;
+    }
+
+    DecodedFrame::Error AskDecoder::ReceiveData( DecodedFrame& ask_frame )
+    {
+        bool end_of_communication = false;
+
+        mBitBuffer.Clear();
+
+        // last_bit must be 0, because a logic "0" followed by the start of communication must begin with SeqZ instead of SeqY
+        std::tuple<U8, U64> last_bit = { 0, ask_frame.frame_data_start_sample };
+        bool last_bit_available{ false };
+
+        while( true )
+        {
+            auto seq = ReceiveSeq( ask_frame );
+            U8 seq_result = LookupAskSequence( std::get<0>( last_bit ), std::get<0>( seq ) );
+
+            if( seq_result <= SEQ_RESULT_BIT_1 )
+            {
+                // logic "0" or "1"
+                last_bit = { seq_result, std::get<1>( seq ) };
+                last_bit_available = true;
+            }
+            else if( seq_result == SEQ_RESULT_EOC )
+            {
+                end_of_communication = true;
+            }
+            else
+            {
+                // an earlier parity error stays the error of the frame, the wrong sequence ends it anyway
+                if( ask_frame.error == DecodedFrame::Error::Ok )
+                {
+                    ask_frame.error = DecodedFrame::Error::ErrorWrongSequence;
+                }
+                return DecodedFrame::Error::ErrorWrongSequence;
+            }
+
+            // If a byte is completely recevied or an "end of communication" is detected (incomplete bytes are valid) show it
+            if( mBitBuffer.IsFull() || end_of_communication )
+            {
+                if( end_of_communication )
+                {
+                    mBitBuffer.DropLastBit(); // last bit belogs to eoc
+                }
+
+                U8 bits_in_byte = mBitBuffer.GetBitCount();
+                if( bits_in_byte > 0 )
+                {
+                    U8 byte = mBitBuffer.GetDataByte();
+
+                    bool parity_error = false;
+                    if( bits_in_byte == 9 )
+                    {
+                        bits_in_byte--;
+
+                        if( HasOddOnesCount( byte ) == bool( mBitBuffer.GetParityBit() ) )
+                        {
+                            parity_error = true;
+                            ask_frame.error = DecodedFrame::Error::ErrorParity;
+                        }
+                    }
+
+                    U64 bit_starting_sample = mBitBuffer.GetFirstBitStartSample();
+                    U64 bit_ending_sample = mBitBuffer.GetLastBitStartSample() + mBitGrid->GetOffset( BitGrid::ONE_BIT ) - 1;
+                    mBitBuffer.Clear();
+
+                    ask_frame.data.push_back( byte );
+                    ask_frame.data_valid_bits_in_last_byte = bits_in_byte;
+
+                    mSink.OnByte( byte, bits_in_byte, parity_error, bit_starting_sample, bit_ending_sample );
+                }
+            }
+
+            if( end_of_communication == true )
+            {
+                U64 eoc_starting_sample = std::get<1>( last_bit );
+                U64 eoc_ending_sample{ 0U };
+                if( last_bit_available )
+                {
+                    // last bit is available, so the eoc is only one bit wide
+                    eoc_ending_sample = eoc_starting_sample + mBitGrid->GetOffset( BitGrid::TWO_BITS );
+                }
+                else
+                {
+                    // no last bit availabe, so the eoc is only one bit wide
+                    eoc_ending_sample = eoc_starting_sample + mBitGrid->GetOffset( BitGrid::ONE_BIT );
+                }
+
+                // wait until the end of the frame
+                ask_frame.frame_end_sample = eoc_ending_sample;
+                mSource.AdvanceToAbsPosition( ask_frame.frame_end_sample );
+
+                mSink.OnEndOfCommunication( eoc_starting_sample, eoc_ending_sample - 1 );
+
+                // End of communication
+                break;
+            }
+            else
+            {
+                // If no eoc is detected, the last bit is valid.
+                mBitBuffer.PushBit( std::get<0>( last_bit ), std::get<1>( last_bit ) );
+            }
+        }
+
+        return ask_frame.error;
+    }
+
+    // The position after a broken frame is usually still inside of it. Searching the next start of communication from there
+    // would turn every remaining edge of the frame into another broken frame, so the edges are skipped up to the next gap.
+    void AskDecoder::Resync()
+    {
+        if( mResyncGapBits == 0 )
+        {
+            return;
+        }
+
+        // with a detected bit rate the gap is measured in bits of the slowest one
+        const BitGrid& bit_grid = mBitGrids[ U32( mDetectBitRate ? BitRate::Fc128 : mBitRate ) ];
+        U64 min_gap_samples = bit_grid.GetOffset( BitGrid::ONE_BIT ) * mResyncGapBits;
+
+        U64 start_sample = mSource.GetSampleNumber();
+        U64 skipped_edges = 0;
+        while( !mSource.IsEndOfStream() )
+        {
+            bool idle = mSource.GetBitState() == mIdleState;
+            if( idle && !mSource.WouldAdvancingToAbsPositionCauseTransition( mSource.GetSampleNumber() + min_gap_samples - 1 ) )
+            {
+                break;
+            }
+            mSource.AdvanceToNextEdge();
+            skipped_edges++;
+        }
+
+        if( skipped_edges > 0 )
+        {
+            mSink.OnResync( start_sample, mSource.GetSampleNumber(), skipped_edges );
+        }
+    }
+
+    bool AskDecoder::DecodeFrame()
+    {
+        DecodedFrame& ask_frame = mFrame;
+        ask_frame.Reset();
+
+        DecodedFrame::Error ask_error;
+
+        ask_error = ReceiveStartOfCommunication( ask_frame );
+        if( ask_error == DecodedFrame::Error::Ok )
+        {
+            ask_error = ReceiveData( ask_frame );
+        }
+        if( ask_error == DecodedFrame::Error::Ok )
+        {
+            // a PCD frame is never a UID CLn
+            CheckCrcA( ask_frame, false );
+            if( ( ask_frame.crc == DecodedFrame::CrcStatus::Wrong ) && ( ask_frame.error == DecodedFrame::Error::Ok ) )
+            {
+                ask_frame.error = DecodedFrame::Error::ErrorCrc;
+            }
+        }
+
+        // a recorded stream ran out of edges while waiting for the next frame
+        if( mSource.IsEndOfStream() )
+        {
+            return false;
+        }
+
+        if( ask_frame.error != DecodedFrame::Error::Ok )
+        {
+            AddMarker( ask_frame.frame_end_sample, MarkerType::Error, MarkerDetail::Errors );
+        }
+
+        mSink.OnFrame( ask_frame, ask_frame.frame_start_sample, ask_frame.frame_end_sample - 1 );
+
+        if( mCalibration.EndFrame( ask_frame.error == DecodedFrame::Error::Ok ) )
+        {
+            FinishCalibration();
+        }
+
+        // a parity or CRC error does not break the framing, a wrong SOC or sequence does (even after a parity error)
+        if( ( ask_error != DecodedFrame::Error::Ok ) && ( ask_error != DecodedFrame::Error::ErrorParity ) )
+        {
+            Resync();
+        }
+        return true;
+    }
+}
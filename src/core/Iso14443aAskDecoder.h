@@ -0,0 +1,119 @@
+#ifndef ISO14443A_ASK_DECODER
+#define ISO14443A_ASK_DECODER
+
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aEdgeSource.h"
+#include "Iso14443aDecoderSink.h"
+#include "Iso14443aBitAccumulator.h"
+#include "Iso14443aBitGrid.h"
+#include "Iso14443aCarrierCalibration.h"
+#include <tuple>
+#include <algorithm>
+
+namespace Iso14443a
+{
+    enum class AskSequenceDetection
+    {
+        SamplingPoints, // sample the line twice per bit
+        PauseEdges,     // classify the sequences by the position of the pause edges
+    };
+
+    // Decodes 100% ASK with Modified Miller coding (PCD to PICC) from an edge stream.
+    class AskDecoder
+    {
+      public:
+        AskDecoder( EdgeSource& source, DecoderSink& sink );
+
+        void Setup( U32 sample_rate_hz, U32 carrier_hz, LineState idle_state, AskSequenceDetection detection );
+
+        void SetMarkerDetail( MarkerDetail marker_detail );
+
+        // The bit rate of all frames, unless it is detected per frame from the width of the start of communication pause.
+        void SetBitRate( BitRate bit_rate );
+        void SetBitRateDetection( bool detect_bit_rate );
+
+        // After a broken frame all edges up to the next idle gap of at least gap_bits bits are skipped, 0 disables this.
+        void SetResyncGap( U32 gap_bits );
+
+        // Re-anchors the bit grid on the start of every pause, so long frames of a reader with a deviating carrier stay on the
+        // grid. Enabled by default.
+        void SetClockRecovery( bool clock_recovery );
+
+        // Measures the carrier on the next frame_count frames without errors and sets the bit grid up for the measured carrier
+        // from then on, 0 disables this. Needs the clock recovery, the calibration measures the edges the grid aligns to.
+        void SetCarrierCalibration( U32 frame_count );
+
+        bool IsCalibrating() const
+        {
+            return mCalibration.IsMeasuring();
+        }
+
+        // The carrier of Setup() or the measured one after the calibration.
+        U32 GetCarrierHz() const
+        {
+            return mCarrierHz;
+        }
+
+        // Wait for idle state (eg. low)
+        void WaitForIdle();
+
+        // Decodes the next frame and reports it to the sink. Returns false if the edge stream has ended.
+        bool DecodeFrame();
+
+      protected:
+        // Markers cost memory in the result store, so the decoder only creates the ones that were asked for. They must be added
+        // in sample order.
+        void AddMarker( U64 sample, MarkerType type, MarkerDetail min_detail )
+        {
+            if( mMarkerDetail >= min_detail )
+            {
+                mSink.OnMarker( sample, type );
+            }
+        }
+
+        // True if the line is idle and a pause starts up to and including sample_number.
+        bool PeekPauseStart( U64 sample_number, U64& pause_start_sample )
+        {
+            if( !mClockRecovery || ( mSource.GetBitState() != mIdleState ) ||
+                !mSource.WouldAdvancingToAbsPositionCauseTransition( sample_number ) )
+            {
+                return false;
+            }
+            pause_start_sample = mSource.GetSampleOfNextEdge();
+            return true;
+        }
+
+        std::tuple<U8, U64> ReceiveSeq( DecodedFrame& ask_frame );
+        std::tuple<U8, U64> ReceiveSeqAtSamplingPoints( DecodedFrame& ask_frame );
+        std::tuple<U8, U64> ReceiveSeqFromPauseEdges( DecodedFrame& ask_frame );
+        BitRate DetectBitRate();
+        DecodedFrame::Error ReceiveStartOfCommunication( DecodedFrame& ask_frame );
+        DecodedFrame::Error ReceiveData( DecodedFrame& ask_frame );
+        void Resync();
+        void SetupBitGrid( U32 carrier_hz );
+        void FinishCalibration();
+
+        EdgeSource& mSource;
+        DecoderSink& mSink;
+
+        // reused for every frame, so decoding does not allocate once the data buffer has grown
+        DecodedFrame mFrame;
+        BitAccumulator mBitBuffer;
+
+        BitGrid mBitGrids[ BIT_RATE_COUNT ];
+        BitGrid* mBitGrid;
+        BitRate mBitRate;
+        bool mDetectBitRate;
+        LineState mIdleState;
+        MarkerDetail mMarkerDetail;
+        U32 mResyncGapBits;
+        AskSequenceDetection mDetection;
+        bool mClockRecovery;
+
+        U32 mSampleRateHz;
+        U32 mCarrierHz;
+        CarrierCalibration mCalibration;
+    };
+}
+
+#endif // ISO14443A_ASK_DECODER
@@ -0,0 +1,85 @@
+#ifndef ISO14443A_BIT_ACCUMULATOR
+#define ISO14443A_BIT_ACCUMULATOR
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Collects the bits of one byte (8 data bits + 1 parity bit, LSB first) together with the start samples needed to place the
+    // byte. Fixed size, so receiving a byte does not touch the heap.
+    class BitAccumulator
+    {
+      public:
+        static const U8 MAX_BITS = 9;
+
+        void Clear()
+        {
+            mBits = 0;
+            mBitCount = 0;
+        }
+
+        void PushBit( U8 bit, U64 bit_start_sample )
+        {
+            if( mBitCount == 0 )
+            {
+                mFirstBitStartSample = bit_start_sample;
+            }
+            mPreviousBitStartSample = mLastBitStartSample;
+            mLastBitStartSample = bit_start_sample;
+
+            mBits |= U16( bit & 1 ) << mBitCount;
+            mBitCount++;
+        }
+
+        // Removes the last pushed bit, only one bit can be removed between two pushes.
+        void DropLastBit()
+        {
+            if( mBitCount == 0 )
+            {
+                return;
+            }
+            mBitCount--;
+            mBits &= U16( ( 1U << mBitCount ) - 1 );
+            mLastBitStartSample = mPreviousBitStartSample;
+        }
+
+        bool IsFull() const
+        {
+            return mBitCount == MAX_BITS;
+        }
+
+        U8 GetBitCount() const
+        {
+            return mBitCount;
+        }
+
+        U8 GetDataByte() const
+        {
+            return U8( mBits );
+        }
+
+        U8 GetParityBit() const
+        {
+            return U8( mBits >> 8 ) & 1;
+        }
+
+        U64 GetFirstBitStartSample() const
+        {
+            return mFirstBitStartSample;
+        }
+
+        U64 GetLastBitStartSample() const
+        {
+            return mLastBitStartSample;
+        }
+
+      protected:
+        U16 mBits{ 0U };
+        U8 mBitCount{ 0U };
+        U64 mFirstBitStartSample{ 0U };
+        U64 mLastBitStartSample{ 0U };
+        U64 mPreviousBitStartSample{ 0U };
+    };
+}
+
+#endif // ISO14443A_BIT_ACCUMULATOR
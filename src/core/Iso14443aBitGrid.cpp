@@ -0,0 +1,85 @@
+#include "Iso14443aBitGrid.h"
+#include <algorithm>
+
+namespace Iso14443a
+{
+    BitGrid::BitGrid()
+        : mSampleRateCycles( 0 ),
+          mCarrierHz( 1 ),
+          mCarrierCyclesPerBit( 0 ),
+          mBitStep( 0 ),
+          mBitQuotient( 0 ),
+          mBitRemainder( 0 ),
+          mFrameStartSample( 0 ),
+          mSeqCount( 0 ),
+          mSeqStartSample( 0 ),
+          mRemainder( 0 ),
+          mCalibration( nullptr ),
+          mOffsets()
+    {
+    }
+
+    void BitGrid::Setup( U32 sample_rate_hz, U32 carrier_hz, U32 carrier_cycles_per_bit )
+    {
+        mSampleRateCycles = U64( sample_rate_hz ) * carrier_cycles_per_bit;
+        mCarrierHz = carrier_hz;
+        mCarrierCyclesPerBit = carrier_cycles_per_bit;
+        for( U32 twelfths = 0; twelfths <= TWO_BITS; twelfths++ )
+        {
+            mOffsets[ twelfths ] = ( mSampleRateCycles * twelfths ) / ( mCarrierHz * ONE_BIT );
+        }
+
+        Start( 0 );
+    }
+
+    void BitGrid::SetBitStep( U64 bit_step )
+    {
+        mBitStep = bit_step;
+        mBitQuotient = mBitStep / mCarrierHz;
+        mBitRemainder = mBitStep % mCarrierHz;
+    }
+
+    void BitGrid::Align( U64 edge_sample, U32 twelfths )
+    {
+        // the grid is already at the start of the next sequence, the error is in 1 / mCarrierHz samples. The edge sample is the
+        // first sample after the edge, so the edge itself lies half a sample before it on average.
+        S64 expected = S64( mRemainder ) - S64( mBitStep ) + S64( ( mBitStep * twelfths ) / ONE_BIT );
+        S64 error = ( S64( edge_sample ) - S64( mSeqStartSample ) ) * S64( mCarrierHz ) - S64( mCarrierHz / 2 ) - expected;
+        // drift moves an edge by far less than a twelfth of a bit between two edges, a late edge after a subcarrier dropout
+        // by 1/8 bit, the quantization by up to a sample
+        S64 max_error = S64( std::max( mBitStep / ONE_BIT, 2 * mCarrierHz ) );
+        if( ( error > max_error ) || ( error < -max_error ) )
+        {
+            return;
+        }
+
+        if( mCalibration != nullptr )
+        {
+            // the edge belongs to the sequence before the grid position, at the nominal carrier
+            mCalibration->AddEdge( ( ( mSeqCount - 1 ) * ONE_BIT + twelfths ) * mCarrierCyclesPerBit, edge_sample - mFrameStartSample );
+        }
+
+        // proportional part: an eighth of the phase error, integral part: 1/128 of it changes the bit length (damping about 0.7)
+        S64 position = S64( mRemainder ) + error / 8;
+        S64 carrier_hz = S64( mCarrierHz );
+        S64 whole_samples = position / carrier_hz;
+        position %= carrier_hz;
+        if( position < 0 )
+        {
+            position += carrier_hz;
+            whole_samples--;
+        }
+        mSeqStartSample = U64( S64( mSeqStartSample ) + whole_samples );
+        mRemainder = U64( position );
+
+        // readers stay within +-7 kHz (about 500 ppm) of the carrier, the bit length is kept within +-0.2 %
+        S64 max_deviation = S64( mSampleRateCycles / 512 );
+        S64 deviation = std::min( std::max( S64( mBitStep ) - S64( mSampleRateCycles ) + error / 128, -max_deviation ), max_deviation );
+        SetBitStep( U64( S64( mSampleRateCycles ) + deviation ) );
+    }
+
+    double BitGrid::GetSamplesPerBit() const
+    {
+        return double( mSampleRateCycles ) / double( mCarrierHz );
+    }
+}
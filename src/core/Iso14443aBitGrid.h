@@ -0,0 +1,104 @@
+#ifndef ISO14443A_BIT_GRID
+#define ISO14443A_BIT_GRID
+
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aCarrierCalibration.h"
+
+namespace Iso14443a
+{
+    // Places the sequences of a frame on the sample axis. A bit lasts sample_rate * carrier_cycles_per_bit / carrier samples,
+    // which is rarely an integer. The start of a sequence is kept as an integer sample plus the remainder of that fraction, so
+    // stepping to the next bit is a few integer adds and the n-th bit starts exactly at floor( n * samples_per_bit ), no matter
+    // how long the frame is. The offsets inside of a bit are precomputed in twelfths of a bit (halves, quarters and sixths).
+    //
+    // The carrier of a real reader deviates from 13.56 MHz by up to +-7 kHz, so a grid with the nominal bit length drifts away
+    // from the sequences of a long frame. Align() measures the position of an edge against the grid and pulls the grid towards
+    // it, phase and bit length (a second order loop, like a DLL). Every frame starts with the nominal bit length again, so the
+    // decoding of a frame does not depend on the frames before it. The edges it aligns to can also be handed to a
+    // CarrierCalibration, which measures the carrier once for all frames.
+    class BitGrid
+    {
+      public:
+        static const U32 SIXTH_BIT = 2;
+        static const U32 QUARTER_BIT = 3;
+        static const U32 HALF_BIT = 6;
+        static const U32 TWO_THIRD_BIT = 8;
+        static const U32 THREE_QUARTER_BIT = 9;
+        static const U32 ONE_BIT = 12;
+        static const U32 TWO_BITS = 24;
+
+        BitGrid();
+
+        void Setup( U32 sample_rate_hz, U32 carrier_hz, U32 carrier_cycles_per_bit );
+
+        // Places the first sequence at frame_start_sample.
+        void Start( U64 frame_start_sample )
+        {
+            mFrameStartSample = frame_start_sample;
+            mSeqCount = 0;
+            mSeqStartSample = frame_start_sample;
+            mRemainder = 0;
+            SetBitStep( mSampleRateCycles );
+        }
+
+        // The aligned edges are measured while the calibration is set, nullptr stops it.
+        void SetCalibration( CarrierCalibration* calibration )
+        {
+            mCalibration = calibration;
+        }
+
+        U64 GetSeqStartSample() const
+        {
+            return mSeqStartSample;
+        }
+
+        void NextSeq()
+        {
+            mSeqCount++;
+            mSeqStartSample += mBitQuotient;
+            mRemainder += mBitRemainder;
+            if( mRemainder >= mCarrierHz )
+            {
+                mRemainder -= mCarrierHz;
+                mSeqStartSample++;
+            }
+        }
+
+        // An edge that belongs to the given position (twelfths of a bit) of the last started sequence was seen at edge_sample.
+        // Edges more than a twelfth of a bit (at least two samples) away from their position are ignored, they are glitches or
+        // missing subcarrier periods and not drift.
+        void Align( U64 edge_sample, U32 twelfths );
+
+        // Samples from the start of a bit to the given number of twelfths of a bit (rounded down).
+        U64 GetOffset( U32 twelfths ) const
+        {
+            return mOffsets[ twelfths ];
+        }
+
+        // Only meant for deriving thresholds once per setup.
+        double GetSamplesPerBit() const;
+
+      protected:
+        void SetBitStep( U64 bit_step );
+
+        U64 mSampleRateCycles; // sample_rate_hz * carrier_cycles_per_bit, samples per bit = mSampleRateCycles / mCarrierHz
+        U64 mCarrierHz;
+        U64 mCarrierCyclesPerBit;
+
+        // the tracked bit length in 1 / mCarrierHz samples, mSampleRateCycles for the nominal carrier
+        U64 mBitStep;
+        U64 mBitQuotient;
+        U64 mBitRemainder;
+
+        U64 mFrameStartSample;
+        U64 mSeqCount; // started sequences of the frame
+        U64 mSeqStartSample;
+        U64 mRemainder;
+
+        CarrierCalibration* mCalibration;
+
+        U64 mOffsets[ TWO_BITS + 1 ];
+    };
+}
+
+#endif // ISO14443A_BIT_GRID
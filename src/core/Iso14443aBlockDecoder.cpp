@@ -0,0 +1,196 @@
+#include "Iso14443aBlockDecoder.h"
+
+namespace Iso14443a
+{
+    // PCB coding, b8 is the most significant bit
+    static const U8 PCB_I_BLOCK_MASK = 0xE2;
+    static const U8 PCB_I_BLOCK = 0x02;
+    static const U8 PCB_R_BLOCK_MASK = 0xE6;
+    static const U8 PCB_R_BLOCK = 0xA2;
+    static const U8 PCB_S_BLOCK_MASK = 0xC7;
+    static const U8 PCB_S_BLOCK = 0xC2;
+
+    static const U8 PCB_BLOCK_NUMBER = 0x01;
+    static const U8 PCB_NAD_FOLLOWING = 0x04;
+    static const U8 PCB_CID_FOLLOWING = 0x08;
+    static const U8 PCB_CHAINING = 0x10;
+    static const U8 PCB_R_NAK = 0x10;
+    static const U8 PCB_S_TYPE_MASK = 0x30;
+    static const U8 PCB_S_DESELECT = 0x00;
+    static const U8 PCB_S_WTX = 0x30;
+
+    static const U8 CID_MASK = 0x0F;
+    static const U8 WTXM_MASK = 0x3F;
+
+    // capacity of the reassembly buffers up front, enough for a short APDU
+    static const size_t INITIAL_APDU_CAPACITY = 512;
+
+    const char* GetBlockTypeString( BlockType type )
+    {
+        switch( type )
+        {
+        case BlockType::None:
+            return "NONE";
+        case BlockType::I:
+            return "I";
+        case BlockType::RAck:
+            return "R(ACK)";
+        case BlockType::RNak:
+            return "R(NAK)";
+        case BlockType::SDeselect:
+            return "S(DESELECT)";
+        case BlockType::SWtx:
+            return "S(WTX)";
+        };
+        return "";
+    }
+
+    BlockDecoder::BlockDecoder( ApduSink& sink ) : mSink( sink )
+    {
+        for( Chain& chain : mChains )
+        {
+            chain.data.reserve( INITIAL_APDU_CAPACITY );
+        }
+    }
+
+    void BlockDecoder::Reset()
+    {
+        for( Chain& chain : mChains )
+        {
+            chain.data.clear();
+            chain.block_count = 0;
+            chain.active = false;
+        }
+    }
+
+    bool BlockDecoder::ParseBlock( const DecodedFrame& frame, BlockInfo& info )
+    {
+        info = BlockInfo();
+
+        if( ( frame.error != DecodedFrame::Error::Ok ) || ( frame.crc != DecodedFrame::CrcStatus::Ok ) )
+        {
+            return false;
+        }
+
+        const U8* data = frame.data.data();
+        const U8* data_end = data + frame.data.size() - 2; // without CRC
+        U8 pcb = *data++;
+        info.pcb = pcb;
+
+        if( ( pcb & PCB_I_BLOCK_MASK ) == PCB_I_BLOCK )
+        {
+            info.type = BlockType::I;
+            info.block_number = pcb & PCB_BLOCK_NUMBER;
+            info.chaining = ( pcb & PCB_CHAINING ) != 0;
+        }
+        else if( ( pcb & PCB_R_BLOCK_MASK ) == PCB_R_BLOCK )
+        {
+            info.type = ( pcb & PCB_R_NAK ) ? BlockType::RNak : BlockType::RAck;
+            info.block_number = pcb & PCB_BLOCK_NUMBER;
+        }
+        else if( ( ( pcb & PCB_S_BLOCK_MASK ) == PCB_S_BLOCK ) && ( ( pcb & PCB_S_TYPE_MASK ) == PCB_S_DESELECT ) )
+        {
+            info.type = BlockType::SDeselect;
+        }
+        else if( ( ( pcb & PCB_S_BLOCK_MASK ) == PCB_S_BLOCK ) && ( ( pcb & PCB_S_TYPE_MASK ) == PCB_S_WTX ) )
+        {
+            info.type = BlockType::SWtx;
+        }
+        else
+        {
+            return false;
+        }
+
+        if( pcb & PCB_CID_FOLLOWING )
+        {
+            if( data == data_end )
+            {
+                return false;
+            }
+            info.has_cid = true;
+            info.cid = *data++ & CID_MASK;
+        }
+        if( ( info.type == BlockType::I ) && ( pcb & PCB_NAD_FOLLOWING ) )
+        {
+            if( data == data_end )
+            {
+                return false;
+            }
+            info.has_nad = true;
+            info.nad = *data++;
+        }
+
+        info.inf = data;
+        info.inf_length = size_t( data_end - data );
+
+        // R-blocks carry no INF, an S(WTX) exactly one byte
+        if( ( ( info.type == BlockType::RAck ) || ( info.type == BlockType::RNak ) ) && ( info.inf_length != 0 ) )
+        {
+            return false;
+        }
+        if( info.type == BlockType::SWtx )
+        {
+            if( info.inf_length != 1 )
+            {
+                return false;
+            }
+            info.wtxm = info.inf[ 0 ] & WTXM_MASK;
+        }
+        return true;
+    }
+
+    void BlockDecoder::AddIBlock( Chain& chain, const BlockInfo& info, bool is_response, U64 start_sample, U64 end_sample )
+    {
+        if( chain.active && ( chain.block_count > 0 ) && ( info.block_number == chain.last_block_number ) )
+        {
+            // the same block again, drop the copy received before
+            chain.data.resize( chain.last_block_offset );
+            chain.block_count--;
+        }
+        else if( !chain.active )
+        {
+            chain.data.clear();
+            chain.block_count = 0;
+            chain.start_sample = start_sample;
+            chain.active = true;
+        }
+
+        chain.last_block_offset = chain.data.size();
+        chain.last_block_number = info.block_number;
+        chain.data.insert( chain.data.end(), info.inf, info.inf + info.inf_length );
+        chain.block_count++;
+
+        if( !info.chaining )
+        {
+            mSink.OnApdu( is_response, chain.data.data(), chain.data.size(), chain.block_count, chain.start_sample, end_sample );
+            chain.active = false;
+        }
+    }
+
+    bool BlockDecoder::DecodeBlock( const DecodedFrame& frame, bool is_response, U64 start_sample, U64 end_sample, BlockInfo& info )
+    {
+        if( !ParseBlock( frame, info ) )
+        {
+            return false;
+        }
+
+        Chain& chain = mChains[ is_response ? 1 : 0 ];
+        Chain& other_chain = mChains[ is_response ? 0 : 1 ];
+
+        switch( info.type )
+        {
+        case BlockType::I:
+            // an I-block is only sent once the other side has finished its chain, an unfinished one was aborted
+            other_chain.active = false;
+            AddIBlock( chain, info, is_response, start_sample, end_sample );
+            break;
+        case BlockType::SDeselect:
+            chain.active = false;
+            other_chain.active = false;
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+}
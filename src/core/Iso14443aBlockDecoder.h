@@ -0,0 +1,92 @@
+#ifndef ISO14443A_BLOCK_DECODER
+#define ISO14443A_BLOCK_DECODER
+
+#include <cstddef>
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // ISO14443-4 block types
+    enum class BlockType
+    {
+        None = 0,
+        I,
+        RAck,
+        RNak,
+        SDeselect,
+        SWtx,
+    };
+    static const U32 BLOCK_TYPE_COUNT = 6;
+
+    const char* GetBlockTypeString( BlockType type );
+
+    // Fields of a single block. inf points into the frame data and is only valid as long as the frame is.
+    struct BlockInfo
+    {
+        BlockType type{ BlockType::None };
+        U8 pcb{ 0U };
+        U8 block_number{ 0U }; // I- and R-blocks
+        bool chaining{ false }; // I-block, more blocks of the same APDU follow
+        bool has_cid{ false };
+        U8 cid{ 0U };
+        bool has_nad{ false }; // I-block
+        U8 nad{ 0U };
+        U8 wtxm{ 0U }; // S(WTX), waiting time extension multiplier
+        const U8* inf{ nullptr };
+        size_t inf_length{ 0U };
+    };
+
+    // Receives the APDUs reassembled from chained I-blocks. The data is only valid during the call. The sample range spans all
+    // blocks of the APDU (inclusive).
+    class ApduSink
+    {
+      public:
+        virtual ~ApduSink()
+        {
+        }
+
+        virtual void OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample )
+        {
+        }
+    };
+
+    // Decodes the ISO14443-4 blocks of both directions, frame by frame in the order they were sent, and reassembles chained
+    // I-blocks into APDUs. Only frames with a correct CRC_A are taken as blocks. A repeated I-block (after an R(NAK) or a
+    // timeout) replaces the copy received before. The chained data is collected in one buffer per direction that keeps its
+    // memory, so after the first long APDU the reassembly does not allocate any more.
+    class BlockDecoder
+    {
+      public:
+        BlockDecoder( ApduSink& sink );
+
+        void Reset();
+
+        // Returns false if the frame is not an ISO14443-4 block.
+        bool DecodeBlock( const DecodedFrame& frame, bool is_response, U64 start_sample, U64 end_sample, BlockInfo& info );
+
+        // True while the APDU of either direction is unfinished, more blocks of it will follow.
+        bool IsChaining() const
+        {
+            return mChains[ 0 ].active || mChains[ 1 ].active;
+        }
+
+      protected:
+        struct Chain
+        {
+            std::vector<U8> data;
+            size_t last_block_offset{ 0U }; // start of the INF of the last I-block, to replace it on a retransmission
+            U8 last_block_number{ 0U };
+            U32 block_count{ 0U };
+            U64 start_sample{ 0U };
+            bool active{ false };
+        };
+
+        static bool ParseBlock( const DecodedFrame& frame, BlockInfo& info );
+        void AddIBlock( Chain& chain, const BlockInfo& info, bool is_response, U64 start_sample, U64 end_sample );
+
+        ApduSink& mSink;
+        Chain mChains[ 2 ]; // PCD, PICC
+    };
+}
+
+#endif // ISO14443A_BLOCK_DECODER
@@ -0,0 +1,144 @@
+#include "Iso14443aBufferedWriter.h"
+#include <cstring>
+
+namespace Iso14443a
+{
+    static const size_t WRITE_BUFFER_SIZE = 4 << 20;
+
+    BufferedWriter::BufferedWriter() : mBufferLength( 0 ), mBytesWritten( 0 ), mFailed( false )
+    {
+    }
+
+    BufferedWriter::~BufferedWriter()
+    {
+        Close();
+    }
+
+    bool BufferedWriter::Open( const char* file_name )
+    {
+        mFile.open( file_name, std::ios::out | std::ios::binary | std::ios::trunc );
+        mBuffer.resize( WRITE_BUFFER_SIZE );
+        mBufferLength = 0;
+        mBytesWritten = 0;
+        mFailed = !mFile;
+        return !mFailed;
+    }
+
+    bool BufferedWriter::Close()
+    {
+        if( !mFile.is_open() )
+        {
+            return !mFailed;
+        }
+
+        Flush();
+        mFile.close();
+        mFailed |= mFile.fail();
+        return !mFailed;
+    }
+
+    U8* BufferedWriter::Reserve( size_t length )
+    {
+        if( mBufferLength + length > mBuffer.size() )
+        {
+            Flush();
+            if( length > mBuffer.size() )
+            {
+                mBuffer.resize( length );
+            }
+        }
+        U8* out = &mBuffer[ mBufferLength ];
+        mBufferLength += length;
+        return out;
+    }
+
+    void BufferedWriter::Flush()
+    {
+        if( mBufferLength > 0 )
+        {
+            mFile.write( reinterpret_cast<const char*>( mBuffer.data() ), std::streamsize( mBufferLength ) );
+            mFailed |= mFile.fail();
+            mBytesWritten += mBufferLength;
+            mBufferLength = 0;
+        }
+    }
+
+    void BufferedWriter::Append( const void* data, size_t length )
+    {
+        if( length > 0 )
+        {
+            memcpy( Reserve( length ), data, length );
+        }
+    }
+
+    void BufferedWriter::AppendString( const char* string )
+    {
+        Append( string, strlen( string ) );
+    }
+
+    void BufferedWriter::AppendDecimal( U64 value )
+    {
+        char digits[ 20 ];
+        U32 count = 0;
+        do
+        {
+            digits[ count++ ] = char( '0' + value % 10 );
+            value /= 10;
+        } while( value > 0 );
+
+        U8* out = Reserve( count );
+        while( count > 0 )
+        {
+            *out++ = U8( digits[ --count ] );
+        }
+    }
+
+    void BufferedWriter::AppendHex( U64 value, U32 digits )
+    {
+        static const char hex_digits[] = "0123456789ABCDEF";
+        while( ( digits < 16 ) && ( ( value >> ( digits * 4 ) ) != 0 ) )
+        {
+            digits++;
+        }
+
+        U8* out = Reserve( digits );
+        for( U32 i = 0; i < digits; i++ )
+        {
+            out[ i ] = U8( hex_digits[ ( value >> ( ( digits - 1 - i ) * 4 ) ) & 0xF ] );
+        }
+    }
+
+    void BufferedWriter::AppendBinary( U64 value, U32 bits )
+    {
+        U8* out = Reserve( bits );
+        for( U32 i = 0; i < bits; i++ )
+        {
+            out[ i ] = ( ( value >> ( bits - 1 - i ) ) & 1 ) ? '1' : '0';
+        }
+    }
+
+    void BufferedWriter::AppendSeconds( S64 samples, U32 sample_rate_hz )
+    {
+        if( sample_rate_hz == 0 )
+        {
+            sample_rate_hz = 1;
+        }
+        if( samples < 0 )
+        {
+            AppendChar( '-' );
+            samples = -samples;
+        }
+
+        U64 magnitude = U64( samples );
+        AppendDecimal( magnitude / sample_rate_hz );
+        AppendChar( '.' );
+
+        U64 ns = ( ( magnitude % sample_rate_hz ) * 1000000000ULL ) / sample_rate_hz;
+        U8* out = Reserve( 9 );
+        for( S32 i = 8; i >= 0; i-- )
+        {
+            out[ i ] = U8( '0' + ns % 10 );
+            ns /= 10;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef ISO14443A_BUFFERED_WRITER
+#define ISO14443A_BUFFERED_WRITER
+
+#include <cstddef>
+#include <fstream>
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Output file behind all exports. Everything is formatted straight into a large buffer, which is written in few big chunks,
+    // so an export neither flushes nor allocates per row.
+    class BufferedWriter
+    {
+      public:
+        BufferedWriter();
+        ~BufferedWriter();
+
+        bool Open( const char* file_name );
+        // Flushes the buffer, returns false if anything could not be written.
+        bool Close();
+        bool IsOpen() const
+        {
+            return mFile.is_open();
+        }
+
+        // Space for length bytes, valid until the next call.
+        U8* Reserve( size_t length );
+
+        void Append( const void* data, size_t length );
+        void AppendChar( char c )
+        {
+            *Reserve( 1 ) = U8( c );
+        }
+        void AppendString( const char* string );
+        void AppendDecimal( U64 value );
+        // upper case, zero padded to digits
+        void AppendHex( U64 value, U32 digits );
+        void AppendBinary( U64 value, U32 bits );
+        // the time of a sample offset in seconds, with ns resolution
+        void AppendSeconds( S64 samples, U32 sample_rate_hz );
+
+        U64 GetBytesWritten() const
+        {
+            return mBytesWritten + mBufferLength;
+        }
+
+      protected:
+        void Flush();
+
+        std::ofstream mFile;
+        std::vector<U8> mBuffer;
+        size_t mBufferLength;
+        U64 mBytesWritten;
+        bool mFailed;
+    };
+}
+
+#endif // ISO14443A_BUFFERED_WRITER
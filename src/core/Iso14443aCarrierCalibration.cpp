@@ -0,0 +1,88 @@
+#include "Iso14443aCarrierCalibration.h"
+#include <cmath>
+
+namespace Iso14443a
+{
+    CarrierCalibration::CarrierCalibration()
+        : mSampleRateHz( 0 ),
+          mCarrierHz( 0 ),
+          mFramesLeft( 0 ),
+          mFrameEdges( 0 ),
+          mSumX( 0.0 ),
+          mSumY( 0.0 ),
+          mSumXX( 0.0 ),
+          mSumXY( 0.0 ),
+          mEdges( 0 ),
+          mSxx( 0.0 ),
+          mSxy( 0.0 )
+    {
+    }
+
+    void CarrierCalibration::Setup( U32 sample_rate_hz, U32 carrier_hz, U32 frame_count )
+    {
+        mSampleRateHz = sample_rate_hz;
+        mCarrierHz = carrier_hz;
+        mFramesLeft = frame_count;
+        mEdges = 0;
+        mSxx = 0.0;
+        mSxy = 0.0;
+        StartFrame();
+    }
+
+    void CarrierCalibration::StartFrame()
+    {
+        mFrameEdges = 0;
+        mSumX = 0.0;
+        mSumY = 0.0;
+        mSumXX = 0.0;
+        mSumXY = 0.0;
+    }
+
+    void CarrierCalibration::AddEdge( U64 carrier_twelfths, U64 edge_offset )
+    {
+        double x = double( carrier_twelfths );
+        double y = double( edge_offset );
+        mFrameEdges++;
+        mSumX += x;
+        mSumY += y;
+        mSumXX += x * x;
+        mSumXY += x * y;
+    }
+
+    bool CarrierCalibration::EndFrame( bool valid )
+    {
+        if( !IsMeasuring() )
+        {
+            return false;
+        }
+
+        // a frame with a single edge says nothing about the slope
+        if( valid && ( mFrameEdges > 1 ) )
+        {
+            double n = double( mFrameEdges );
+            mSxx += mSumXX - mSumX * mSumX / n;
+            mSxy += mSumXY - mSumX * mSumY / n;
+            mEdges += mFrameEdges;
+            mFramesLeft--;
+        }
+        StartFrame();
+        return mFramesLeft == 0;
+    }
+
+    U32 CarrierCalibration::GetCarrierHz() const
+    {
+        if( ( mEdges < MIN_EDGES ) || ( mSxx <= 0.0 ) || ( mSxy <= 0.0 ) )
+        {
+            return 0;
+        }
+
+        // the slope is in samples per twelfth of a carrier cycle
+        double samples_per_cycle = 12.0 * mSxy / mSxx;
+        double carrier_hz = mSampleRateHz / samples_per_cycle;
+        if( std::fabs( carrier_hz - mCarrierHz ) * 1e6 > double( mCarrierHz ) * MAX_DEVIATION_PPM )
+        {
+            return 0;
+        }
+        return U32( std::floor( carrier_hz + 0.5 ) );
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef ISO14443A_CARRIER_CALIBRATION
+#define ISO14443A_CARRIER_CALIBRATION
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Measures the carrier of a reader from the first frames of a capture. Every edge the bit grid aligns to is a point (nominal
+    // position in carrier cycles since the start of the frame, samples since the start of the frame), a least squares fit over
+    // all points gives the samples per carrier cycle. Each frame has its own start, so only the slopes of the frames are pooled.
+    // Frames with errors are left out, their positions on the grid are not trustworthy.
+    class CarrierCalibration
+    {
+      public:
+        // a fit needs enough edges to average the quantization of the sample clock
+        static const U64 MIN_EDGES = 64;
+        // further off than 1 % the configured carrier is wrong or the frames were not decoded right, it is not calibrated
+        static const U32 MAX_DEVIATION_PPM = 10000;
+
+        CarrierCalibration();
+
+        // Measures the next frame_count frames without errors, 0 disables the calibration. The bit grids are set up for
+        // carrier_hz until then.
+        void Setup( U32 sample_rate_hz, U32 carrier_hz, U32 frame_count );
+
+        bool IsMeasuring() const
+        {
+            return mFramesLeft > 0;
+        }
+
+        void StartFrame();
+
+        // An edge edge_offset samples after the start of the frame, where the grid expects it after carrier_twelfths / 12
+        // carrier cycles.
+        void AddEdge( U64 carrier_twelfths, U64 edge_offset );
+
+        // Pools the frame into the fit. Returns true if it was the last frame to measure.
+        bool EndFrame( bool valid );
+
+        // The measured carrier, 0 if there were not enough edges or it is too far off.
+        U32 GetCarrierHz() const;
+
+      protected:
+        U32 mSampleRateHz;
+        U32 mCarrierHz;
+        U32 mFramesLeft;
+
+        // sums of the current frame
+        U64 mFrameEdges;
+        double mSumX;
+        double mSumY;
+        double mSumXX;
+        double mSumXY;
+
+        // centered per frame and pooled over the measured frames
+        U64 mEdges;
+        double mSxx;
+        double mSxy;
+    };
+}
+
+#endif // ISO14443A_CARRIER_CALIBRATION
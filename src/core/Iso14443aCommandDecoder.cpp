@@ -0,0 +1,315 @@
+#include "Iso14443aCommandDecoder.h"
+
+namespace Iso14443a
+{
+    static const U8 CMD_REQA = 0x26;
+    static const U8 CMD_WUPA = 0x52;
+    static const U8 CMD_SEL_CL1 = 0x93;
+    static const U8 CMD_SEL_CL2 = 0x95;
+    static const U8 CMD_SEL_CL3 = 0x97;
+    static const U8 CMD_HLTA = 0x50;
+    static const U8 CMD_RATS = 0xE0;
+    static const U8 CMD_PPS_MASK = 0xF0;
+    static const U8 CMD_PPS = 0xD0;
+
+    static const U8 NVB_SELECT = 0x70;
+    static const U8 CASCADE_TAG = 0x88;
+    static const U8 SAK_CASCADE_BIT = 0x04;
+
+    static const U8 PCB_S_BLOCK_MASK = 0xC7;
+    static const U8 PCB_S_BLOCK = 0xC2;
+    static const U8 PCB_S_TYPE_MASK = 0x30;
+    static const U8 PCB_S_DESELECT = 0x00;
+    static const U8 PCB_CID_FOLLOWING = 0x08;
+
+    const char* GetCommandTypeString( CommandType type )
+    {
+        switch( type )
+        {
+        case CommandType::Unknown:
+            return "UNKNOWN";
+        case CommandType::Reqa:
+            return "REQA";
+        case CommandType::Wupa:
+            return "WUPA";
+        case CommandType::Anticollision:
+            return "ANTICOLLISION";
+        case CommandType::Select:
+            return "SELECT";
+        case CommandType::Hlta:
+            return "HLTA";
+        case CommandType::Rats:
+            return "RATS";
+        case CommandType::Pps:
+            return "PPS";
+        case CommandType::Atqa:
+            return "ATQA";
+        case CommandType::Uid:
+            return "UID";
+        case CommandType::Sak:
+            return "SAK";
+        case CommandType::Ats:
+            return "ATS";
+        case CommandType::PpsResponse:
+            return "PPS_RESPONSE";
+        };
+        return "";
+    }
+
+    // 1..3 for the SEL codes of the cascade levels, 0 otherwise
+    static U8 GetCascadeLevelOfSel( U8 sel )
+    {
+        switch( sel )
+        {
+        case CMD_SEL_CL1:
+            return 1;
+        case CMD_SEL_CL2:
+            return 2;
+        case CMD_SEL_CL3:
+            return 3;
+        }
+        return 0;
+    }
+
+    static bool IsCompleteFrame( const DecodedFrame& frame, U32 length )
+    {
+        return ( frame.data.size() == length ) && ( frame.data_valid_bits_in_last_byte == 8 );
+    }
+
+    static bool HasValidBcc( const U8* uid_cln )
+    {
+        return ( uid_cln[ 0 ] ^ uid_cln[ 1 ] ^ uid_cln[ 2 ] ^ uid_cln[ 3 ] ) == uid_cln[ 4 ];
+    }
+
+    // S(DESELECT) with an optional CID, the PICC answers with the same block before it halts
+    static bool IsDeselectBlock( const DecodedFrame& frame )
+    {
+        const std::vector<U8>& data = frame.data;
+        U8 pcb = data[ 0 ];
+        U32 length = ( pcb & PCB_CID_FOLLOWING ) ? 4 : 3;
+        return ( ( pcb & PCB_S_BLOCK_MASK ) == PCB_S_BLOCK ) && ( ( pcb & PCB_S_TYPE_MASK ) == PCB_S_DESELECT ) &&
+               IsCompleteFrame( frame, length ) && ( frame.crc == DecodedFrame::CrcStatus::Ok );
+    }
+
+    CommandDecoder::CommandDecoder()
+    {
+        Reset();
+    }
+
+    void CommandDecoder::Reset()
+    {
+        mState = State::Idle;
+        mLastCommand = CommandType::Unknown;
+        mCommandSeen = false;
+        mCascadeLevel = 0;
+        mNextCascadeLevel = 1;
+        mUidLength = 0;
+        mUidComplete = false;
+    }
+
+    void CommandDecoder::StartActivation()
+    {
+        mState = State::Anticollision;
+        mCascadeLevel = 0;
+        mNextCascadeLevel = 1;
+        mUidLength = 0;
+        mUidComplete = false;
+    }
+
+    void CommandDecoder::SetUidPart( U8 cascade_level, const U8* uid_cln )
+    {
+        // every cascade level before the last one starts with the cascade tag and adds three UID bytes
+        U8 offset = U8( 3 * ( cascade_level - 1 ) );
+        if( uid_cln[ 0 ] == CASCADE_TAG )
+        {
+            for( U32 i = 0; i < 3; i++ )
+            {
+                mUid[ offset + i ] = uid_cln[ i + 1 ];
+            }
+            mUidLength = U8( offset + 3 );
+        }
+        else
+        {
+            for( U32 i = 0; i < 4; i++ )
+            {
+                mUid[ offset + i ] = uid_cln[ i ];
+            }
+            mUidLength = U8( offset + 4 );
+        }
+        mCascadeLevel = cascade_level;
+        mUidComplete = false;
+    }
+
+    void CommandDecoder::ReceiveSak( U8 sak )
+    {
+        if( ( sak & SAK_CASCADE_BIT ) && ( mCascadeLevel < 3 ) )
+        {
+            mNextCascadeLevel = U8( mCascadeLevel + 1 );
+            mState = State::Anticollision;
+            return;
+        }
+
+        mUidComplete = true;
+        mState = State::Selected;
+    }
+
+    CommandType CommandDecoder::DecodeCommand( const DecodedFrame& frame )
+    {
+        mLastCommand = CommandType::Unknown;
+        mCommandSeen = true;
+
+        const std::vector<U8>& data = frame.data;
+        if( ( frame.error != DecodedFrame::Error::Ok ) || data.empty() )
+        {
+            return CommandType::Unknown;
+        }
+
+        // short frame
+        if( ( data.size() == 1 ) && ( frame.data_valid_bits_in_last_byte == 7 ) )
+        {
+            if( data[ 0 ] == CMD_REQA )
+            {
+                mLastCommand = CommandType::Reqa;
+            }
+            else if( data[ 0 ] == CMD_WUPA )
+            {
+                mLastCommand = CommandType::Wupa;
+            }
+            if( mLastCommand != CommandType::Unknown )
+            {
+                StartActivation();
+            }
+            return mLastCommand;
+        }
+
+        U8 cascade_level = GetCascadeLevelOfSel( data[ 0 ] );
+        if( ( cascade_level != 0 ) && ( data.size() >= 2 ) && ( mState != State::Active ) )
+        {
+            if( ( data[ 1 ] == NVB_SELECT ) && IsCompleteFrame( frame, 9 ) && HasValidBcc( &data[ 2 ] ) )
+            {
+                SetUidPart( cascade_level, &data[ 2 ] );
+                mLastCommand = CommandType::Select;
+            }
+            else
+            {
+                mCascadeLevel = cascade_level;
+                mLastCommand = CommandType::Anticollision;
+            }
+            mNextCascadeLevel = cascade_level;
+            mState = State::Anticollision;
+            return mLastCommand;
+        }
+
+        if( ( data[ 0 ] == CMD_HLTA ) && IsCompleteFrame( frame, 4 ) && ( data[ 1 ] == 0x00 ) )
+        {
+            mState = State::Idle;
+            mLastCommand = CommandType::Hlta;
+        }
+        else if( ( data[ 0 ] == CMD_RATS ) && IsCompleteFrame( frame, 4 ) && ( frame.crc == DecodedFrame::CrcStatus::Ok ) &&
+                 ( ( mState == State::Selected ) || ( mState == State::Anticollision ) ) )
+        {
+            // without the PICC channel the SAK is not known, so the RATS may follow the SELECT directly
+            mLastCommand = CommandType::Rats;
+        }
+        else if( ( ( data[ 0 ] & CMD_PPS_MASK ) == CMD_PPS ) && ( data.size() >= 4 ) && ( mState == State::Active ) &&
+                 ( frame.crc == DecodedFrame::CrcStatus::Ok ) )
+        {
+            // a PPS is only allowed right after the ATS, later on 0xDx is an S(DESELECT) or S(WTX) block
+            mLastCommand = CommandType::Pps;
+        }
+        return mLastCommand;
+    }
+
+    CommandType CommandDecoder::DecodeResponse( const DecodedFrame& frame )
+    {
+        CommandType command = mLastCommand;
+        mLastCommand = CommandType::Unknown;
+
+        const std::vector<U8>& data = frame.data;
+        if( ( frame.error != DecodedFrame::Error::Ok ) || data.empty() )
+        {
+            return CommandType::Unknown;
+        }
+
+        // without the command the response is recognized by its shape, as long as the PICC is not activated yet
+        if( ( command == CommandType::Unknown ) && ( mState != State::Active ) )
+        {
+            if( IsCompleteFrame( frame, 2 ) && ( frame.crc == DecodedFrame::CrcStatus::NotPresent ) )
+            {
+                command = CommandType::Reqa;
+            }
+            else if( IsCompleteFrame( frame, 5 ) && HasValidBcc( &data[ 0 ] ) )
+            {
+                command = CommandType::Select;
+            }
+            else if( IsCompleteFrame( frame, 3 ) && ( frame.crc == DecodedFrame::CrcStatus::Ok ) && ( mState == State::Anticollision ) )
+            {
+                command = CommandType::Select;
+            }
+            else if( ( frame.crc == DecodedFrame::CrcStatus::Ok ) && ( mState == State::Selected ) && ( data[ 0 ] + 2U == data.size() ) )
+            {
+                command = CommandType::Rats;
+            }
+        }
+        else if( ( command == CommandType::Unknown ) && !mCommandSeen )
+        {
+            // no block is shorter than 3 bytes, so this is the ATQA of the next activation
+            if( IsCompleteFrame( frame, 2 ) && ( frame.crc == DecodedFrame::CrcStatus::NotPresent ) )
+            {
+                command = CommandType::Reqa;
+            }
+            else if( IsDeselectBlock( frame ) )
+            {
+                // the PICC halts, the block itself is labelled by the block decoder
+                mState = State::Idle;
+                return CommandType::Unknown;
+            }
+        }
+
+        switch( command )
+        {
+        case CommandType::Reqa:
+        case CommandType::Wupa:
+            if( IsCompleteFrame( frame, 2 ) )
+            {
+                StartActivation();
+                return CommandType::Atqa;
+            }
+            break;
+        case CommandType::Anticollision:
+        case CommandType::Select:
+            if( IsCompleteFrame( frame, 5 ) && HasValidBcc( &data[ 0 ] ) )
+            {
+                SetUidPart( mNextCascadeLevel, &data[ 0 ] );
+                return CommandType::Uid;
+            }
+            if( ( data.size() < 5 ) && ( command == CommandType::Anticollision ) )
+            {
+                // the rest of a UID after a bit oriented anticollision frame
+                return CommandType::Uid;
+            }
+            if( IsCompleteFrame( frame, 3 ) && ( frame.crc == DecodedFrame::CrcStatus::Ok ) )
+            {
+                ReceiveSak( data[ 0 ] );
+                return CommandType::Sak;
+            }
+            break;
+        case CommandType::Rats:
+            if( frame.crc == DecodedFrame::CrcStatus::Ok )
+            {
+                mState = State::Active;
+                return CommandType::Ats;
+            }
+            break;
+        case CommandType::Pps:
+            if( IsCompleteFrame( frame, 3 ) && ( frame.crc == DecodedFrame::CrcStatus::Ok ) )
+            {
+                return CommandType::PpsResponse;
+            }
+            break;
+        default:
+            break;
+        }
+        return CommandType::Unknown;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef ISO14443A_COMMAND_DECODER
+#define ISO14443A_COMMAND_DECODER
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // ISO14443-3 commands of the PCD and the matching responses of the PICC
+    enum class CommandType
+    {
+        Unknown = 0,
+        Reqa,
+        Wupa,
+        Anticollision,
+        Select,
+        Hlta,
+        Rats,
+        Pps,
+        Atqa,
+        Uid,
+        Sak,
+        Ats,
+        PpsResponse,
+    };
+    static const U32 COMMAND_TYPE_COUNT = 13;
+
+    const char* GetCommandTypeString( CommandType type );
+
+    // Follows the activation of a PICC (REQA/WUPA, anticollision and SELECT per cascade level, RATS) frame by frame and keeps the
+    // UID collected so far. PCD frames are passed to DecodeCommand() and PICC frames to DecodeResponse(), in the order they were
+    // sent. A response is interpreted by the command before it; if the command is not known (e.g. only the PICC channel is
+    // decoded) the response is recognized by its length, BCC and CRC instead. With only the PICC channel the DESELECT or HLTA
+    // that ends an activation is never seen, so a response that cannot be a block (an ATQA or the answer to S(DESELECT))
+    // ends it there.
+    class CommandDecoder
+    {
+      public:
+        CommandDecoder();
+
+        void Reset();
+
+        CommandType DecodeCommand( const DecodedFrame& frame );
+        CommandType DecodeResponse( const DecodedFrame& frame );
+
+        // True if the next response may be a UID CLn, which carries a BCC instead of a CRC: after an anticollision command (NVB
+        // below 0x70), or while only responses were decoded and the PICC is not activated yet.
+        bool IsUidResponseExpected() const
+        {
+            return ( mLastCommand == CommandType::Anticollision ) || ( !mCommandSeen && ( mState != State::Active ) );
+        }
+
+        // cascade level of the last anticollision or SELECT (1..3), 0 before the first one
+        U8 GetCascadeLevel() const
+        {
+            return mCascadeLevel;
+        }
+
+        // UID bytes known so far (without cascade tags), complete after a SAK without the cascade bit
+        const U8* GetUid() const
+        {
+            return mUid;
+        }
+        U8 GetUidLength() const
+        {
+            return mUidLength;
+        }
+        bool IsUidComplete() const
+        {
+            return mUidComplete;
+        }
+
+      protected:
+        enum class State
+        {
+            Idle,
+            Anticollision,
+            Selected,
+            Active,
+        };
+
+        void StartActivation();
+        void SetUidPart( U8 cascade_level, const U8* uid_cln );
+        void ReceiveSak( U8 sak );
+
+        State mState;
+        CommandType mLastCommand;
+        bool mCommandSeen; // false while only responses were decoded since Reset()
+
+        U8 mCascadeLevel;
+        U8 mNextCascadeLevel; // level of the next UID CLn, if the response is not preceded by its command
+        U8 mUid[ 10 ];
+        U8 mUidLength;
+        bool mUidComplete;
+    };
+}
+
+#endif // ISO14443A_COMMAND_DECODER
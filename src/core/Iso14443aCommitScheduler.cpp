@@ -0,0 +1,18 @@
+#include "Iso14443aCommitScheduler.h"
+
+namespace Iso14443a
+{
+    CommitScheduler::CommitScheduler()
+        : mMaxPendingSamples( 0 ), mMaxPendingFrames( 1 ), mPendingFrames( 0 ), mLastCommitSample( 0 ), mCommitCount( 0 )
+    {
+    }
+
+    void CommitScheduler::Setup( U64 max_pending_samples, U32 max_pending_frames )
+    {
+        mMaxPendingSamples = max_pending_samples;
+        mMaxPendingFrames = max_pending_frames;
+        mPendingFrames = 0;
+        mLastCommitSample = 0;
+        mCommitCount = 0;
+    }
+}
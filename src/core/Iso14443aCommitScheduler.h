@@ -0,0 +1,58 @@
+#ifndef ISO14443A_COMMIT_SCHEDULER
+#define ISO14443A_COMMIT_SCHEDULER
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Decides when added results are committed. Committing (and reporting progress) after every single sequence or byte costs
+    // more than decoding it, so results are batched until either a number of frames or a stretch of signal is pending.
+    // Pending results are always committed at the end of a frame, so a finished frame shows up immediately.
+    class CommitScheduler
+    {
+      public:
+        CommitScheduler();
+
+        void Setup( U64 max_pending_samples, U32 max_pending_frames );
+
+        // Returns true if the results have to be committed after adding this frame.
+        bool AddFrame( U64 end_sample )
+        {
+            mPendingFrames++;
+            if( ( mPendingFrames >= mMaxPendingFrames ) || ( end_sample - mLastCommitSample >= mMaxPendingSamples ) )
+            {
+                Committed( end_sample );
+                return true;
+            }
+            return false;
+        }
+
+        // The results are committed at the end of every frame.
+        void Flush( U64 end_sample )
+        {
+            Committed( end_sample );
+        }
+
+        U64 GetCommitCount() const
+        {
+            return mCommitCount;
+        }
+
+      protected:
+        void Committed( U64 end_sample )
+        {
+            mPendingFrames = 0;
+            mLastCommitSample = end_sample;
+            mCommitCount++;
+        }
+
+        U64 mMaxPendingSamples;
+        U32 mMaxPendingFrames;
+
+        U32 mPendingFrames;
+        U64 mLastCommitSample;
+        U64 mCommitCount;
+    };
+}
+
+#endif // ISO14443A_COMMIT_SCHEDULER
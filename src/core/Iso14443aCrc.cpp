@@ -0,0 +1,91 @@
+#include "Iso14443aCrc.h"
+
+namespace Iso14443a
+{
+    namespace
+    {
+        // mTable[ 0 ] is the usual byte wise table, mTable[ n ] advances a byte that is followed by n more bytes
+        struct CrcATables
+        {
+            U16 mTable[ 4 ][ 256 ];
+
+            CrcATables()
+            {
+                for( U32 i = 0; i < 256; i++ )
+                {
+                    U16 crc = U16( i );
+                    for( U32 bit = 0; bit < 8; bit++ )
+                    {
+                        crc = ( crc & 1 ) ? U16( ( crc >> 1 ) ^ 0x8408 ) : U16( crc >> 1 );
+                    }
+                    mTable[ 0 ][ i ] = crc;
+                }
+                for( U32 i = 0; i < 256; i++ )
+                {
+                    for( U32 slice = 1; slice < 4; slice++ )
+                    {
+                        U16 crc = mTable[ slice - 1 ][ i ];
+                        mTable[ slice ][ i ] = U16( ( crc >> 8 ) ^ mTable[ 0 ][ crc & 0xFF ] );
+                    }
+                }
+            }
+        };
+
+        const CrcATables crc_a_tables;
+    }
+
+    U16 UpdateCrcA( U16 crc, const U8* data, size_t length )
+    {
+        const U16( *table )[ 256 ] = crc_a_tables.mTable;
+
+        while( length >= 4 )
+        {
+            // the 16 bit register covers the first two bytes, the other two only shift in
+            crc = U16( table[ 3 ][ ( data[ 0 ] ^ crc ) & 0xFF ] ^ table[ 2 ][ ( data[ 1 ] ^ ( crc >> 8 ) ) & 0xFF ] ^
+                       table[ 1 ][ data[ 2 ] ] ^ table[ 0 ][ data[ 3 ] ] );
+            data += 4;
+            length -= 4;
+        }
+        while( length > 0 )
+        {
+            crc = U16( ( crc >> 8 ) ^ table[ 0 ][ ( crc ^ *data ) & 0xFF ] );
+            data++;
+            length--;
+        }
+        return crc;
+    }
+
+    void CheckCrcA( DecodedFrame& frame, bool uid_response_expected )
+    {
+        frame.crc = DecodedFrame::CrcStatus::NotPresent;
+
+        const std::vector<U8>& data = frame.data;
+        size_t length = data.size();
+
+        // at least one data byte and the CRC, all of them complete
+        if( ( length < 3 ) || ( frame.data_valid_bits_in_last_byte != 8 ) )
+        {
+            return;
+        }
+
+        if( UpdateCrcA( CRC_A_PRESET, data.data(), length ) == 0 )
+        {
+            frame.crc = DecodedFrame::CrcStatus::Ok;
+            return;
+        }
+
+        // SEL command of the anticollision loop, only the SELECT itself (NVB = 0x70) ends with a CRC
+        if( ( ( data[ 0 ] == 0x93 ) || ( data[ 0 ] == 0x95 ) || ( data[ 0 ] == 0x97 ) ) && ( data[ 1 ] != 0x70 ) )
+        {
+            return;
+        }
+
+        // UID CLn response, four UID bytes and their BCC
+        if( uid_response_expected && ( length == 5 ) && ( ( data[ 0 ] ^ data[ 1 ] ^ data[ 2 ] ^ data[ 3 ] ) == data[ 4 ] ) )
+        {
+            return;
+        }
+
+        frame.crc = DecodedFrame::CrcStatus::Wrong;
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef ISO14443A_CRC
+#define ISO14443A_CRC
+
+#include <cstddef>
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // CRC_A of ISO14443-3 (polynomial x^16 + x^12 + x^5 + 1, LSB first, preset 0x6363). The CRC is sent LSB first after the data,
+    // so the CRC over data and CRC is zero for an intact frame.
+    static const U16 CRC_A_PRESET = 0x6363;
+
+    // Table driven kernel, four bytes per step (slice-by-4) with a byte wise tail.
+    U16 UpdateCrcA( U16 crc, const U8* data, size_t length );
+
+    inline U16 CalculateCrcA( const U8* data, size_t length )
+    {
+        return UpdateCrcA( CRC_A_PRESET, data, length );
+    }
+
+    // Checks the CRC_A at the end of a decoded frame and sets frame.crc. Frames that carry no CRC are left at NotPresent: short
+    // frames, bit oriented frames and the anticollision commands (NVB below 0x70). A UID CLn (four UID bytes and their BCC) is
+    // only taken as a frame without CRC if the command decoding expects one (see CommandDecoder::IsUidResponseExpected()).
+    void CheckCrcA( DecodedFrame& frame, bool uid_response_expected );
+}
+
+#endif // ISO14443A_CRC
@@ -0,0 +1,57 @@
+#ifndef ISO14443A_DECODER_SINK
+#define ISO14443A_DECODER_SINK
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    enum class MarkerType
+    {
+        SequenceStart,
+        SamplingPoint,
+        Error,
+    };
+
+    // Each level includes the markers of the levels before it
+    enum class MarkerDetail
+    {
+        None,
+        Errors,
+        SequenceStarts,
+        SamplingPoints,
+    };
+
+    // Receives everything a decoder finds. All sample ranges are inclusive and are reported in ascending order.
+    class DecoderSink
+    {
+      public:
+        virtual ~DecoderSink()
+        {
+        }
+
+        virtual void OnMarker( U64 sample, MarkerType type )
+        {
+        }
+        virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+        {
+        }
+        virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample )
+        {
+        }
+        virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+        {
+        }
+        virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample )
+        {
+        }
+        virtual void OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample )
+        {
+        }
+        // edges skipped after a broken frame until the line was idle long enough for a new frame to start
+        virtual void OnResync( U64 start_sample, U64 end_sample, U64 skipped_edges )
+        {
+        }
+    };
+}
+
+#endif // ISO14443A_DECODER_SINK
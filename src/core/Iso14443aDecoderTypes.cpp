@@ -0,0 +1,53 @@
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    namespace
+    {
+        constexpr bool CountOnesIsOdd( U32 value )
+        {
+            return ( value != 0 ) && ( ( ( value & 1 ) != 0 ) != CountOnesIsOdd( value >> 1 ) );
+        }
+
+        constexpr U64 BuildOddParityWord( U32 first_value, U32 bit = 0 )
+        {
+            return ( bit == 64 ) ? 0 : ( U64( CountOnesIsOdd( first_value + bit ) ) << bit ) | BuildOddParityWord( first_value, bit + 1 );
+        }
+    }
+
+    // evaluated by the compiler, so the table is ready before any static initialization runs
+    constexpr U64 ODD_PARITY_TABLE[ 4 ] = { BuildOddParityWord( 0 ), BuildOddParityWord( 64 ), BuildOddParityWord( 128 ),
+                                            BuildOddParityWord( 192 ) };
+
+    const char* GetFrameStatusString( DecodedFrame::Error error )
+    {
+        switch( error )
+        {
+        case DecodedFrame::Error::Ok:
+            return "OK";
+        case DecodedFrame::Error::ErrorWrongSoc:
+            return "SOC_ERROR";
+        case DecodedFrame::Error::ErrorWrongSequence:
+            return "SEQUENCE_ERROR";
+        case DecodedFrame::Error::ErrorParity:
+            return "PARITY_ERROR";
+        case DecodedFrame::Error::ErrorCrc:
+            return "CRC_ERROR";
+        };
+        return "";
+    }
+
+    const char* GetCrcStatusString( DecodedFrame::CrcStatus crc )
+    {
+        switch( crc )
+        {
+        case DecodedFrame::CrcStatus::NotPresent:
+            return "NONE";
+        case DecodedFrame::CrcStatus::Ok:
+            return "OK";
+        case DecodedFrame::CrcStatus::Wrong:
+            return "ERROR";
+        };
+        return "";
+    }
+}
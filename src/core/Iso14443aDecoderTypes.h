@@ -0,0 +1,126 @@
+#ifndef ISO14443A_DECODER_TYPES
+#define ISO14443A_DECODER_TYPES
+
+#include <vector>
+
+// The decoding core does not depend on the Saleae Analyzer SDK, so it brings its own integer types. They are declared with the
+// same underlying types as in LogicPublicTypes.h, so values can be passed between the SDK and the core without conversions.
+namespace Iso14443a
+{
+    typedef signed char S8;
+    typedef unsigned char U8;
+    typedef unsigned short U16;
+    typedef int S32;
+    typedef unsigned int U32;
+    typedef long long int S64;
+    typedef unsigned long long int U64;
+
+    enum LineState
+    {
+        LINE_LOW = 0,
+        LINE_HIGH = 1,
+    };
+
+    // ISO14443-2 bit rates, a bit lasts 128 (106 kbit/s), 64 (212 kbit/s), 32 (424 kbit/s) or 16 (848 kbit/s) carrier cycles
+    enum class BitRate
+    {
+        Fc128 = 0,
+        Fc64 = 1,
+        Fc32 = 2,
+        Fc16 = 3,
+    };
+    static const U32 BIT_RATE_COUNT = 4;
+
+    // nominal carrier frequency fc (ISO14443-2), real readers deviate from it by up to +-7 kHz
+    static const U32 NOMINAL_CARRIER_HZ = 13560000;
+    // range the carrier settings accept, outside of it the bit grid is meaningless (a carrier of 0 divides by zero)
+    static const U32 MIN_CARRIER_HZ = 13000000;
+    static const U32 MAX_CARRIER_HZ = 14000000;
+
+    inline bool IsValidCarrier( U32 carrier_hz )
+    {
+        return ( carrier_hz >= MIN_CARRIER_HZ ) && ( carrier_hz <= MAX_CARRIER_HZ );
+    }
+
+    inline U32 GetCarrierCyclesPerBit( BitRate bit_rate )
+    {
+        return 128U >> U32( bit_rate );
+    }
+
+    inline U32 GetBitRateKbps( BitRate bit_rate )
+    {
+        return 106U << U32( bit_rate );
+    }
+
+    // Modified Miller sequences (PCD to PICC), bit 1 = pause in first bit half, bit 0 = pause in second bit half
+    static const U8 ASK_SEQ_X = 0b01;
+    static const U8 ASK_SEQ_Y = 0b00;
+    static const U8 ASK_SEQ_Z = 0b10;
+    static const U8 ASK_SEQ_ERROR = 0b100;
+
+    // Manchester sequences (PICC to PCD), bit 1 = subcarrier in first bit half, bit 0 = subcarrier in second bit half
+    static const U8 LOADMOD_SEQ_D = 0b10;
+    static const U8 LOADMOD_SEQ_E = 0b01;
+    static const U8 LOADMOD_SEQ_F = 0b00;
+    static const U8 LOADMOD_SEQ_ERROR = 0b100;
+
+    struct DecodedFrame
+    {
+        U64 frame_start_sample{ 0U }; // first sample of frame
+        U64 frame_end_sample{ 0U };   // last sample of frame
+
+        U64 frame_data_start_sample{ 0U }; // first sample of data bits
+
+        U32 seq_num{ 0U }; // sequence count of complete frame
+
+        BitRate bit_rate{ BitRate::Fc128 };
+
+        std::vector<U8> data;                  // data of the frame
+        U8 data_valid_bits_in_last_byte{ 0U }; // the last data byte can be incomplete, so here are the valid bit count saved
+
+        enum class Error
+        {
+            Ok = 0,
+            ErrorWrongSoc = 1,
+            ErrorWrongSequence = 2,
+            ErrorParity = 3,
+            ErrorCrc = 4,
+        };
+        Error error{ Error::Ok };
+
+        enum class CrcStatus
+        {
+            NotPresent = 0,
+            Ok = 1,
+            Wrong = 2,
+        };
+        CrcStatus crc{ CrcStatus::NotPresent }; // CRC_A at the end of the frame, only checked for frames without other errors
+
+        // Prepares the frame for the next decoding run, the data buffer keeps its memory.
+        void Reset()
+        {
+            frame_start_sample = 0;
+            frame_end_sample = 0;
+            frame_data_start_sample = 0;
+            seq_num = 0;
+            bit_rate = BitRate::Fc128;
+            data.clear();
+            data_valid_bits_in_last_byte = 0;
+            error = Error::Ok;
+            crc = CrcStatus::NotPresent;
+        }
+    };
+
+    // Odd parity of all 256 byte values, bit n of word n / 64 is set if value n has an odd number of ones.
+    extern const U64 ODD_PARITY_TABLE[ 4 ];
+
+    inline bool HasOddOnesCount( U8 byte )
+    {
+        return ( ( ODD_PARITY_TABLE[ byte >> 6 ] >> ( byte & 63 ) ) & 1 ) != 0;
+    }
+
+    const char* GetFrameStatusString( DecodedFrame::Error error );
+    const char* GetCrcStatusString( DecodedFrame::CrcStatus crc );
+}
+
+#endif // ISO14443A_DECODER_TYPES
@@ -0,0 +1,183 @@
+#include "Iso14443aDualDecoder.h"
+#include <algorithm>
+#include <limits>
+
+namespace Iso14443a
+{
+    DualDecoder::FrameTap::FrameTap( DualDecoder& owner, DecoderSink& sink, bool is_response )
+        : mOwner( owner ), mSink( sink ), mIsResponse( is_response )
+    {
+    }
+
+    void DualDecoder::FrameTap::OnMarker( U64 sample, MarkerType type )
+    {
+        mSink.OnMarker( sample, type );
+    }
+
+    void DualDecoder::FrameTap::OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+    {
+        mSink.OnSequence( seq, start_sample, end_sample );
+    }
+
+    void DualDecoder::FrameTap::OnStartOfCommunication( U64 start_sample, U64 end_sample )
+    {
+        mSink.OnStartOfCommunication( start_sample, end_sample );
+    }
+
+    void DualDecoder::FrameTap::OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+    {
+        mSink.OnByte( byte, valid_bits, parity_error, start_sample, end_sample );
+    }
+
+    void DualDecoder::FrameTap::OnEndOfCommunication( U64 start_sample, U64 end_sample )
+    {
+        mSink.OnEndOfCommunication( start_sample, end_sample );
+    }
+
+    void DualDecoder::FrameTap::OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample )
+    {
+        mSink.OnFrame( frame, start_sample, end_sample );
+        mOwner.AddFrame( frame, start_sample, end_sample, mIsResponse );
+    }
+
+    void DualDecoder::FrameTap::OnResync( U64 start_sample, U64 end_sample, U64 skipped_edges )
+    {
+        mSink.OnResync( start_sample, end_sample, skipped_edges );
+    }
+
+    DualDecoder::DualDecoder( EdgeSource& pcd_source, EdgeSource& picc_source, DecoderSink& pcd_sink, DecoderSink& picc_sink,
+                              TransactionSink& transaction_sink )
+        : mPcdSource( pcd_source ),
+          mPiccSource( picc_source ),
+          mTransactionSink( transaction_sink ),
+          mPcdTap( *this, pcd_sink, false ),
+          mPiccTap( *this, picc_sink, true ),
+          mPcdDecoder( pcd_source, mPcdTap ),
+          mPiccDecoder( picc_source, mPiccTap ),
+          mLookaheadSamples( 1 ),
+          mPcdEnded( false ),
+          mPiccEnded( false ),
+          mCommandStartSample( 0 ),
+          mCommandEndSample( 0 ),
+          mCommandPending( false )
+    {
+    }
+
+    void DualDecoder::Setup( U64 lookahead_samples )
+    {
+        mLookaheadSamples = std::max( lookahead_samples, U64( 1 ) );
+        mCommandDecoder.Reset();
+        mPiccDecoder.SetUidResponseExpected( mCommandDecoder.IsUidResponseExpected() );
+    }
+
+    void DualDecoder::WaitForIdle()
+    {
+        mPcdDecoder.WaitForIdle();
+        mPiccDecoder.WaitForIdle();
+    }
+
+    // GetSampleOfNextEdge would wait for an edge on a channel that stays idle, while the other channel keeps sending frames. So
+    // both channels are only asked whether they have an edge up to a horizon that moves ahead in steps of the lookahead.
+    bool DualDecoder::DecodeFrame()
+    {
+        U64 horizon_sample = std::max( mPcdSource.GetSampleNumber(), mPiccSource.GetSampleNumber() );
+
+        while( !mPcdEnded || !mPiccEnded )
+        {
+            bool pcd_edge = !mPcdEnded && mPcdSource.WouldAdvancingToAbsPositionCauseTransition( horizon_sample );
+            bool picc_edge = !mPiccEnded && mPiccSource.WouldAdvancingToAbsPositionCauseTransition( horizon_sample );
+
+            if( !pcd_edge && !picc_edge )
+            {
+                if( !mPcdSource.HasEdgesLeft() && !mPiccSource.HasEdgesLeft() )
+                {
+                    mPcdEnded = true;
+                    mPiccEnded = true;
+                    break;
+                }
+                mTransactionSink.OnDecodedUpTo( horizon_sample + 1 );
+                horizon_sample += mLookaheadSamples;
+                continue;
+            }
+
+            // a frame starts on the next edge of its channel (the other channel has none before it)
+            bool decode_pcd = pcd_edge;
+            U64 frame_start_sample = 0;
+            if( pcd_edge && picc_edge )
+            {
+                U64 pcd_edge_sample = mPcdSource.GetSampleOfNextEdge();
+                U64 picc_edge_sample = mPiccSource.GetSampleOfNextEdge();
+                decode_pcd = pcd_edge_sample <= picc_edge_sample;
+                frame_start_sample = std::min( pcd_edge_sample, picc_edge_sample );
+            }
+            else
+            {
+                frame_start_sample = pcd_edge ? mPcdSource.GetSampleOfNextEdge() : mPiccSource.GetSampleOfNextEdge();
+            }
+            mTransactionSink.OnDecodedUpTo( frame_start_sample );
+
+            if( decode_pcd )
+            {
+                if( mPcdDecoder.DecodeFrame() )
+                {
+                    return true;
+                }
+                mPcdEnded = true;
+            }
+            else
+            {
+                if( mPiccDecoder.DecodeFrame() )
+                {
+                    return true;
+                }
+                mPiccEnded = true;
+            }
+        }
+
+        mTransactionSink.OnDecodedUpTo( std::numeric_limits<U64>::max() );
+        Flush();
+        return false;
+    }
+
+    void DualDecoder::Flush()
+    {
+        if( mCommandPending )
+        {
+            mTransactionSink.OnTransaction( &mCommand, nullptr, mCommandStartSample, mCommandEndSample );
+            mCommandPending = false;
+        }
+    }
+
+    void DualDecoder::AddFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample, bool is_response )
+    {
+        if( is_response )
+        {
+            mCommandDecoder.DecodeResponse( frame );
+        }
+        else
+        {
+            mCommandDecoder.DecodeCommand( frame );
+        }
+        mPiccDecoder.SetUidResponseExpected( mCommandDecoder.IsUidResponseExpected() );
+
+        if( !is_response )
+        {
+            // the previous command got no response
+            Flush();
+
+            mCommand = frame;
+            mCommandStartSample = start_sample;
+            mCommandEndSample = end_sample;
+            mCommandPending = true;
+        }
+        else if( mCommandPending )
+        {
+            mTransactionSink.OnTransaction( &mCommand, &frame, mCommandStartSample, std::max( end_sample, mCommandEndSample ) );
+            mCommandPending = false;
+        }
+        else
+        {
+            mTransactionSink.OnTransaction( nullptr, &frame, start_sample, end_sample );
+        }
+    }
+}
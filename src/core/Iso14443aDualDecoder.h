@@ -0,0 +1,108 @@
+#ifndef ISO14443A_DUAL_DECODER
+#define ISO14443A_DUAL_DECODER
+
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aEdgeSource.h"
+#include "Iso14443aDecoderSink.h"
+#include "Iso14443aAskDecoder.h"
+#include "Iso14443aLoadmodDecoder.h"
+#include "Iso14443aCommandDecoder.h"
+
+namespace Iso14443a
+{
+    // Receives a PCD command together with the PICC response that followed it. One of both is missing if a command got no
+    // response or a response was seen without a command. The sample range covers both frames (inclusive).
+    class TransactionSink
+    {
+      public:
+        virtual ~TransactionSink()
+        {
+        }
+
+        virtual void OnTransaction( const DecodedFrame* command, const DecodedFrame* response, U64 start_sample, U64 end_sample )
+        {
+        }
+
+        // Both channels are decoded up to the sample, every frame reported from now on starts at or after it. The frames of one
+        // channel can overlap the last frame of the other one, a sink that needs all frames in sample order holds them until here.
+        virtual void OnDecodedUpTo( U64 sample )
+        {
+        }
+    };
+
+    // Decodes the PCD (ASK) and PICC (LOADMOD) channel of the same capture in a single pass. The channel whose next frame starts
+    // first is decoded next, so both sinks see the frames of both channels in the order they were sent, and every command is
+    // paired with the response that follows it before the next command.
+    class DualDecoder
+    {
+      public:
+        DualDecoder( EdgeSource& pcd_source, EdgeSource& picc_source, DecoderSink& pcd_sink, DecoderSink& picc_sink,
+                     TransactionSink& transaction_sink );
+
+        // The decoders are set up separately, the lookahead is the step used to search the next edge on both channels.
+        AskDecoder& GetPcdDecoder()
+        {
+            return mPcdDecoder;
+        }
+        LoadmodDecoder& GetPiccDecoder()
+        {
+            return mPiccDecoder;
+        }
+        void Setup( U64 lookahead_samples );
+
+        void WaitForIdle();
+
+        // Decodes the next frame of either channel. Returns false if both edge streams have ended.
+        bool DecodeFrame();
+
+        // Reports a command that is still waiting for its response.
+        void Flush();
+
+      protected:
+        // Forwards everything a decoder reports and hands the finished frames over to the pairing.
+        class FrameTap : public DecoderSink
+        {
+          public:
+            FrameTap( DualDecoder& owner, DecoderSink& sink, bool is_response );
+
+            virtual void OnMarker( U64 sample, MarkerType type );
+            virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample );
+            virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample );
+            virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample );
+            virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample );
+            virtual void OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample );
+            virtual void OnResync( U64 start_sample, U64 end_sample, U64 skipped_edges );
+
+          protected:
+            DualDecoder& mOwner;
+            DecoderSink& mSink;
+            bool mIsResponse;
+        };
+
+        void AddFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample, bool is_response );
+
+        EdgeSource& mPcdSource;
+        EdgeSource& mPiccSource;
+        TransactionSink& mTransactionSink;
+
+        FrameTap mPcdTap;
+        FrameTap mPiccTap;
+        AskDecoder mPcdDecoder;
+        LoadmodDecoder mPiccDecoder;
+
+        // follows the activation, so the PICC decoder knows when a UID CLn without CRC may come
+        CommandDecoder mCommandDecoder;
+
+        U64 mLookaheadSamples;
+        bool mPcdEnded;
+        bool mPiccEnded;
+
+        // command waiting for its response, the data buffer is reused
+        DecodedFrame mCommand;
+        U64 mCommandStartSample;
+        U64 mCommandEndSample;
+        bool mCommandPending;
+    };
+}
+
+#endif // ISO14443A_DUAL_DECODER
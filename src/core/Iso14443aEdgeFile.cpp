@@ -0,0 +1,199 @@
+#include "Iso14443aEdgeFile.h"
+#include <cstring>
+
+namespace Iso14443a
+{
+    static const char EDGE_FILE_MAGIC[ 8 ] = { 'I', '1', '4', 'A', 'E', 'D', 'G', '1' };
+    static const U64 EDGE_FILE_HEADER_SIZE = 16;
+    static const U64 EDGE_FILE_BUFFER_SIZE = 1 << 20;
+
+    EdgeFileWriter::EdgeFileWriter() : mFile( nullptr ), mBufferUsed( 0 ), mLastEdge( 0 ), mWriteError( false )
+    {
+    }
+
+    EdgeFileWriter::~EdgeFileWriter()
+    {
+        Close();
+    }
+
+    bool EdgeFileWriter::Open( const char* file_name, const EdgeStreamHeader& header )
+    {
+        Close();
+
+        mFile = fopen( file_name, "wb" );
+        if( mFile == nullptr )
+        {
+            return false;
+        }
+
+        U8 raw_header[ EDGE_FILE_HEADER_SIZE ] = {};
+        memcpy( raw_header, EDGE_FILE_MAGIC, sizeof( EDGE_FILE_MAGIC ) );
+        for( U32 i = 0; i < 4; i++ )
+        {
+            raw_header[ 8 + i ] = U8( header.sample_rate_hz >> ( 8 * i ) );
+        }
+        raw_header[ 12 ] = U8( header.initial_state );
+
+        mBuffer.resize( EDGE_FILE_BUFFER_SIZE );
+        mBufferUsed = 0;
+        mLastEdge = 0;
+        mWriteError = fwrite( raw_header, 1, EDGE_FILE_HEADER_SIZE, mFile ) != EDGE_FILE_HEADER_SIZE;
+
+        return !mWriteError;
+    }
+
+    void EdgeFileWriter::AddEdge( U64 sample_number )
+    {
+        // a LEB128 encoded U64 needs at most 10 bytes
+        if( mBufferUsed + 10 > mBuffer.size() )
+        {
+            Flush();
+        }
+
+        U64 delta = sample_number - mLastEdge;
+        mLastEdge = sample_number;
+
+        while( delta >= 0x80 )
+        {
+            mBuffer[ mBufferUsed++ ] = U8( delta | 0x80 );
+            delta >>= 7;
+        }
+        mBuffer[ mBufferUsed++ ] = U8( delta );
+    }
+
+    void EdgeFileWriter::Flush()
+    {
+        if( ( mFile != nullptr ) && ( mBufferUsed > 0 ) )
+        {
+            mWriteError |= fwrite( mBuffer.data(), 1, mBufferUsed, mFile ) != mBufferUsed;
+        }
+        mBufferUsed = 0;
+    }
+
+    bool EdgeFileWriter::Close()
+    {
+        if( mFile == nullptr )
+        {
+            return !mWriteError;
+        }
+
+        Flush();
+        mWriteError |= fclose( mFile ) != 0;
+        mFile = nullptr;
+
+        return !mWriteError;
+    }
+
+
+    EdgeFileReader::EdgeFileReader() : mFile( nullptr ), mBufferUsed( 0 ), mBufferPos( 0 ), mLastEdge( 0 )
+    {
+    }
+
+    EdgeFileReader::~EdgeFileReader()
+    {
+        Close();
+    }
+
+    bool EdgeFileReader::Open( const char* file_name, EdgeStreamHeader& header )
+    {
+        Close();
+
+        mFile = fopen( file_name, "rb" );
+        if( mFile == nullptr )
+        {
+            return false;
+        }
+
+        U8 raw_header[ EDGE_FILE_HEADER_SIZE ];
+        if( ( fread( raw_header, 1, EDGE_FILE_HEADER_SIZE, mFile ) != EDGE_FILE_HEADER_SIZE ) ||
+            ( memcmp( raw_header, EDGE_FILE_MAGIC, sizeof( EDGE_FILE_MAGIC ) ) != 0 ) )
+        {
+            Close();
+            return false;
+        }
+
+        header.sample_rate_hz = 0;
+        for( U32 i = 0; i < 4; i++ )
+        {
+            header.sample_rate_hz |= U32( raw_header[ 8 + i ] ) << ( 8 * i );
+        }
+        header.initial_state = raw_header[ 12 ] ? LINE_HIGH : LINE_LOW;
+
+        mBuffer.resize( EDGE_FILE_BUFFER_SIZE );
+        mBufferUsed = 0;
+        mBufferPos = 0;
+        mLastEdge = 0;
+
+        return true;
+    }
+
+    bool EdgeFileReader::Fill()
+    {
+        if( mFile == nullptr )
+        {
+            return false;
+        }
+
+        // keep the unread tail, it may hold the first bytes of a split delta
+        U64 remaining = mBufferUsed - mBufferPos;
+        memmove( mBuffer.data(), mBuffer.data() + mBufferPos, remaining );
+        mBufferUsed = remaining + fread( mBuffer.data() + remaining, 1, mBuffer.size() - remaining, mFile );
+        mBufferPos = 0;
+
+        return mBufferUsed > remaining;
+    }
+
+    bool EdgeFileReader::ReadEdge( U64& sample_number )
+    {
+        if( ( mBufferUsed - mBufferPos < 10 ) && !Fill() && ( mBufferPos == mBufferUsed ) )
+        {
+            return false;
+        }
+
+        U64 delta = 0;
+        U32 shift = 0;
+        while( mBufferPos < mBufferUsed )
+        {
+            U8 byte = mBuffer[ mBufferPos++ ];
+            delta |= U64( byte & 0x7F ) << shift;
+            if( ( byte & 0x80 ) == 0 )
+            {
+                mLastEdge += delta;
+                sample_number = mLastEdge;
+                return true;
+            }
+            shift += 7;
+        }
+
+        // truncated file
+        return false;
+    }
+
+    void EdgeFileReader::Close()
+    {
+        if( mFile != nullptr )
+        {
+            fclose( mFile );
+            mFile = nullptr;
+        }
+    }
+
+
+    bool ReadEdgeFile( const char* file_name, EdgeStreamHeader& header, std::vector<U64>& edges )
+    {
+        EdgeFileReader reader;
+        if( !reader.Open( file_name, header ) )
+        {
+            return false;
+        }
+
+        edges.clear();
+        U64 sample_number;
+        while( reader.ReadEdge( sample_number ) )
+        {
+            edges.push_back( sample_number );
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef ISO14443A_EDGE_FILE
+#define ISO14443A_EDGE_FILE
+
+#include "Iso14443aDecoderTypes.h"
+#include <cstdio>
+#include <vector>
+
+// Recorded edge streams are stored as
+//   8 bytes   magic "I14AEDG1"
+//   4 bytes   sample rate in Hz (little endian)
+//   1 byte    line state at sample 0
+//   3 bytes   reserved
+// followed by one LEB128 encoded delta to the previous edge (the first one relative to sample 0) per edge.
+namespace Iso14443a
+{
+    struct EdgeStreamHeader
+    {
+        U32 sample_rate_hz{ 0U };
+        LineState initial_state{ LINE_LOW };
+    };
+
+    class EdgeFileWriter
+    {
+      public:
+        EdgeFileWriter();
+        ~EdgeFileWriter();
+
+        bool Open( const char* file_name, const EdgeStreamHeader& header );
+        void AddEdge( U64 sample_number );
+        bool Close();
+
+      protected:
+        void Flush();
+
+        FILE* mFile;
+        std::vector<U8> mBuffer;
+        U64 mBufferUsed;
+        U64 mLastEdge;
+        bool mWriteError;
+    };
+
+    class EdgeFileReader
+    {
+      public:
+        EdgeFileReader();
+        ~EdgeFileReader();
+
+        bool Open( const char* file_name, EdgeStreamHeader& header );
+
+        // Returns false at the end of the file.
+        bool ReadEdge( U64& sample_number );
+        void Close();
+
+      protected:
+        bool Fill();
+
+        FILE* mFile;
+        std::vector<U8> mBuffer;
+        U64 mBufferUsed;
+        U64 mBufferPos;
+        U64 mLastEdge;
+    };
+
+    // Loads a whole edge file into memory
+    bool ReadEdgeFile( const char* file_name, EdgeStreamHeader& header, std::vector<U64>& edges );
+}
+
+#endif // ISO14443A_EDGE_FILE
@@ -0,0 +1,37 @@
+#ifndef ISO14443A_EDGE_SOURCE
+#define ISO14443A_EDGE_SOURCE
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Forward-only view of a digital channel as a stream of edge timestamps. The interface mirrors the traversal functions of
+    // AnalyzerChannelData, so the plugins can hand their channel to the decoders without any translation.
+    class EdgeSource
+    {
+      public:
+        virtual ~EdgeSource()
+        {
+        }
+
+        virtual U64 GetSampleNumber() = 0;
+        virtual LineState GetBitState() = 0;
+
+        // returns the number of edges passed
+        virtual U32 AdvanceToAbsPosition( U64 sample_number ) = 0;
+        virtual void AdvanceToNextEdge() = 0;
+        virtual U64 GetSampleOfNextEdge() = 0;
+
+        // True if there is an edge after the current position up to and including sample_number. Unlike GetSampleOfNextEdge it
+        // only needs the data up to sample_number, so a live capture does not have to wait for an edge that may never come.
+        virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number ) = 0;
+
+        // A live capture never ends (the SDK blocks until more data arrives), a recorded stream does.
+        virtual bool IsEndOfStream() = 0;
+
+        // False once a recorded stream has no edges left. A live capture may always get more.
+        virtual bool HasEdgesLeft() = 0;
+    };
+}
+
+#endif // ISO14443A_EDGE_SOURCE
@@ -0,0 +1,241 @@
+#include "Iso14443aExportWriter.h"
+#include "Iso14443aCrc.h"
+
+namespace Iso14443a
+{
+    ExportWriter::ExportWriter()
+        : mTriggerSample( 0 ),
+          mSampleRateHz( 1 ),
+          mNumberFormat( NumberFormat::Hexadecimal ),
+          mWithDirection( false ),
+          mRowCount( 0 ),
+          mPendingActive{ false, false }
+    {
+    }
+
+    bool ExportWriter::Open( const char* file_name, U64 trigger_sample, U32 sample_rate_hz, NumberFormat number_format,
+                             bool with_direction )
+    {
+        mTriggerSample = trigger_sample;
+        mSampleRateHz = sample_rate_hz;
+        mNumberFormat = number_format;
+        mWithDirection = with_direction;
+        mRowCount = 0;
+        mPendingActive[ 0 ] = false;
+        mPendingActive[ 1 ] = false;
+        mCommandDecoder.Reset();
+        for( DecodedFrame& frame : mPendingFrames )
+        {
+            frame.data.reserve( 256 );
+        }
+        return mOut.Open( file_name );
+    }
+
+    bool ExportWriter::Close()
+    {
+        WritePendingFrames();
+        return mOut.Close();
+    }
+
+    void ExportWriter::StartRow( U64 start_sample, const U64* end_sample, bool is_response )
+    {
+        mOut.AppendSeconds( S64( start_sample - mTriggerSample ), mSampleRateHz );
+        mOut.AppendChar( ',' );
+        if( end_sample != nullptr )
+        {
+            mOut.AppendSeconds( S64( *end_sample - mTriggerSample ), mSampleRateHz );
+            mOut.AppendChar( ',' );
+        }
+        if( mWithDirection )
+        {
+            mOut.AppendString( is_response ? "PICC," : "PCD," );
+        }
+    }
+
+    void ExportWriter::EndRow()
+    {
+        mOut.AppendChar( '\n' );
+        mRowCount++;
+    }
+
+    void ExportWriter::AppendNumber( U64 value, U32 bits )
+    {
+        switch( mNumberFormat )
+        {
+            case NumberFormat::Decimal:
+                mOut.AppendDecimal( value );
+                break;
+            case NumberFormat::Binary:
+                mOut.AppendString( "0b" );
+                mOut.AppendBinary( value, bits );
+                break;
+            case NumberFormat::Ascii:
+                // printable characters, except the ones of the csv syntax
+                if( ( value >= 0x20 ) && ( value < 0x7F ) && ( value != ',' ) && ( value != '"' ) )
+                {
+                    mOut.AppendChar( char( value ) );
+                    break;
+                }
+                mOut.AppendString( "0x" );
+                mOut.AppendHex( value, ( bits + 3 ) / 4 );
+                break;
+            default:
+                mOut.AppendString( "0x" );
+                mOut.AppendHex( value, ( bits + 3 ) / 4 );
+                break;
+        }
+    }
+
+    void ExportWriter::WriteValueHeader()
+    {
+        mOut.AppendString( mWithDirection ? "Time [s],Direction,Value\n" : "Time [s],Value\n" );
+    }
+
+    void ExportWriter::WriteValueRow( U64 start_sample, bool is_response, U64 value, U32 bits )
+    {
+        StartRow( start_sample, nullptr, is_response );
+        AppendNumber( value, bits );
+        EndRow();
+    }
+
+    void ExportWriter::WriteSequenceHeader()
+    {
+        mOut.AppendString( mWithDirection ? "Start [s],End [s],Direction,Sequence\n" : "Start [s],End [s],Sequence\n" );
+    }
+
+    void ExportWriter::WriteSequenceRow( U64 start_sample, U64 end_sample, bool is_response, const char* sequence )
+    {
+        StartRow( start_sample, &end_sample, is_response );
+        mOut.AppendString( sequence );
+        EndRow();
+    }
+
+    void ExportWriter::WriteByteHeader()
+    {
+        mOut.AppendString( mWithDirection ? "Start [s],End [s],Direction,Value,Valid bits,Parity\n"
+                                          : "Start [s],End [s],Value,Valid bits,Parity\n" );
+    }
+
+    void ExportWriter::WriteByteRow( U64 start_sample, U64 end_sample, bool is_response, U8 byte, U8 valid_bits, bool parity_error )
+    {
+        StartRow( start_sample, &end_sample, is_response );
+        AppendNumber( byte, valid_bits );
+        mOut.AppendChar( ',' );
+        mOut.AppendDecimal( valid_bits );
+        mOut.AppendString( parity_error ? ",ERROR" : ",OK" );
+        EndRow();
+    }
+
+    void ExportWriter::WriteFrameHeader()
+    {
+        mOut.AppendString( mWithDirection ? "Start [s],End [s],Direction,Status,CRC,Length,Valid bits,Data\n"
+                                          : "Start [s],End [s],Status,CRC,Length,Valid bits,Data\n" );
+    }
+
+    void ExportWriter::WriteFrameRow( const DecodedFrame& frame, bool is_response, U64 start_sample, U64 end_sample )
+    {
+        StartRow( start_sample, &end_sample, is_response );
+        mOut.AppendString( GetFrameStatusString( frame.error ) );
+        mOut.AppendChar( ',' );
+        mOut.AppendString( GetCrcStatusString( frame.crc ) );
+        mOut.AppendChar( ',' );
+        mOut.AppendDecimal( frame.data.size() );
+        mOut.AppendChar( ',' );
+        mOut.AppendDecimal( frame.data.empty() ? 0 : frame.data_valid_bits_in_last_byte );
+        mOut.AppendChar( ',' );
+
+        // the data is always hex, it is one column
+        static const char hex_digits[] = "0123456789ABCDEF";
+        U8* out = mOut.Reserve( frame.data.size() * 2 );
+        for( U8 byte : frame.data )
+        {
+            *out++ = U8( hex_digits[ byte >> 4 ] );
+            *out++ = U8( hex_digits[ byte & 0xF ] );
+        }
+        EndRow();
+    }
+
+    // Frames of both directions do not overlap, so at the next SOC the pending frames have broken off.
+    void ExportWriter::WritePendingFrames()
+    {
+        U64 pcd_start_sample = mPendingFrames[ 0 ].frame_start_sample;
+        U64 picc_start_sample = mPendingFrames[ 1 ].frame_start_sample;
+        bool picc_first = mPendingActive[ 1 ] && ( !mPendingActive[ 0 ] || ( picc_start_sample < pcd_start_sample ) );
+        for( U32 i = 0; i < 2; i++ )
+        {
+            bool is_response = ( i == 0 ) == picc_first;
+            if( mPendingActive[ is_response ? 1 : 0 ] )
+            {
+                mPendingActive[ is_response ? 1 : 0 ] = false;
+                DecodedFrame& frame = mPendingFrames[ is_response ? 1 : 0 ];
+                if( frame.error == DecodedFrame::Error::Ok )
+                {
+                    frame.error = DecodedFrame::Error::ErrorWrongSequence;
+                }
+                FollowActivation( frame, is_response );
+                WriteFrameRow( frame, is_response, frame.frame_start_sample, frame.frame_end_sample );
+            }
+        }
+    }
+
+    void ExportWriter::FollowActivation( const DecodedFrame& frame, bool is_response )
+    {
+        if( is_response )
+        {
+            mCommandDecoder.DecodeResponse( frame );
+        }
+        else
+        {
+            mCommandDecoder.DecodeCommand( frame );
+        }
+    }
+
+    void ExportWriter::StartFrame( bool is_response, U64 start_sample, U64 end_sample )
+    {
+        WritePendingFrames();
+
+        DecodedFrame& frame = mPendingFrames[ is_response ? 1 : 0 ];
+        frame.Reset();
+        frame.frame_start_sample = start_sample;
+        frame.frame_end_sample = end_sample;
+        mPendingActive[ is_response ? 1 : 0 ] = true;
+    }
+
+    void ExportWriter::AddByte( bool is_response, U8 byte, U8 valid_bits, bool parity_error, U64 end_sample )
+    {
+        if( !mPendingActive[ is_response ? 1 : 0 ] )
+        {
+            return;
+        }
+        DecodedFrame& frame = mPendingFrames[ is_response ? 1 : 0 ];
+        frame.data.push_back( byte );
+        frame.data_valid_bits_in_last_byte = valid_bits;
+        frame.frame_end_sample = end_sample;
+        if( parity_error )
+        {
+            frame.error = DecodedFrame::Error::ErrorParity;
+        }
+    }
+
+    void ExportWriter::EndFrame( bool is_response, U64 end_sample )
+    {
+        if( !mPendingActive[ is_response ? 1 : 0 ] )
+        {
+            return;
+        }
+        mPendingActive[ is_response ? 1 : 0 ] = false;
+
+        // same as the decoders, the CRC is only checked for frames without other errors
+        DecodedFrame& frame = mPendingFrames[ is_response ? 1 : 0 ];
+        if( frame.error == DecodedFrame::Error::Ok )
+        {
+            CheckCrcA( frame, is_response && mCommandDecoder.IsUidResponseExpected() );
+            if( frame.crc == DecodedFrame::CrcStatus::Wrong )
+            {
+                frame.error = DecodedFrame::Error::ErrorCrc;
+            }
+        }
+        FollowActivation( frame, is_response );
+        WriteFrameRow( frame, is_response, frame.frame_start_sample, end_sample );
+    }
+}
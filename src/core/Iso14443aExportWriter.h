@@ -0,0 +1,81 @@
+#ifndef ISO14443A_EXPORT_WRITER
+#define ISO14443A_EXPORT_WRITER
+
+#include "Iso14443aBufferedWriter.h"
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aCommandDecoder.h"
+
+namespace Iso14443a
+{
+    enum class NumberFormat
+    {
+        Hexadecimal = 0,
+        Decimal = 1,
+        Binary = 2,
+        Ascii = 3,
+    };
+
+    // Text/csv export of the decoded data at sequence, byte or whole frame granularity, every row goes through one BufferedWriter.
+    // The times are relative to the trigger sample. with_direction adds a PCD/PICC column, for exports of both channels.
+    class ExportWriter
+    {
+      public:
+        ExportWriter();
+
+        bool Open( const char* file_name, U64 trigger_sample, U32 sample_rate_hz, NumberFormat number_format, bool with_direction );
+        bool Close();
+
+        // Time [s],Value - one row per result frame of the analyzers
+        void WriteValueHeader();
+        void WriteValueRow( U64 start_sample, bool is_response, U64 value, U32 bits );
+
+        // Start [s],End [s],Sequence
+        void WriteSequenceHeader();
+        void WriteSequenceRow( U64 start_sample, U64 end_sample, bool is_response, const char* sequence );
+
+        // Start [s],End [s],Value,Valid bits,Parity
+        void WriteByteHeader();
+        void WriteByteRow( U64 start_sample, U64 end_sample, bool is_response, U8 byte, U8 valid_bits, bool parity_error );
+
+        // Start [s],End [s],Status,CRC,Length,Valid bits,Data
+        void WriteFrameHeader();
+        void WriteFrameRow( const DecodedFrame& frame, bool is_response, U64 start_sample, U64 end_sample );
+
+        // Frame rows out of single bytes (SOC, bytes, EOC), one pending frame per direction. The status is rebuilt from the parity
+        // flags and the CRC_A. The decoders only add an EOC to frames without sequence errors, a frame still pending at the next
+        // SOC or at Close() is written as SEQUENCE_ERROR (unless a parity error came first) and ends with its last byte (or its
+        // SOC).
+        void StartFrame( bool is_response, U64 start_sample, U64 end_sample );
+        void AddByte( bool is_response, U8 byte, U8 valid_bits, bool parity_error, U64 end_sample );
+        void EndFrame( bool is_response, U64 end_sample );
+
+        U64 GetRowCount() const
+        {
+            return mRowCount;
+        }
+        U64 GetBytesWritten() const
+        {
+            return mOut.GetBytesWritten();
+        }
+
+      protected:
+        void StartRow( U64 start_sample, const U64* end_sample, bool is_response );
+        void EndRow();
+        void AppendNumber( U64 value, U32 bits );
+        void WritePendingFrames();
+        void FollowActivation( const DecodedFrame& frame, bool is_response );
+
+        BufferedWriter mOut;
+        U64 mTriggerSample;
+        U32 mSampleRateHz;
+        NumberFormat mNumberFormat;
+        bool mWithDirection;
+        U64 mRowCount;
+
+        DecodedFrame mPendingFrames[ 2 ]; // PCD, PICC
+        bool mPendingActive[ 2 ];
+        CommandDecoder mCommandDecoder; // tells when a UID CLn without CRC may come
+    };
+}
+
+#endif // ISO14443A_EXPORT_WRITER
@@ -0,0 +1,185 @@
+#include "Iso14443aFrameScript.h"
+#include "Iso14443aCrc.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace Iso14443a
+{
+    static const char* const DEFAULT_FRAME_SCRIPT = "# activation\n"
+                                                    "pcd 26/7\n"
+                                                    "picc 0400\n"
+                                                    "pcd 9320\n"
+                                                    "picc 0102030404\n"
+                                                    "pcd 9370 0102030404 crc\n"
+                                                    "picc 20 crc\n"
+                                                    "pcd e050 crc\n"
+                                                    "picc 0578807002 crc\n"
+                                                    "# SELECT by AID, chained over two I-blocks, with a WTX\n"
+                                                    "pcd 12 00a4040007 crc\n"
+                                                    "picc a2 crc\n"
+                                                    "pcd 03 a000000004101000 crc\n"
+                                                    "picc f201 crc\n"
+                                                    "pcd f201 crc\n"
+                                                    "picc 03 6f098407a0000000041010 9000 crc\n"
+                                                    "# deselect and halt\n"
+                                                    "pcd c2 crc\n"
+                                                    "picc c2 crc\n"
+                                                    "pcd 5000 crc\n"
+                                                    "idle 5000\n";
+
+    const char* GetDefaultFrameScript()
+    {
+        return DEFAULT_FRAME_SCRIPT;
+    }
+
+    static int GetHexDigit( char c )
+    {
+        if( ( c >= '0' ) && ( c <= '9' ) )
+        {
+            return c - '0';
+        }
+        if( ( c >= 'a' ) && ( c <= 'f' ) )
+        {
+            return c - 'a' + 10;
+        }
+        if( ( c >= 'A' ) && ( c <= 'F' ) )
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    // one whitespace separated token of the line, false at the end of the line
+    static bool NextToken( const char*& line, std::string& token )
+    {
+        while( ( *line == ' ' ) || ( *line == '\t' ) || ( *line == '\r' ) )
+        {
+            line++;
+        }
+        if( ( *line == '\0' ) || ( *line == '\n' ) || ( *line == '#' ) )
+        {
+            return false;
+        }
+
+        const char* start = line;
+        while( ( *line != '\0' ) && !isspace( U8( *line ) ) && ( *line != '#' ) )
+        {
+            line++;
+        }
+        token.assign( start, line );
+        return true;
+    }
+
+    static bool ParseHex( const std::string& token, ScriptFrame& frame )
+    {
+        size_t length = token.size();
+        size_t slash = token.find( '/' );
+        if( slash != std::string::npos )
+        {
+            U32 bits = U32( strtoul( token.c_str() + slash + 1, nullptr, 10 ) );
+            if( ( bits < 1 ) || ( bits > 8 ) )
+            {
+                return false;
+            }
+            frame.valid_bits_in_last_byte = U8( bits );
+            length = slash;
+        }
+        if( length % 2 != 0 )
+        {
+            return false;
+        }
+
+        for( size_t i = 0; i < length; i += 2 )
+        {
+            int high = GetHexDigit( token[ i ] );
+            int low = GetHexDigit( token[ i + 1 ] );
+            if( ( high < 0 ) || ( low < 0 ) )
+            {
+                return false;
+            }
+            frame.data.push_back( U8( ( high << 4 ) | low ) );
+        }
+        return true;
+    }
+
+    bool ParseFrameScript( const char* text, std::vector<ScriptFrame>& frames, std::string& error )
+    {
+        frames.clear();
+        std::string token;
+        U32 line_number = 0;
+        while( *text != '\0' )
+        {
+            line_number++;
+            const char* line = text;
+            const char* line_end = strchr( text, '\n' );
+            text = line_end != nullptr ? line_end + 1 : text + strlen( text );
+
+            if( !NextToken( line, token ) )
+            {
+                continue;
+            }
+
+            ScriptFrame frame;
+            bool valid = true;
+            if( token == "idle" )
+            {
+                valid = NextToken( line, token ) && ( ( frame.idle_us = U32( strtoul( token.c_str(), nullptr, 10 ) ) ) > 0 );
+            }
+            else if( ( token == "pcd" ) || ( token == "picc" ) )
+            {
+                frame.is_response = token == "picc";
+                bool add_crc = false;
+                while( valid && NextToken( line, token ) )
+                {
+                    if( token == "crc" )
+                    {
+                        add_crc = true;
+                    }
+                    else if( token[ 0 ] == '@' )
+                    {
+                        U32 kbps = U32( strtoul( token.c_str() + 1, nullptr, 10 ) );
+                        valid = false;
+                        for( U32 rate = 0; rate < BIT_RATE_COUNT; rate++ )
+                        {
+                            if( GetBitRateKbps( BitRate( rate ) ) == kbps )
+                            {
+                                frame.bit_rate = BitRate( rate );
+                                valid = !frame.is_response || ( frame.bit_rate == BitRate::Fc128 );
+                            }
+                        }
+                    }
+                    else if( token[ 0 ] == '+' )
+                    {
+                        frame.gap_us = U32( strtoul( token.c_str() + 1, nullptr, 10 ) );
+                    }
+                    else
+                    {
+                        // the bit count belongs to the last byte of the frame
+                        valid = ( frame.valid_bits_in_last_byte == 8 ) && ParseHex( token, frame );
+                    }
+                }
+
+                valid = valid && !frame.data.empty() && ( !add_crc || ( frame.valid_bits_in_last_byte == 8 ) );
+                if( valid && add_crc )
+                {
+                    U16 crc = CalculateCrcA( frame.data.data(), frame.data.size() );
+                    frame.data.push_back( U8( crc ) );
+                    frame.data.push_back( U8( crc >> 8 ) );
+                }
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if( !valid )
+            {
+                error = "line " + std::to_string( line_number ) + ": cannot parse frame";
+                return false;
+            }
+            frames.push_back( frame );
+        }
+        return true;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef ISO14443A_FRAME_SCRIPT
+#define ISO14443A_FRAME_SCRIPT
+
+#include <string>
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    struct ScriptFrame
+    {
+        bool is_response{ false };
+        std::vector<U8> data;
+        U8 valid_bits_in_last_byte{ 8U };
+        BitRate bit_rate{ BitRate::Fc128 }; // PCD frames only
+        U32 gap_us{ 0U };                   // idle time before the frame, 0 = the default frame delay
+        U32 idle_us{ 0U };                  // no frame, only idle time (the "idle" line)
+    };
+
+    // A session of frames, one per line:
+    //   pcd|picc <hex bytes>[/<valid bits in last byte>] [crc] [@106|@212|@424|@848] [+<gap in us>]
+    //   idle <us>
+    // "crc" appends the CRC_A, # starts a comment. Returns false with a message in error for a malformed line.
+    bool ParseFrameScript( const char* text, std::vector<ScriptFrame>& frames, std::string& error );
+
+    // Activation of a PICC with a single size UID up to ISO14443-4, a SELECT command in a chained I-block and the DESELECT.
+    const char* GetDefaultFrameScript();
+}
+
+#endif // ISO14443A_FRAME_SCRIPT
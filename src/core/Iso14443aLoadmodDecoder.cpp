@@ -0,0 +1,492 @@
+#include "Iso14443aLoadmodDecoder.h"
+#include "Iso14443aCrc.h"
+#include "Iso14443aSequenceTables.h"
+#include <algorithm>
+
+namespace Iso14443a
+{
+    LoadmodDecoder::LoadmodDecoder( EdgeSource& source, DecoderSink& sink )
+        : mSource( source ),
+          mSink( sink ),
+          mSubcarrierDetector( source ),
+          mIdleState( LINE_LOW ),
+          mMarkerDetail( MarkerDetail::SamplingPoints ),
+          mResyncGapBits( 2 ),
+          mDetection( LoadmodSequenceDetection::SamplingPoints ),
+          mClockRecovery( true ),
+          mUidResponseExpected( true ),
+          mLastHalfModulated( true ),
+          mNextSubcarrierStartSeen( false ),
+          mNextSubcarrierStartSample( 0 ),
+          mSampleRateHz( 0 ),
+          mCarrierHz( NOMINAL_CARRIER_HZ )
+    {
+    }
+
+    void LoadmodDecoder::Setup( U32 sample_rate_hz, U32 carrier_hz, LineState idle_state, LoadmodSequenceDetection detection )
+    {
+        mSampleRateHz = sample_rate_hz;
+        mIdleState = idle_state;
+        mDetection = detection;
+        SetupBitGrid( carrier_hz );
+    }
+
+    // all timing derives from the carrier, the grid and the subcarrier thresholds are precomputed once per carrier
+    void LoadmodDecoder::SetupBitGrid( U32 carrier_hz )
+    {
+        mCarrierHz = carrier_hz;
+        mBitGrid.Setup( mSampleRateHz, carrier_hz, 128 );
+        mSubcarrierDetector.Setup( mBitGrid.GetSamplesPerBit(), mIdleState );
+    }
+
+    void LoadmodDecoder::SetCarrierCalibration( U32 frame_count )
+    {
+        mCalibration.Setup( mSampleRateHz, mCarrierHz, frame_count );
+        mBitGrid.SetCalibration( frame_count > 0 ? &mCalibration : nullptr );
+    }
+
+    void LoadmodDecoder::FinishCalibration()
+    {
+        U32 carrier_hz = mCalibration.GetCarrierHz();
+        if( carrier_hz != 0 )
+        {
+            SetupBitGrid( carrier_hz );
+        }
+        mBitGrid.SetCalibration( nullptr );
+    }
+
+    void LoadmodDecoder::SetMarkerDetail( MarkerDetail marker_detail )
+    {
+        mMarkerDetail = marker_detail;
+    }
+
+    void LoadmodDecoder::SetResyncGap( U32 gap_bits )
+    {
+        mResyncGapBits = gap_bits;
+    }
+
+    void LoadmodDecoder::SetClockRecovery( bool clock_recovery )
+    {
+        mClockRecovery = clock_recovery;
+    }
+
+    void LoadmodDecoder::WaitForIdle()
+    {
+        if( mSource.GetBitState() != mIdleState )
+            mSource.AdvanceToNextEdge();
+    }
+
+    std::tuple<U8, U64> LoadmodDecoder::ReceiveSeq( DecodedFrame& loadmod_frame )
+    {
+        if( mDetection == LoadmodSequenceDetection::SubcarrierEdges )
+        {
+            return ReceiveSeqFromSubcarrierEdges( loadmod_frame );
+        }
+        if( mDetection == LoadmodSequenceDetection::Envelope )
+        {
+            return ReceiveSeqFromEnvelope( loadmod_frame );
+        }
+
+        return ReceiveSeqAtSamplingPoints( loadmod_frame );
+    }
+
+    std::tuple<U8, U64> LoadmodDecoder::ReceiveSeqAtSamplingPoints( DecodedFrame& loadmod_frame )
+    {
+        U32 bit_changes = 0;
+        U8 seq = 0;
+        LineState bit_state = LINE_LOW;
+
+        U64 seq_start_sample = mBitGrid.GetSeqStartSample();
+        mBitGrid.NextSeq();
+        loadmod_frame.seq_num++;
+
+        // mark start of sequence
+        AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+
+        // wait for first bit quarter
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::QUARTER_BIT );
+        bit_changes = mSource.AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
+
+        // save bit state in the middel of the bit half to check the state
+        bit_state = mSource.GetBitState();
+
+        // if this half is unmodulated, the first edge up to the middle of the next one is where the subcarrier starts
+        U64 subcarrier_start_sample = 0;
+        bool subcarrier_start_seen =
+            PeekSubcarrierStart( seq_start_sample + mBitGrid.GetOffset( BitGrid::THREE_QUARTER_BIT ), subcarrier_start_sample );
+
+        // mark sampling point
+        AddMarker( loadmod_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+
+        // wait for second bit quarter
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::HALF_BIT );
+        bit_changes += mSource.AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
+        if( ( bit_changes >= 6 ) && ( bit_changes <= 9 ) )
+        {
+            // modulation available
+            seq |= 0b10;
+            if( mNextSubcarrierStartSeen )
+            {
+                mBitGrid.Align( mNextSubcarrierStartSample, 0 );
+            }
+        }
+        else if( ( bit_state == mIdleState ) && ( bit_changes <= 2 ) )
+        {
+            // no modulation available
+        }
+        else
+        {
+            return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        }
+        mNextSubcarrierStartSeen = false;
+
+        // mark sampling point
+        AddMarker( loadmod_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+
+        // wait for third bit quarter
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::THREE_QUARTER_BIT );
+        bit_changes = mSource.AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
+
+        // save bit state in the middel of the bit half to check the state
+        bit_state = mSource.GetBitState();
+
+        // the same for the first half of the next sequence
+        U64 next_subcarrier_start_sample = 0;
+        U64 next_quarter_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT ) + mBitGrid.GetOffset( BitGrid::QUARTER_BIT );
+        bool next_subcarrier_start_seen = PeekSubcarrierStart( next_quarter_sample, next_subcarrier_start_sample );
+
+        // mark sampling point
+        AddMarker( loadmod_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+
+        // wait for fourth bit quarter
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT );
+        bit_changes += mSource.AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
+
+        if( ( bit_changes >= 6 ) && ( bit_changes <= 9 ) )
+        {
+            // modulation available
+            seq |= 0b01;
+            if( ( seq == LOADMOD_SEQ_E ) && subcarrier_start_seen )
+            {
+                mBitGrid.Align( subcarrier_start_sample, BitGrid::HALF_BIT );
+            }
+        }
+        else if( ( bit_state == mIdleState ) && ( bit_changes <= 2 ) )
+        {
+            // no modulation available
+            mNextSubcarrierStartSeen = next_subcarrier_start_seen;
+            mNextSubcarrierStartSample = next_subcarrier_start_sample;
+        }
+        else
+        {
+            return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        }
+
+        mSink.OnSequence( seq, seq_start_sample, seq_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT ) - 1 );
+
+        return { seq, seq_start_sample };
+    }
+
+    std::tuple<U8, U64> LoadmodDecoder::ReceiveSeqFromSubcarrierEdges( DecodedFrame& loadmod_frame )
+    {
+        U8 seq = 0;
+
+        U64 seq_start_sample = mBitGrid.GetSeqStartSample();
+        mBitGrid.NextSeq();
+        loadmod_frame.seq_num++;
+
+        // mark start of sequence
+        AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+
+        // first bit half
+        U64 half_bit_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::HALF_BIT );
+        loadmod_frame.frame_end_sample = half_bit_sample;
+        SubcarrierDetector::HalfBit half_bit = mSubcarrierDetector.DetectHalfBit( seq_start_sample, half_bit_sample );
+        if( half_bit == SubcarrierDetector::HalfBit::Modulated )
+        {
+            seq |= 0b10;
+            AlignToBurstStart( 0 );
+        }
+        else if( half_bit == SubcarrierDetector::HalfBit::Invalid )
+        {
+            return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        }
+        mLastHalfModulated = half_bit == SubcarrierDetector::HalfBit::Modulated;
+
+        // mark middle of bit half
+        AddMarker( seq_start_sample + mBitGrid.GetOffset( BitGrid::QUARTER_BIT ), MarkerType::SamplingPoint,
+                   MarkerDetail::SamplingPoints );
+
+        // second bit half
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT );
+        half_bit = mSubcarrierDetector.DetectHalfBit( half_bit_sample, loadmod_frame.frame_end_sample );
+        if( half_bit == SubcarrierDetector::HalfBit::Modulated )
+        {
+            seq |= 0b01;
+            AlignToBurstStart( BitGrid::HALF_BIT );
+        }
+        else if( half_bit == SubcarrierDetector::HalfBit::Invalid )
+        {
+            return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        }
+        mLastHalfModulated = half_bit == SubcarrierDetector::HalfBit::Modulated;
+
+        // mark middle of bit half
+        AddMarker( seq_start_sample + mBitGrid.GetOffset( BitGrid::THREE_QUARTER_BIT ), MarkerType::SamplingPoint,
+                   MarkerDetail::SamplingPoints );
+
+        mSink.OnSequence( seq, seq_start_sample, seq_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT ) - 1 );
+
+        return { seq, seq_start_sample };
+    }
+
+    // The envelope is sampled in the middle of each bit half. Between two sampling points it changes at most once, at the start or
+    // in the middle of the bit, more edges are glitches. A modulated half after an unmodulated one starts with a rising edge that
+    // re-anchors the grid.
+    std::tuple<U8, U64> LoadmodDecoder::ReceiveSeqFromEnvelope( DecodedFrame& loadmod_frame )
+    {
+        U8 seq = 0;
+
+        U64 seq_start_sample = mBitGrid.GetSeqStartSample();
+        mBitGrid.NextSeq();
+        loadmod_frame.seq_num++;
+
+        // mark start of sequence
+        AddMarker( seq_start_sample, MarkerType::SequenceStart, MarkerDetail::SequenceStarts );
+
+        // wait for the middle of the first bit half
+        U64 subcarrier_start_sample = 0;
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::QUARTER_BIT );
+        bool subcarrier_start_seen = PeekSubcarrierStart( loadmod_frame.frame_end_sample, subcarrier_start_sample );
+        if( mSource.AdvanceToAbsPosition( loadmod_frame.frame_end_sample ) > 1 )
+        {
+            return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        }
+
+        // mark sampling point
+        AddMarker( loadmod_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+        if( mSource.GetBitState() != mIdleState )
+        {
+            seq |= 0b10;
+            if( subcarrier_start_seen )
+            {
+                mBitGrid.Align( subcarrier_start_sample, 0 );
+            }
+        }
+
+        // wait for the middle of the second bit half
+        loadmod_frame.frame_end_sample = seq_start_sample + mBitGrid.GetOffset( BitGrid::THREE_QUARTER_BIT );
+        subcarrier_start_seen = PeekSubcarrierStart( loadmod_frame.frame_end_sample, subcarrier_start_sample );
+        if( mSource.AdvanceToAbsPosition( loadmod_frame.frame_end_sample ) > 1 )
+        {
+            return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        }
+
+        // mark sampling point
+        AddMarker( loadmod_frame.frame_end_sample, MarkerType::SamplingPoint, MarkerDetail::SamplingPoints );
+        if( mSource.GetBitState() != mIdleState )
+        {
+            seq |= 0b01;
+            if( subcarrier_start_seen )
+            {
+                mBitGrid.Align( subcarrier_start_sample, BitGrid::HALF_BIT );
+            }
+        }
+
+        mSink.OnSequence( seq, seq_start_sample, seq_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT ) - 1 );
+
+        return { seq, seq_start_sample };
+    }
+
+    DecodedFrame::Error LoadmodDecoder::ReceiveStartOfCommunication( DecodedFrame& loadmod_frame )
+    {
+        // wait for edge as start condition (eg. rising edge)
+        mSource.AdvanceToNextEdge();
+        if( mSource.IsEndOfStream() )
+        {
+            // nothing to classify, DecodeFrame stops without reporting anything
+            return DecodedFrame::Error::ErrorWrongSoc;
+        }
+        loadmod_frame.frame_start_sample = mSource.GetSampleNumber();
+        loadmod_frame.seq_num = 0;
+        mBitGrid.Start( loadmod_frame.frame_start_sample );
+
+        // the first edge of the frame is the origin of the grid, there is nothing to align before it
+        mLastHalfModulated = true;
+        mNextSubcarrierStartSeen = false;
+
+        // detect start of communication
+        auto seq = ReceiveSeq( loadmod_frame );
+
+        if( std::get<0>( seq ) != LOADMOD_SEQ_D )
+        {
+            // ERROR
+            loadmod_frame.error = DecodedFrame::Error::ErrorWrongSoc;
+            return loadmod_frame.error;
+        }
+
+        mSink.OnStartOfCommunication( loadmod_frame.frame_start_sample,
+                                      loadmod_frame.frame_start_sample + mBitGrid.GetOffset( BitGrid::ONE_BIT ) - 1 );
+
+        return DecodedFrame::Error::Ok;
+    }
+
+    DecodedFrame::Error LoadmodDecoder::ReceiveData( DecodedFrame& loadmod_frame )
+    {
+        bool end_of_communication = false;
+
+        mBitBuffer.Clear();
+        while( true )
+        {
+            auto seq = ReceiveSeq( loadmod_frame );
+            U8 seq_result = LookupLoadmodSequence( std::get<0>( seq ) );
+
+            if( seq_result <= SEQ_RESULT_BIT_1 )
+            {
+                // logic "0" or "1"
+                mBitBuffer.PushBit( seq_result, std::get<1>( seq ) );
+            }
+            else if( seq_result == SEQ_RESULT_EOC )
+            {
+                end_of_communication = true;
+            }
+            else
+            {
+                // ERROR
+                // an earlier parity error stays the error of the frame, the wrong sequence ends it anyway
+                if( loadmod_frame.error == DecodedFrame::Error::Ok )
+                {
+                    loadmod_frame.error = DecodedFrame::Error::ErrorWrongSequence;
+                }
+                return DecodedFrame::Error::ErrorWrongSequence;
+            }
+
+            // If a byte is completely recevied or an "end of communication" is detected (incomplete bytes are valid) show it
+            if( mBitBuffer.IsFull() || end_of_communication )
+            {
+                if( end_of_communication )
+                {
+                    mBitBuffer.DropLastBit(); // last bit belogs to eoc
+                }
+
+                U8 bits_in_byte = mBitBuffer.GetBitCount();
+                if( bits_in_byte > 0 )
+                {
+                    U8 byte = mBitBuffer.GetDataByte();
+
+                    bool parity_error = false;
+                    if( bits_in_byte == 9 )
+                    {
+                        bits_in_byte--;
+
+                        if( HasOddOnesCount( byte ) == bool( mBitBuffer.GetParityBit() ) )
+                        {
+                            parity_error = true;
+                            loadmod_frame.error = DecodedFrame::Error::ErrorParity;
+                        }
+                    }
+
+                    U64 bit_starting_sample = mBitBuffer.GetFirstBitStartSample();
+                    U64 bit_ending_sample = mBitBuffer.GetLastBitStartSample() + mBitGrid.GetOffset( BitGrid::ONE_BIT ) - 1;
+                    mBitBuffer.Clear();
+
+                    loadmod_frame.data.push_back( byte );
+                    loadmod_frame.data_valid_bits_in_last_byte = bits_in_byte;
+
+                    mSink.OnByte( byte, bits_in_byte, parity_error, bit_starting_sample, bit_ending_sample );
+                }
+            }
+
+            if( end_of_communication == true )
+            {
+                U64 eoc_starting_sample = std::get<1>( seq );
+                U64 eoc_ending_sample = eoc_starting_sample + mBitGrid.GetOffset( BitGrid::TWO_BITS ) - 1;
+                loadmod_frame.frame_end_sample = eoc_ending_sample;
+
+                mSink.OnEndOfCommunication( eoc_starting_sample, eoc_ending_sample );
+
+                // End of communication
+                break;
+            }
+        }
+
+        return loadmod_frame.error;
+    }
+
+    // The position after a broken frame is usually still inside of it. Searching the next start of communication from there
+    // would turn every remaining edge of the frame into another broken frame, so the edges are skipped up to the next gap.
+    void LoadmodDecoder::Resync()
+    {
+        if( mResyncGapBits == 0 )
+        {
+            return;
+        }
+
+        U64 min_gap_samples = mBitGrid.GetOffset( BitGrid::ONE_BIT ) * mResyncGapBits;
+
+        U64 start_sample = mSource.GetSampleNumber();
+        U64 skipped_edges = 0;
+        while( !mSource.IsEndOfStream() )
+        {
+            bool idle = mSource.GetBitState() == mIdleState;
+            if( idle && !mSource.WouldAdvancingToAbsPositionCauseTransition( mSource.GetSampleNumber() + min_gap_samples - 1 ) )
+            {
+                break;
+            }
+            mSource.AdvanceToNextEdge();
+            skipped_edges++;
+        }
+
+        if( skipped_edges > 0 )
+        {
+            mSink.OnResync( start_sample, mSource.GetSampleNumber(), skipped_edges );
+        }
+    }
+
+    bool LoadmodDecoder::DecodeFrame()
+    {
+        DecodedFrame& loadmod_frame = mFrame;
+        loadmod_frame.Reset();
+
+        DecodedFrame::Error loadmod_error;
+
+        loadmod_error = ReceiveStartOfCommunication( loadmod_frame );
+        if( loadmod_error == DecodedFrame::Error::Ok )
+        {
+            loadmod_error = ReceiveData( loadmod_frame );
+        }
+        if( loadmod_error == DecodedFrame::Error::Ok )
+        {
+            CheckCrcA( loadmod_frame, mUidResponseExpected );
+            if( ( loadmod_frame.crc == DecodedFrame::CrcStatus::Wrong ) && ( loadmod_frame.error == DecodedFrame::Error::Ok ) )
+            {
+                loadmod_frame.error = DecodedFrame::Error::ErrorCrc;
+            }
+        }
+
+        // a recorded stream ran out of edges while waiting for the next frame
+        if( mSource.IsEndOfStream() )
+        {
+            return false;
+        }
+
+        if( loadmod_frame.error != DecodedFrame::Error::Ok )
+        {
+            AddMarker( loadmod_frame.frame_end_sample, MarkerType::Error, MarkerDetail::Errors );
+        }
+
+        mSink.OnFrame( loadmod_frame, loadmod_frame.frame_start_sample, loadmod_frame.frame_end_sample );
+
+        if( mCalibration.EndFrame( loadmod_frame.error == DecodedFrame::Error::Ok ) )
+        {
+            FinishCalibration();
+        }
+
+        // a parity or CRC error does not break the framing, a wrong SOC or sequence does (even after a parity error)
+        if( ( loadmod_error != DecodedFrame::Error::Ok ) && ( loadmod_error != DecodedFrame::Error::ErrorParity ) )
+        {
+            Resync();
+        }
+        return true;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef ISO14443A_LOADMOD_DECODER
+#define ISO14443A_LOADMOD_DECODER
+
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aEdgeSource.h"
+#include "Iso14443aDecoderSink.h"
+#include "Iso14443aBitAccumulator.h"
+#include "Iso14443aBitGrid.h"
+#include "Iso14443aCarrierCalibration.h"
+#include "Iso14443aSubcarrierDetector.h"
+#include <tuple>
+#include <algorithm>
+
+namespace Iso14443a
+{
+    enum class LoadmodSequenceDetection
+    {
+        SamplingPoints,  // count the edges between the quarters of a bit
+        SubcarrierEdges, // detect the subcarrier from the edges of each bit half
+        Envelope,        // the line is the demodulated envelope, sample the level in the middle of each bit half
+    };
+
+    // Decodes load modulation with a 847 kHz subcarrier and Manchester coding (PICC to PCD) from an edge stream. The stream is
+    // either the subcarrier itself or the envelope of a demodulating front end, which is active while the subcarrier is on and
+    // changes only twice per bit at most, so it can be captured with a much lower sample rate.
+    class LoadmodDecoder
+    {
+      public:
+        LoadmodDecoder( EdgeSource& source, DecoderSink& sink );
+
+        void Setup( U32 sample_rate_hz, U32 carrier_hz, LineState idle_state, LoadmodSequenceDetection detection );
+
+        void SetMarkerDetail( MarkerDetail marker_detail );
+
+        // After a broken frame all edges up to the next idle gap of at least gap_bits bits are skipped, 0 disables this.
+        void SetResyncGap( U32 gap_bits );
+
+        // Re-anchors the bit grid wherever the subcarrier starts after an unmodulated half bit, so long frames with a deviating
+        // carrier stay on the grid. Enabled by default.
+        void SetClockRecovery( bool clock_recovery );
+
+        // Measures the carrier on the next frame_count frames without errors and sets the bit grid up for the measured carrier
+        // from then on, 0 disables this. Needs the clock recovery, the calibration measures the edges the grid aligns to.
+        void SetCarrierCalibration( U32 frame_count );
+
+        // Whether the next frame may be a UID CLn, which carries a BCC instead of a CRC. The decoder does not see the commands, the
+        // command decoding of the frames tells it (CommandDecoder::IsUidResponseExpected()). Enabled by default.
+        void SetUidResponseExpected( bool expected )
+        {
+            mUidResponseExpected = expected;
+        }
+
+        bool IsCalibrating() const
+        {
+            return mCalibration.IsMeasuring();
+        }
+
+        // The carrier of Setup() or the measured one after the calibration.
+        U32 GetCarrierHz() const
+        {
+            return mCarrierHz;
+        }
+
+        // Wait for idle state (eg. low)
+        void WaitForIdle();
+
+        // Decodes the next frame and reports it to the sink. Returns false if the edge stream has ended.
+        bool DecodeFrame();
+
+      protected:
+        // Markers cost memory in the result store, so the decoder only creates the ones that were asked for. They must be added
+        // in sample order.
+        void AddMarker( U64 sample, MarkerType type, MarkerDetail min_detail )
+        {
+            if( mMarkerDetail >= min_detail )
+            {
+                mSink.OnMarker( sample, type );
+            }
+        }
+
+        // True if the line is idle and the subcarrier starts up to and including sample_number.
+        bool PeekSubcarrierStart( U64 sample_number, U64& start_sample )
+        {
+            if( !mClockRecovery || ( mSource.GetBitState() != mIdleState ) ||
+                !mSource.WouldAdvancingToAbsPositionCauseTransition( sample_number ) )
+            {
+                return false;
+            }
+            start_sample = mSource.GetSampleOfNextEdge();
+            return true;
+        }
+
+        // Only a modulated half bit after an unmodulated one has a burst start at its beginning.
+        void AlignToBurstStart( U32 twelfths )
+        {
+            if( mClockRecovery && !mLastHalfModulated )
+            {
+                mBitGrid.Align( mSubcarrierDetector.GetBurstStartSample(), twelfths );
+            }
+        }
+
+        std::tuple<U8, U64> ReceiveSeq( DecodedFrame& loadmod_frame );
+        std::tuple<U8, U64> ReceiveSeqAtSamplingPoints( DecodedFrame& loadmod_frame );
+        std::tuple<U8, U64> ReceiveSeqFromSubcarrierEdges( DecodedFrame& loadmod_frame );
+        std::tuple<U8, U64> ReceiveSeqFromEnvelope( DecodedFrame& loadmod_frame );
+        DecodedFrame::Error ReceiveStartOfCommunication( DecodedFrame& loadmod_frame );
+        DecodedFrame::Error ReceiveData( DecodedFrame& loadmod_frame );
+        void Resync();
+        void SetupBitGrid( U32 carrier_hz );
+        void FinishCalibration();
+
+        EdgeSource& mSource;
+        DecoderSink& mSink;
+
+        // reused for every frame, so decoding does not allocate once the data buffer has grown
+        DecodedFrame mFrame;
+        BitAccumulator mBitBuffer;
+        SubcarrierDetector mSubcarrierDetector;
+
+        BitGrid mBitGrid;
+        LineState mIdleState;
+        MarkerDetail mMarkerDetail;
+        U32 mResyncGapBits;
+        LoadmodSequenceDetection mDetection;
+
+        bool mClockRecovery;
+        bool mUidResponseExpected;
+        bool mLastHalfModulated;
+        bool mNextSubcarrierStartSeen; // peeked in the second half of an unmodulated bit half, belongs to the next sequence
+        U64 mNextSubcarrierStartSample;
+
+        U32 mSampleRateHz;
+        U32 mCarrierHz;
+        CarrierCalibration mCalibration;
+    };
+}
+
+#endif // ISO14443A_LOADMOD_DECODER
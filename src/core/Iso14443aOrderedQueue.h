@@ -0,0 +1,64 @@
+#ifndef ISO14443A_ORDERED_QUEUE
+#define ISO14443A_ORDERED_QUEUE
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Iso14443a
+{
+    // Hands results that are produced out of order by several threads to one consumer in their index order, without locks.
+    // Every slot is filled by exactly one producer and published with a release store, the consumer takes them one by one.
+    template <typename T>
+    class OrderedQueue
+    {
+      public:
+        explicit OrderedQueue( size_t size ) : mSlots( size ), mNext( 0 )
+        {
+        }
+
+        // producer: fill the slot, then publish it
+        T& GetSlot( size_t index )
+        {
+            return mSlots[ index ].value;
+        }
+
+        void Publish( size_t index )
+        {
+            mSlots[ index ].ready.store( true, std::memory_order_release );
+        }
+
+        // consumer: waits until the next slot in order is published, nullptr after the last one
+        T* WaitForNext()
+        {
+            if( mNext >= mSlots.size() )
+            {
+                return nullptr;
+            }
+
+            Slot& slot = mSlots[ mNext ];
+            while( !slot.ready.load( std::memory_order_acquire ) )
+            {
+                std::this_thread::yield();
+            }
+            return &slot.value;
+        }
+
+        void PopNext()
+        {
+            mNext++;
+        }
+
+      protected:
+        struct Slot
+        {
+            std::atomic<bool> ready{ false };
+            T value;
+        };
+
+        std::vector<Slot> mSlots;
+        size_t mNext;
+    };
+}
+
+#endif // ISO14443A_ORDERED_QUEUE
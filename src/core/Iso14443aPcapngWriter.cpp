@@ -0,0 +1,238 @@
+#include "Iso14443aPcapngWriter.h"
+#include <cstdio>
+#include <cstring>
+
+namespace Iso14443a
+{
+    static const U32 PCAPNG_SECTION_HEADER_BLOCK = 0x0A0D0D0A;
+    static const U32 PCAPNG_INTERFACE_DESCRIPTION_BLOCK = 0x00000001;
+    static const U32 PCAPNG_ENHANCED_PACKET_BLOCK = 0x00000006;
+    static const U32 PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+    static const U16 PCAPNG_OPT_END_OF_OPT = 0;
+    static const U16 PCAPNG_OPT_COMMENT = 1;
+    static const U16 PCAPNG_OPT_IF_TSRESOL = 9;
+    static const U16 PCAPNG_OPT_EPB_FLAGS = 2;
+    static const U32 PCAPNG_EPB_FLAG_INBOUND = 1;
+    static const U32 PCAPNG_EPB_FLAG_OUTBOUND = 2;
+
+    static const U16 LINKTYPE_ISO_14443 = 264;
+    static const U8 ISO14443_PSEUDO_HEADER_VERSION = 0;
+    static const U8 ISO14443_EVENT_PICC_TO_PCD = 0xFF;
+    static const U8 ISO14443_EVENT_PCD_TO_PICC = 0xFE;
+    static const size_t ISO14443_PSEUDO_HEADER_LENGTH = 4;
+    static const size_t ISO14443_MAX_DATA_LENGTH = 0xFFFF;
+
+    // blocks are little endian, the byte order magic tells the reader
+    static U8* PutU16( U8* out, U16 value )
+    {
+        out[ 0 ] = U8( value );
+        out[ 1 ] = U8( value >> 8 );
+        return out + 2;
+    }
+
+    static U8* PutU32( U8* out, U32 value )
+    {
+        out[ 0 ] = U8( value );
+        out[ 1 ] = U8( value >> 8 );
+        out[ 2 ] = U8( value >> 16 );
+        out[ 3 ] = U8( value >> 24 );
+        return out + 4;
+    }
+
+    static size_t PaddedLength( size_t length )
+    {
+        return ( length + 3 ) & ~size_t( 3 );
+    }
+
+    PcapngWriter::PcapngWriter() : mSampleRateHz( 1 )
+    {
+    }
+
+    bool PcapngWriter::Open( const char* file_name, U32 sample_rate_hz )
+    {
+        mSampleRateHz = sample_rate_hz != 0 ? sample_rate_hz : 1;
+        for( PendingPacket& pending : mPending )
+        {
+            pending.data.clear();
+            pending.active = false;
+        }
+
+        if( !mOut.Open( file_name ) )
+        {
+            return false;
+        }
+        WriteSectionHeader();
+        WriteInterfaceDescription();
+        return true;
+    }
+
+    bool PcapngWriter::Close()
+    {
+        WritePendingPackets();
+        return mOut.Close();
+    }
+
+    U64 PcapngWriter::GetTimestampNs( U64 sample ) const
+    {
+        // split up, so sample * 1e9 can not overflow
+        return ( sample / mSampleRateHz ) * 1000000000ULL + ( ( sample % mSampleRateHz ) * 1000000000ULL ) / mSampleRateHz;
+    }
+
+    void PcapngWriter::WriteSectionHeader()
+    {
+        const U32 block_length = 28;
+        U8* out = mOut.Reserve( block_length );
+        out = PutU32( out, PCAPNG_SECTION_HEADER_BLOCK );
+        out = PutU32( out, block_length );
+        out = PutU32( out, PCAPNG_BYTE_ORDER_MAGIC );
+        out = PutU16( out, 1 ); // version 1.0
+        out = PutU16( out, 0 );
+        out = PutU32( out, 0xFFFFFFFF ); // section length not specified
+        out = PutU32( out, 0xFFFFFFFF );
+        PutU32( out, block_length );
+    }
+
+    void PcapngWriter::WriteInterfaceDescription()
+    {
+        const U32 block_length = 32;
+        U8* out = mOut.Reserve( block_length );
+        out = PutU32( out, PCAPNG_INTERFACE_DESCRIPTION_BLOCK );
+        out = PutU32( out, block_length );
+        out = PutU16( out, LINKTYPE_ISO_14443 );
+        out = PutU16( out, 0 );
+        out = PutU32( out, 0 ); // no snap length
+        out = PutU16( out, PCAPNG_OPT_IF_TSRESOL );
+        out = PutU16( out, 1 );
+        *out++ = 9; // 10^-9 s
+        *out++ = 0;
+        *out++ = 0;
+        *out++ = 0;
+        out = PutU16( out, PCAPNG_OPT_END_OF_OPT );
+        out = PutU16( out, 0 );
+        PutU32( out, block_length );
+    }
+
+    void PcapngWriter::WritePacket( bool is_response, U64 start_sample, const U8* data, size_t length, const char* comment )
+    {
+        if( length > ISO14443_MAX_DATA_LENGTH )
+        {
+            length = ISO14443_MAX_DATA_LENGTH;
+        }
+        size_t packet_length = ISO14443_PSEUDO_HEADER_LENGTH + length;
+        size_t comment_length = comment != nullptr ? strlen( comment ) : 0;
+
+        // block header, interface, timestamp, lengths, packet, epb_flags, comment, end of options, block length
+        size_t block_length = 28 + PaddedLength( packet_length ) + 8 + 4 + 4;
+        if( comment_length > 0 )
+        {
+            block_length += 4 + PaddedLength( comment_length );
+        }
+        U64 timestamp = GetTimestampNs( start_sample );
+
+        U8* out = mOut.Reserve( block_length );
+        U8* block_start = out;
+        out = PutU32( out, PCAPNG_ENHANCED_PACKET_BLOCK );
+        out = PutU32( out, U32( block_length ) );
+        out = PutU32( out, 0 ); // interface
+        out = PutU32( out, U32( timestamp >> 32 ) );
+        out = PutU32( out, U32( timestamp ) );
+        out = PutU32( out, U32( packet_length ) );
+        out = PutU32( out, U32( packet_length ) );
+
+        *out++ = ISO14443_PSEUDO_HEADER_VERSION;
+        *out++ = is_response ? ISO14443_EVENT_PICC_TO_PCD : ISO14443_EVENT_PCD_TO_PICC;
+        *out++ = U8( length >> 8 ); // big endian, as defined by the link type
+        *out++ = U8( length );
+        if( length > 0 )
+        {
+            memcpy( out, data, length );
+        }
+        out += length;
+        while( ( out - block_start ) & 3 )
+        {
+            *out++ = 0;
+        }
+
+        // seen from the PCD, which is the capturing side of a reader
+        out = PutU16( out, PCAPNG_OPT_EPB_FLAGS );
+        out = PutU16( out, 4 );
+        out = PutU32( out, is_response ? PCAPNG_EPB_FLAG_INBOUND : PCAPNG_EPB_FLAG_OUTBOUND );
+        if( comment_length > 0 )
+        {
+            out = PutU16( out, PCAPNG_OPT_COMMENT );
+            out = PutU16( out, U16( comment_length ) );
+            memcpy( out, comment, comment_length );
+            out += comment_length;
+            while( ( out - block_start ) & 3 )
+            {
+                *out++ = 0;
+            }
+        }
+        out = PutU16( out, PCAPNG_OPT_END_OF_OPT );
+        out = PutU16( out, 0 );
+        PutU32( out, U32( block_length ) );
+    }
+
+    // Frames of both directions do not overlap, so at the next SOC the pending packets have broken off.
+    void PcapngWriter::WritePendingPackets()
+    {
+        PendingPacket& pcd = mPending[ 0 ];
+        PendingPacket& picc = mPending[ 1 ];
+        bool picc_first = picc.active && ( !pcd.active || ( picc.start_sample < pcd.start_sample ) );
+        for( U32 i = 0; i < 2; i++ )
+        {
+            bool is_response = ( i == 0 ) == picc_first;
+            PendingPacket& pending = mPending[ is_response ? 1 : 0 ];
+            if( pending.active )
+            {
+                pending.active = false;
+                WritePacket( is_response, pending.start_sample, pending.data.data(), pending.data.size(), "SEQUENCE_ERROR" );
+            }
+        }
+    }
+
+    void PcapngWriter::StartPacket( bool is_response, U64 start_sample )
+    {
+        WritePendingPackets();
+
+        PendingPacket& pending = mPending[ is_response ? 1 : 0 ];
+        pending.data.clear();
+        pending.start_sample = start_sample;
+        pending.valid_bits_in_last_byte = 8;
+        pending.parity_error = false;
+        pending.active = true;
+    }
+
+    void PcapngWriter::AddByte( bool is_response, U8 byte, U8 valid_bits, bool parity_error )
+    {
+        PendingPacket& pending = mPending[ is_response ? 1 : 0 ];
+        if( pending.active )
+        {
+            pending.data.push_back( byte );
+            pending.valid_bits_in_last_byte = valid_bits;
+            pending.parity_error |= parity_error;
+        }
+    }
+
+    void PcapngWriter::EndPacket( bool is_response )
+    {
+        PendingPacket& pending = mPending[ is_response ? 1 : 0 ];
+        if( !pending.active )
+        {
+            return;
+        }
+        pending.active = false;
+
+        char comment[ 64 ] = "";
+        if( pending.parity_error )
+        {
+            snprintf( comment, sizeof( comment ), "PARITY_ERROR" );
+        }
+        else if( !pending.data.empty() && ( pending.valid_bits_in_last_byte != 8 ) )
+        {
+            snprintf( comment, sizeof( comment ), "%u bits in last byte", U32( pending.valid_bits_in_last_byte ) );
+        }
+        WritePacket( is_response, pending.start_sample, pending.data.data(), pending.data.size(), comment );
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef ISO14443A_PCAPNG_WRITER
+#define ISO14443A_PCAPNG_WRITER
+
+#include <cstddef>
+#include "Iso14443aBufferedWriter.h"
+
+namespace Iso14443a
+{
+    // Writes frames as a pcapng file with LINKTYPE_ISO_14443 (264), which Wireshark dissects down to ISO14443-4. Every packet
+    // starts with the pseudo header of the link type (version, event = direction, data length), the timestamps are in ns from
+    // the first sample.
+    class PcapngWriter
+    {
+      public:
+        PcapngWriter();
+
+        bool Open( const char* file_name, U32 sample_rate_hz );
+        // Writes the pending packets and flushes the buffer, returns false if anything could not be written.
+        bool Close();
+
+        // A complete frame. comment is optional (e.g. the frame status) and shows up as packet comment in Wireshark.
+        void WritePacket( bool is_response, U64 start_sample, const U8* data, size_t length, const char* comment );
+
+        // Frame by frame assembly for the result frames of the analyzers (SOC, bytes, EOC), one pending frame per direction. The
+        // decoders only add an EOC to frames without sequence errors, a packet still pending at the next SOC is written with a
+        // SEQUENCE_ERROR comment.
+        void StartPacket( bool is_response, U64 start_sample );
+        void AddByte( bool is_response, U8 byte, U8 valid_bits, bool parity_error );
+        void EndPacket( bool is_response );
+
+      protected:
+        struct PendingPacket
+        {
+            std::vector<U8> data;
+            U64 start_sample{ 0U };
+            U8 valid_bits_in_last_byte{ 8U };
+            bool parity_error{ false };
+            bool active{ false };
+        };
+
+        void WriteSectionHeader();
+        void WriteInterfaceDescription();
+        U64 GetTimestampNs( U64 sample ) const;
+        void WritePendingPackets();
+
+        BufferedWriter mOut;
+        U32 mSampleRateHz;
+
+        PendingPacket mPending[ 2 ]; // PCD, PICC
+    };
+}
+
+#endif // ISO14443A_PCAPNG_WRITER
@@ -0,0 +1,77 @@
+#include "Iso14443aRecordingSink.h"
+
+namespace Iso14443a
+{
+    void RecordingSink::OnMarker( U64 sample, MarkerType type )
+    {
+        AddEvent( EventType::Marker, sample, sample, U64( type ) );
+    }
+
+    void RecordingSink::OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+    {
+        AddEvent( EventType::Sequence, start_sample, end_sample, seq );
+    }
+
+    void RecordingSink::OnStartOfCommunication( U64 start_sample, U64 end_sample )
+    {
+        AddEvent( EventType::StartOfCommunication, start_sample, end_sample, 0 );
+    }
+
+    void RecordingSink::OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+    {
+        AddEvent( EventType::Byte, start_sample, end_sample, byte, valid_bits, parity_error );
+    }
+
+    void RecordingSink::OnEndOfCommunication( U64 start_sample, U64 end_sample )
+    {
+        AddEvent( EventType::EndOfCommunication, start_sample, end_sample, 0 );
+    }
+
+    void RecordingSink::OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample )
+    {
+        AddEvent( EventType::Frame, start_sample, end_sample, mFrames.size() );
+        mFrames.push_back( frame );
+    }
+
+    void RecordingSink::OnResync( U64 start_sample, U64 end_sample, U64 skipped_edges )
+    {
+        AddEvent( EventType::Resync, start_sample, end_sample, skipped_edges );
+    }
+
+    void RecordingSink::Replay( DecoderSink& sink ) const
+    {
+        for( const Event& event : mEvents )
+        {
+            switch( event.type )
+            {
+            case EventType::Marker:
+                sink.OnMarker( event.start_sample, MarkerType( event.value ) );
+                break;
+            case EventType::Sequence:
+                sink.OnSequence( U8( event.value ), event.start_sample, event.end_sample );
+                break;
+            case EventType::StartOfCommunication:
+                sink.OnStartOfCommunication( event.start_sample, event.end_sample );
+                break;
+            case EventType::Byte:
+                sink.OnByte( U8( event.value ), event.valid_bits, event.parity_error, event.start_sample, event.end_sample );
+                break;
+            case EventType::EndOfCommunication:
+                sink.OnEndOfCommunication( event.start_sample, event.end_sample );
+                break;
+            case EventType::Frame:
+                sink.OnFrame( mFrames[ event.value ], event.start_sample, event.end_sample );
+                break;
+            case EventType::Resync:
+                sink.OnResync( event.start_sample, event.end_sample, event.value );
+                break;
+            }
+        }
+    }
+
+    void RecordingSink::Clear()
+    {
+        std::vector<Event>().swap( mEvents );
+        std::vector<DecodedFrame>().swap( mFrames );
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef ISO14443A_RECORDING_SINK
+#define ISO14443A_RECORDING_SINK
+
+#include "Iso14443aDecoderSink.h"
+#include <vector>
+
+namespace Iso14443a
+{
+    // Keeps everything a decoder reports, so it can be handed to another sink later (e.g. a segment decoded on a worker thread).
+    class RecordingSink : public DecoderSink
+    {
+      public:
+        virtual void OnMarker( U64 sample, MarkerType type );
+        virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample );
+        virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample );
+        virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample );
+        virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample );
+        virtual void OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample );
+        virtual void OnResync( U64 start_sample, U64 end_sample, U64 skipped_edges );
+
+        // Reports the recorded calls to the sink in their original order.
+        void Replay( DecoderSink& sink ) const;
+
+        // Drops the recording and frees its memory.
+        void Clear();
+
+      protected:
+        enum class EventType : U8
+        {
+            Marker,
+            Sequence,
+            StartOfCommunication,
+            Byte,
+            EndOfCommunication,
+            Frame,
+            Resync,
+        };
+
+        struct Event
+        {
+            U64 start_sample;
+            U64 end_sample;
+            U64 value; // marker type, sequence, byte, index in mFrames or skipped edges
+            EventType type;
+            U8 valid_bits;
+            bool parity_error;
+        };
+
+        void AddEvent( EventType type, U64 start_sample, U64 end_sample, U64 value, U8 valid_bits = 0, bool parity_error = false )
+        {
+            mEvents.push_back( Event{ start_sample, end_sample, value, type, valid_bits, parity_error } );
+        }
+
+        std::vector<Event> mEvents;
+        std::vector<DecodedFrame> mFrames;
+    };
+}
+
+#endif // ISO14443A_RECORDING_SINK
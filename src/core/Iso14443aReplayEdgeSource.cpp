@@ -0,0 +1,94 @@
+#include "Iso14443aReplayEdgeSource.h"
+#include <limits>
+
+namespace Iso14443a
+{
+    ReplayEdgeSource::ReplayEdgeSource( const U64* edges, U64 edge_count, LineState initial_state, U64 start_sample )
+        : mEdges( edges ),
+          mNextEdge( edges ),
+          mEdgesEnd( edges + edge_count ),
+          mSampleNumber( start_sample ),
+          mBitState( initial_state ),
+          mEndOfStream( false )
+    {
+        // edges at or before the start position are already part of the initial state
+        while( ( mNextEdge != mEdgesEnd ) && ( *mNextEdge <= mSampleNumber ) )
+        {
+            mNextEdge++;
+        }
+        mEdges = mNextEdge;
+    }
+
+    U64 ReplayEdgeSource::GetSampleNumber()
+    {
+        return mSampleNumber;
+    }
+
+    LineState ReplayEdgeSource::GetBitState()
+    {
+        return mBitState;
+    }
+
+    U32 ReplayEdgeSource::AdvanceToAbsPosition( U64 sample_number )
+    {
+        if( sample_number <= mSampleNumber )
+        {
+            return 0;
+        }
+
+        // the decoders only move a few edges at a time, so a linear scan beats a binary search over the whole capture
+        const U64* next_edge = mNextEdge;
+        while( ( next_edge != mEdgesEnd ) && ( *next_edge <= sample_number ) )
+        {
+            next_edge++;
+        }
+        U32 edges_passed = U32( next_edge - mNextEdge );
+
+        mNextEdge = next_edge;
+        mSampleNumber = sample_number;
+        if( edges_passed & 1 )
+        {
+            mBitState = LineState( mBitState ^ 1 );
+        }
+
+        return edges_passed;
+    }
+
+    void ReplayEdgeSource::AdvanceToNextEdge()
+    {
+        if( mNextEdge == mEdgesEnd )
+        {
+            mEndOfStream = true;
+            return;
+        }
+
+        mSampleNumber = *mNextEdge;
+        mNextEdge++;
+        mBitState = LineState( mBitState ^ 1 );
+    }
+
+    U64 ReplayEdgeSource::GetSampleOfNextEdge()
+    {
+        if( mNextEdge == mEdgesEnd )
+        {
+            return std::numeric_limits<U64>::max();
+        }
+
+        return *mNextEdge;
+    }
+
+    bool ReplayEdgeSource::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+    {
+        return ( mNextEdge != mEdgesEnd ) && ( *mNextEdge <= sample_number );
+    }
+
+    bool ReplayEdgeSource::IsEndOfStream()
+    {
+        return mEndOfStream;
+    }
+
+    bool ReplayEdgeSource::HasEdgesLeft()
+    {
+        return mNextEdge != mEdgesEnd;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef ISO14443A_REPLAY_EDGE_SOURCE
+#define ISO14443A_REPLAY_EDGE_SOURCE
+
+#include "Iso14443aEdgeSource.h"
+
+namespace Iso14443a
+{
+    // Edge source over an in-memory list of ascending edge sample numbers, used to replay recorded captures.
+    class ReplayEdgeSource : public EdgeSource
+    {
+      public:
+        ReplayEdgeSource( const U64* edges, U64 edge_count, LineState initial_state, U64 start_sample = 0 );
+
+        virtual U64 GetSampleNumber();
+        virtual LineState GetBitState();
+
+        virtual U32 AdvanceToAbsPosition( U64 sample_number );
+        virtual void AdvanceToNextEdge();
+        virtual U64 GetSampleOfNextEdge();
+        virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number );
+
+        virtual bool IsEndOfStream();
+        virtual bool HasEdgesLeft();
+
+        U64 GetEdgesPassed() const
+        {
+            return U64( mNextEdge - mEdges );
+        }
+
+      protected:
+        const U64* mEdges;
+        const U64* mNextEdge;
+        const U64* mEdgesEnd;
+
+        U64 mSampleNumber;
+        LineState mBitState;
+        bool mEndOfStream;
+    };
+}
+
+#endif // ISO14443A_REPLAY_EDGE_SOURCE
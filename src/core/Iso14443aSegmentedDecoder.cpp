@@ -0,0 +1,78 @@
+#include "Iso14443aSegmentedDecoder.h"
+#include "Iso14443aReplayEdgeSource.h"
+#include "Iso14443aRecordingSink.h"
+#include "Iso14443aOrderedQueue.h"
+#include "Iso14443aWorkStealingPool.h"
+
+namespace Iso14443a
+{
+    void SplitAtIdleGaps( const U64* edges, U64 edge_count, LineState initial_state, LineState idle_state, U64 min_gap_samples,
+                          U64 min_segment_edges, std::vector<EdgeSegment>& segments )
+    {
+        segments.clear();
+        if( edge_count == 0 )
+        {
+            return;
+        }
+
+        EdgeSegment segment{ 0, 0, 0, initial_state };
+        for( U64 i = 1; i < edge_count; i++ )
+        {
+            U64 gap = edges[ i ] - edges[ i - 1 ];
+            // the line toggled i times before the gap
+            LineState gap_state = LineState( initial_state ^ ( i & 1 ) );
+            if( ( gap > min_gap_samples ) && ( gap_state == idle_state ) && ( i - segment.first_edge >= min_segment_edges ) )
+            {
+                segment.edge_count = i - segment.first_edge;
+                segments.push_back( segment );
+                segment = EdgeSegment{ i, 0, edges[ i - 1 ] + gap / 2, gap_state };
+            }
+        }
+        segment.edge_count = edge_count - segment.first_edge;
+        segments.push_back( segment );
+    }
+
+    SegmentedDecoder::SegmentedDecoder( U32 thread_count )
+        : mThreadCount( thread_count ),
+          mMinGapSamples( 0 ),
+          mIdleState( LINE_HIGH ),
+          mMinSegmentEdges( DEFAULT_MIN_SEGMENT_EDGES ),
+          mSegmentCount( 0 ),
+          mStolenSegments( 0 )
+    {
+    }
+
+    void SegmentedDecoder::Setup( U64 min_gap_samples, LineState idle_state, U64 min_segment_edges )
+    {
+        mMinGapSamples = min_gap_samples;
+        mIdleState = idle_state;
+        mMinSegmentEdges = min_segment_edges;
+    }
+
+    void SegmentedDecoder::Decode( const U64* edges, U64 edge_count, LineState initial_state, const SegmentDecodeFunction& decode_segment,
+                                   DecoderSink& sink )
+    {
+        std::vector<EdgeSegment> segments;
+        SplitAtIdleGaps( edges, edge_count, initial_state, mIdleState, mMinGapSamples, mMinSegmentEdges, segments );
+        mSegmentCount = segments.size();
+
+        OrderedQueue<RecordingSink> recordings( segments.size() );
+        WorkStealingPool pool( mThreadCount );
+        pool.Start( U32( segments.size() ), [&]( U32 index ) {
+            const EdgeSegment& segment = segments[ index ];
+            ReplayEdgeSource source( edges + segment.first_edge, segment.edge_count, segment.initial_state, segment.start_sample );
+            decode_segment( source, recordings.GetSlot( index ) );
+            recordings.Publish( index );
+        } );
+
+        // hand the recordings over in order while the workers decode the later segments
+        while( RecordingSink* recording = recordings.WaitForNext() )
+        {
+            recording->Replay( sink );
+            recording->Clear();
+            recordings.PopNext();
+        }
+        pool.Wait();
+        mStolenSegments = pool.GetStolenItems();
+    }
+}
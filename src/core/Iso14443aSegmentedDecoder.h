@@ -0,0 +1,76 @@
+#ifndef ISO14443A_SEGMENTED_DECODER
+#define ISO14443A_SEGMENTED_DECODER
+
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aEdgeSource.h"
+#include "Iso14443aDecoderSink.h"
+#include <functional>
+#include <vector>
+
+namespace Iso14443a
+{
+    // The shortest frame delay time (ISO14443-3) between the end of one frame and the start of the next, in carrier periods.
+    // Within a frame a channel is never idle that long, so a longer gap can only lie between two frames.
+    static const U32 MIN_FRAME_DELAY_CARRIER_PERIODS = 1172;
+
+    inline U64 GetMinFrameDelaySamples( U32 sample_rate_hz, U32 carrier_hz )
+    {
+        return U64( MIN_FRAME_DELAY_CARRIER_PERIODS ) * sample_rate_hz / carrier_hz;
+    }
+
+    // A part of a recorded edge stream that can be decoded on its own: it starts in the middle of an idle gap.
+    struct EdgeSegment
+    {
+        U64 first_edge;
+        U64 edge_count;
+        U64 start_sample;
+        LineState initial_state;
+    };
+
+    // Splits an edge stream at the idle gaps that are longer than min_gap_samples, every segment gets at least
+    // min_segment_edges edges (except the last one). Gaps with the line outside of its idle state are never split.
+    void SplitAtIdleGaps( const U64* edges, U64 edge_count, LineState initial_state, LineState idle_state, U64 min_gap_samples,
+                          U64 min_segment_edges, std::vector<EdgeSegment>& segments );
+
+    // Decodes a recorded edge stream in segments on several threads. Each segment is decoded into its own recording, the
+    // recordings are reported to the sink in sample order on the calling thread, so the sink sees the same calls as with a
+    // single decoder over the whole stream.
+    class SegmentedDecoder
+    {
+      public:
+        // Sets up a decoder for the source and decodes all of its frames into the sink, called on the worker threads.
+        typedef std::function<void( EdgeSource& source, DecoderSink& sink )> SegmentDecodeFunction;
+
+        // small segments cost more in setup and hand over than they gain in parallelism
+        static const U64 DEFAULT_MIN_SEGMENT_EDGES = 16384;
+
+        explicit SegmentedDecoder( U32 thread_count );
+
+        // The gaps must be longer than anything a decoder waits for after a frame, e.g. its resync gap.
+        void Setup( U64 min_gap_samples, LineState idle_state, U64 min_segment_edges = DEFAULT_MIN_SEGMENT_EDGES );
+
+        void Decode( const U64* edges, U64 edge_count, LineState initial_state, const SegmentDecodeFunction& decode_segment,
+                     DecoderSink& sink );
+
+        U64 GetSegmentCount() const
+        {
+            return mSegmentCount;
+        }
+
+        U64 GetStolenSegments() const
+        {
+            return mStolenSegments;
+        }
+
+      protected:
+        U32 mThreadCount;
+        U64 mMinGapSamples;
+        LineState mIdleState;
+        U64 mMinSegmentEdges;
+
+        U64 mSegmentCount;
+        U64 mStolenSegments;
+    };
+}
+
+#endif // ISO14443A_SEGMENTED_DECODER
@@ -0,0 +1,62 @@
+#ifndef ISO14443A_SEQUENCE_TABLES
+#define ISO14443A_SEQUENCE_TABLES
+
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Meaning of a sequence in the data part of a frame, the values of the bits are the bits themselves.
+    static const U8 SEQ_RESULT_BIT_0 = 0;
+    static const U8 SEQ_RESULT_BIT_1 = 1;
+    static const U8 SEQ_RESULT_EOC = 2;
+    static const U8 SEQ_RESULT_ERROR = 3;
+
+    // Modified Miller: X is a logic "1", a logic "0" is Z after a "0" and Y after a "1". Y after a "0" ends the frame.
+    constexpr U8 ClassifyAskSequence( U8 last_bit, U8 seq )
+    {
+        return ( seq == ASK_SEQ_X ) ? SEQ_RESULT_BIT_1
+               : ( ( last_bit == 0 ) && ( seq == ASK_SEQ_Z ) ) || ( ( last_bit == 1 ) && ( seq == ASK_SEQ_Y ) ) ? SEQ_RESULT_BIT_0
+               : ( ( last_bit == 0 ) && ( seq == ASK_SEQ_Y ) ) ? SEQ_RESULT_EOC
+                                                                 : SEQ_RESULT_ERROR;
+    }
+
+    // Manchester: D is a logic "1", E a logic "0" and F ends the frame.
+    constexpr U8 ClassifyLoadmodSequence( U8 seq )
+    {
+        return ( seq == LOADMOD_SEQ_D ) ? SEQ_RESULT_BIT_1
+               : ( seq == LOADMOD_SEQ_E ) ? SEQ_RESULT_BIT_0
+               : ( seq == LOADMOD_SEQ_F ) ? SEQ_RESULT_EOC
+                                          : SEQ_RESULT_ERROR;
+    }
+
+    // The classifications above are evaluated by the compiler into tables with 2 bit per entry. The sequence codes (including
+    // the error codes) fit into 3 bits, so the ASK table has 2 x 8 entries and fits into 32 bits, the LOADMOD table into 16 bits.
+    // Looking a sequence up is a shift and a mask instead of a chain of compares per bit.
+    constexpr U32 BuildAskSequenceTable( U32 index = 0 )
+    {
+        return ( index == 16 ) ? 0
+                               : ( U32( ClassifyAskSequence( U8( index >> 3 ), U8( index & 7 ) ) ) << ( 2 * index ) ) |
+                                     BuildAskSequenceTable( index + 1 );
+    }
+
+    constexpr U32 BuildLoadmodSequenceTable( U32 index = 0 )
+    {
+        return ( index == 8 ) ? 0
+                              : ( U32( ClassifyLoadmodSequence( U8( index ) ) ) << ( 2 * index ) ) | BuildLoadmodSequenceTable( index + 1 );
+    }
+
+    static constexpr U32 ASK_SEQUENCE_TABLE = BuildAskSequenceTable();
+    static constexpr U32 LOADMOD_SEQUENCE_TABLE = BuildLoadmodSequenceTable();
+
+    inline U8 LookupAskSequence( U8 last_bit, U8 seq )
+    {
+        return U8( ( ASK_SEQUENCE_TABLE >> ( 2 * ( ( ( last_bit & 1 ) << 3 ) | ( seq & 7 ) ) ) ) & 3 );
+    }
+
+    inline U8 LookupLoadmodSequence( U8 seq )
+    {
+        return U8( ( LOADMOD_SEQUENCE_TABLE >> ( 2 * ( seq & 7 ) ) ) & 3 );
+    }
+}
+
+#endif // ISO14443A_SEQUENCE_TABLES
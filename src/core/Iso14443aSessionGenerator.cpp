@@ -0,0 +1,78 @@
+#include "Iso14443aSessionGenerator.h"
+
+namespace Iso14443a
+{
+    // default delays from the end of a frame to the start of the next one, the PICC answers after its frame delay time and the PCD
+    // waits a bit longer before the next command
+    static const U64 RESPONSE_DELAY_CYCLES = 1024;
+    static const U64 COMMAND_DELAY_CYCLES = 2048;
+
+    SessionGenerator::SessionGenerator( WaveformSink& pcd_sink, WaveformSink& picc_sink )
+        : mPcdGenerator( pcd_sink ),
+          mPiccGenerator( picc_sink ),
+          mNextFrame( 0 ),
+          mSampleRateHz( 1 ),
+          mCarrierHz( 1 ),
+          mPosition( 0 ),
+          mFrameCount( 0 ),
+          mForcePcdBitRate( false ),
+          mPcdBitRate( BitRate::Fc128 )
+    {
+    }
+
+    void SessionGenerator::Setup( U32 sample_rate_hz, U32 carrier_hz, const std::vector<ScriptFrame>& frames )
+    {
+        mSampleRateHz = sample_rate_hz;
+        mCarrierHz = carrier_hz;
+        mPcdGenerator.Setup( sample_rate_hz, carrier_hz );
+        mPiccGenerator.Setup( sample_rate_hz, carrier_hz );
+        mFrames = frames;
+        mNextFrame = 0;
+        mFrameCount = 0;
+
+        // some idle time before the first frame, so the decoders see the idle line
+        mPcdGenerator.SkipCarrierCycles( COMMAND_DELAY_CYCLES );
+        mPosition = mPcdGenerator.GetPosition();
+    }
+
+    void SessionGenerator::AddNextFrame()
+    {
+        if( mFrames.empty() )
+        {
+            mPosition += mSampleRateHz / 1000;
+            return;
+        }
+
+        const ScriptFrame& frame = mFrames[ mNextFrame ];
+        mNextFrame = ( mNextFrame + 1 ) % mFrames.size();
+
+        if( frame.idle_us > 0 )
+        {
+            mPosition += U64( frame.idle_us ) * mSampleRateHz / 1000000;
+            return;
+        }
+
+        WaveformGenerator& generator = frame.is_response ? static_cast<WaveformGenerator&>( mPiccGenerator ) : mPcdGenerator;
+        generator.SkipTo( mPosition );
+        if( frame.gap_us > 0 )
+        {
+            generator.SkipTo( mPosition + U64( frame.gap_us ) * mSampleRateHz / 1000000 );
+        }
+        else
+        {
+            generator.SkipCarrierCycles( frame.is_response ? RESPONSE_DELAY_CYCLES : COMMAND_DELAY_CYCLES );
+        }
+
+        if( frame.is_response )
+        {
+            mPiccGenerator.AddFrame( frame.data.data(), frame.data.size(), frame.valid_bits_in_last_byte );
+        }
+        else
+        {
+            mPcdGenerator.SetBitRate( mForcePcdBitRate ? mPcdBitRate : frame.bit_rate );
+            mPcdGenerator.AddFrame( frame.data.data(), frame.data.size(), frame.valid_bits_in_last_byte );
+        }
+        mPosition = generator.GetPosition();
+        mFrameCount++;
+    }
+}
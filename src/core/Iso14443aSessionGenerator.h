@@ -0,0 +1,58 @@
+#ifndef ISO14443A_SESSION_GENERATOR
+#define ISO14443A_SESSION_GENERATOR
+
+#include "Iso14443aFrameScript.h"
+#include "Iso14443aWaveformGenerator.h"
+
+namespace Iso14443a
+{
+    // Plays a frame script on both directions with one time line: the PCD frames as ASK, the PICC frames as load modulation.
+    // A direction without sink is only timed. The script is repeated endlessly.
+    class SessionGenerator
+    {
+      public:
+        SessionGenerator( WaveformSink& pcd_sink, WaveformSink& picc_sink );
+
+        void Setup( U32 sample_rate_hz, U32 carrier_hz, const std::vector<ScriptFrame>& frames );
+        // all PCD frames at this bit rate instead of the one of the script
+        void SetPcdBitRate( BitRate bit_rate )
+        {
+            mForcePcdBitRate = true;
+            mPcdBitRate = bit_rate;
+        }
+
+        // the PICC line is the demodulated envelope instead of the subcarrier
+        void SetPiccEnvelope( bool envelope )
+        {
+            mPiccGenerator.SetEnvelope( envelope );
+        }
+
+        // generates the next frame (or idle time) of the script
+        void AddNextFrame();
+
+        // end of the last frame on the time line
+        U64 GetPosition() const
+        {
+            return mPosition;
+        }
+        U64 GetFrameCount() const
+        {
+            return mFrameCount;
+        }
+
+      protected:
+        AskWaveformGenerator mPcdGenerator;
+        LoadmodWaveformGenerator mPiccGenerator;
+
+        std::vector<ScriptFrame> mFrames;
+        size_t mNextFrame;
+        U32 mSampleRateHz;
+        U32 mCarrierHz;
+        U64 mPosition;
+        U64 mFrameCount;
+        bool mForcePcdBitRate;
+        BitRate mPcdBitRate;
+    };
+}
+
+#endif // ISO14443A_SESSION_GENERATOR
@@ -0,0 +1,78 @@
+#include "Iso14443aSubcarrierDetector.h"
+
+namespace Iso14443a
+{
+    SubcarrierDetector::SubcarrierDetector( EdgeSource& source )
+        : mSource( source ),
+          mIdleState( LINE_LOW ),
+          mMinBurstGap( 0.0 ),
+          mLastEdgeSample( 0 ),
+          mBurstStartSample( 0 ),
+          mMinModulatedEdges( 4 ),
+          mMaxUnmodulatedEdges( 2 ),
+          mMinEdgeDistance( 0.0 ),
+          mMaxEdgeDistance( 0.0 )
+    {
+    }
+
+    void SubcarrierDetector::Setup( double samples_per_bit, LineState idle_state )
+    {
+        // subcarrier = fc / 16, a bit is fc / 128 long, so there are 16 subcarrier half periods per bit
+        double subcarrier_half_period = samples_per_bit / 16;
+
+        mIdleState = idle_state;
+        mMinBurstGap = samples_per_bit / 4;
+        mMinEdgeDistance = subcarrier_half_period * 0.5;
+        mMaxEdgeDistance = subcarrier_half_period * 1.5;
+    }
+
+    SubcarrierDetector::HalfBit SubcarrierDetector::DetectHalfBit( U64 window_start_sample, U64 window_end_sample )
+    {
+        U32 edges = 0;
+        U64 first_edge_sample = 0;
+        U64 last_edge_sample = 0;
+
+        // a jittered subcarrier edge of a neighbouring half bit may slip over the window borders, so an unmodulated half bit
+        // is checked for idle state in its middle
+        U64 window_middle_sample = window_start_sample + ( window_end_sample - window_start_sample ) / 2;
+        LineState middle_state = mSource.GetBitState();
+
+        while( mSource.WouldAdvancingToAbsPositionCauseTransition( window_end_sample - 1 ) )
+        {
+            U64 next_edge_sample = mSource.GetSampleOfNextEdge();
+            mSource.AdvanceToNextEdge();
+            if( next_edge_sample < window_middle_sample )
+            {
+                middle_state = mSource.GetBitState();
+            }
+
+            if( edges == 0 )
+            {
+                first_edge_sample = next_edge_sample;
+            }
+            last_edge_sample = next_edge_sample;
+            edges++;
+
+            if( double( next_edge_sample - mLastEdgeSample ) >= mMinBurstGap )
+            {
+                mBurstStartSample = next_edge_sample;
+            }
+            mLastEdgeSample = next_edge_sample;
+        }
+
+        if( edges >= mMinModulatedEdges )
+        {
+            double mean_edge_distance = double( last_edge_sample - first_edge_sample ) / double( edges - 1 );
+            if( ( mean_edge_distance >= mMinEdgeDistance ) && ( mean_edge_distance <= mMaxEdgeDistance ) )
+            {
+                return HalfBit::Modulated;
+            }
+        }
+        else if( ( edges <= mMaxUnmodulatedEdges ) && ( middle_state == mIdleState ) )
+        {
+            return HalfBit::Unmodulated;
+        }
+
+        return HalfBit::Invalid;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef ISO14443A_SUBCARRIER_DETECTOR
+#define ISO14443A_SUBCARRIER_DETECTOR
+
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aEdgeSource.h"
+
+namespace Iso14443a
+{
+    // Decides if a half bit carries the fc/16 (847 kHz) subcarrier from the edges inside of it. The thresholds are derived from
+    // the bit duration, so the decision does not depend on the sample rate.
+    class SubcarrierDetector
+    {
+      public:
+        enum class HalfBit
+        {
+            Unmodulated,
+            Modulated,
+            Invalid,
+        };
+
+        SubcarrierDetector( EdgeSource& source );
+
+        void Setup( double samples_per_bit, LineState idle_state );
+
+        // Walks all edges up to window_end_sample (exclusive), starting at the current position of the source. Edges behind the
+        // window are not looked at, so the last half bit of a frame is decided without waiting for the next frame.
+        HalfBit DetectHalfBit( U64 window_start_sample, U64 window_end_sample );
+
+        // The first edge after an idle gap of at least a quarter bit, i.e. where the subcarrier started after an unmodulated half
+        // bit. It may lie in an earlier window than the modulated half bit it belongs to.
+        U64 GetBurstStartSample() const
+        {
+            return mBurstStartSample;
+        }
+
+      protected:
+        EdgeSource& mSource;
+        LineState mIdleState;
+
+        double mMinBurstGap;
+        U64 mLastEdgeSample;
+        U64 mBurstStartSample;
+
+        // a half bit has 8 subcarrier edges, at least half of them must be seen
+        U32 mMinModulatedEdges;
+        U32 mMaxUnmodulatedEdges;
+
+        // the mean distance of the edges must be within 1/2 and 3/2 of a subcarrier half period
+        double mMinEdgeDistance;
+        double mMaxEdgeDistance;
+    };
+}
+
+#endif // ISO14443A_SUBCARRIER_DETECTOR
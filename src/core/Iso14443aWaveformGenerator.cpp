@@ -0,0 +1,181 @@
+#include "Iso14443aWaveformGenerator.h"
+
+namespace Iso14443a
+{
+    // pause length t1 of the Modified Miller coding, 36 carrier cycles at 106 kbit/s and scaled down with the bit length
+    static const U32 ASK_PAUSE_CYCLES_PER_128 = 36;
+
+    static const U32 LOADMOD_CYCLES_PER_BIT = 128;
+    static const U32 LOADMOD_SUBCARRIER_HALF_PERIOD = 8;
+
+    WaveformGenerator::WaveformGenerator( WaveformSink& sink ) : mSink( sink ), mSampleRateHz( 1 ), mCarrierHz( 1 ), mPosition( 0 )
+    {
+    }
+
+    void WaveformGenerator::SetupTiming( U32 sample_rate_hz, U32 carrier_hz )
+    {
+        mSampleRateHz = sample_rate_hz;
+        mCarrierHz = carrier_hz != 0 ? carrier_hz : 1;
+        mPosition = 0;
+    }
+
+    U64 WaveformGenerator::CarrierCyclesToFixed( U64 cycles ) const
+    {
+        U64 samples = cycles * mSampleRateHz;
+        return ( ( samples / mCarrierHz ) << FIXED_SHIFT ) + ( ( samples % mCarrierHz ) << FIXED_SHIFT ) / mCarrierHz;
+    }
+
+    void WaveformGenerator::AddPulse( SequenceTemplate& sequence, U64 start_cycles, U64 length_cycles ) const
+    {
+        sequence.offsets[ sequence.count++ ] = CarrierCyclesToFixed( start_cycles );
+        sequence.offsets[ sequence.count++ ] = CarrierCyclesToFixed( start_cycles + length_cycles );
+    }
+
+    void WaveformGenerator::AddEdge( SequenceTemplate& sequence, U64 cycles ) const
+    {
+        sequence.offsets[ sequence.count++ ] = CarrierCyclesToFixed( cycles );
+    }
+
+    void WaveformGenerator::SkipTo( U64 sample )
+    {
+        U64 position = sample << FIXED_SHIFT;
+        if( position > mPosition )
+        {
+            mPosition = position;
+        }
+    }
+
+    void WaveformGenerator::SkipCarrierCycles( U64 cycles )
+    {
+        mPosition += CarrierCyclesToFixed( cycles );
+    }
+
+    AskWaveformGenerator::AskWaveformGenerator( WaveformSink& sink )
+        : WaveformGenerator( sink ), mBitRate( BitRate::Fc128 ), mPreviousBit( false ), mBitLength{}
+    {
+    }
+
+    void AskWaveformGenerator::Setup( U32 sample_rate_hz, U32 carrier_hz )
+    {
+        SetupTiming( sample_rate_hz, carrier_hz );
+        for( U32 rate = 0; rate < BIT_RATE_COUNT; rate++ )
+        {
+            U32 bit_cycles = GetCarrierCyclesPerBit( BitRate( rate ) );
+            U32 pause_cycles = ( ASK_PAUSE_CYCLES_PER_128 * bit_cycles ) / 128;
+            mBitLength[ rate ] = CarrierCyclesToFixed( bit_cycles );
+
+            SequenceTemplate* sequences = mSequences[ rate ];
+            sequences[ ASK_SEQ_Y ] = SequenceTemplate();
+            sequences[ ASK_SEQ_X ] = SequenceTemplate();
+            sequences[ ASK_SEQ_Z ] = SequenceTemplate();
+            AddPulse( sequences[ ASK_SEQ_X ], bit_cycles / 2, pause_cycles );
+            AddPulse( sequences[ ASK_SEQ_Z ], 0, pause_cycles );
+        }
+    }
+
+    void AskWaveformGenerator::AddBit( bool bit )
+    {
+        // a 0 after a 0 (or the SOC) has its pause at the start of the bit
+        U8 seq = bit ? ASK_SEQ_X : ( mPreviousBit ? ASK_SEQ_Y : ASK_SEQ_Z );
+        EmitSequence( mSequences[ U32( mBitRate ) ][ seq ], mBitLength[ U32( mBitRate ) ] );
+        mPreviousBit = bit;
+    }
+
+    void AskWaveformGenerator::AddFrame( const U8* data, size_t length, U8 valid_bits_in_last_byte )
+    {
+        const SequenceTemplate* sequences = mSequences[ U32( mBitRate ) ];
+        U64 bit_length = mBitLength[ U32( mBitRate ) ];
+
+        EmitSequence( sequences[ ASK_SEQ_Z ], bit_length ); // SOC
+        mPreviousBit = false;
+        for( size_t i = 0; i < length; i++ )
+        {
+            U8 byte = data[ i ];
+            U32 bits = ( i + 1 == length ) ? valid_bits_in_last_byte : 8;
+            for( U32 bit = 0; bit < bits; bit++ )
+            {
+                AddBit( ( ( byte >> bit ) & 1 ) != 0 );
+            }
+            if( bits == 8 )
+            {
+                AddBit( !HasOddOnesCount( byte ) );
+            }
+        }
+
+        // EOC: a logic 0 followed by Y
+        AddBit( false );
+        EmitSequence( sequences[ ASK_SEQ_Y ], bit_length );
+    }
+
+    LoadmodWaveformGenerator::LoadmodWaveformGenerator( WaveformSink& sink )
+        : WaveformGenerator( sink ), mBitLength( 0 ), mEnvelope( false ), mEnvelopeActive( false )
+    {
+    }
+
+    void LoadmodWaveformGenerator::Setup( U32 sample_rate_hz, U32 carrier_hz )
+    {
+        SetupTiming( sample_rate_hz, carrier_hz );
+        mBitLength = CarrierCyclesToFixed( LOADMOD_CYCLES_PER_BIT );
+
+        mSequences[ LOADMOD_SEQ_F ] = SequenceTemplate();
+        mSequences[ LOADMOD_SEQ_E ] = SequenceTemplate();
+        mSequences[ LOADMOD_SEQ_D ] = SequenceTemplate();
+        // four subcarrier periods in one bit half
+        for( U32 period = 0; period < 4; period++ )
+        {
+            U32 start = period * 2 * LOADMOD_SUBCARRIER_HALF_PERIOD;
+            AddPulse( mSequences[ LOADMOD_SEQ_D ], start, LOADMOD_SUBCARRIER_HALF_PERIOD );
+            AddPulse( mSequences[ LOADMOD_SEQ_E ], LOADMOD_CYCLES_PER_BIT / 2 + start, LOADMOD_SUBCARRIER_HALF_PERIOD );
+        }
+
+        for( U32 active = 0; active < 2; active++ )
+        {
+            for( U8 seq = LOADMOD_SEQ_F; seq <= LOADMOD_SEQ_D; seq++ )
+            {
+                SequenceTemplate& sequence = mEnvelopeSequences[ active ][ seq ];
+                sequence = SequenceTemplate();
+                bool first_half = ( seq & 0b10 ) != 0;
+                bool second_half = ( seq & 0b01 ) != 0;
+                if( first_half != ( active != 0 ) )
+                {
+                    AddEdge( sequence, 0 );
+                }
+                if( second_half != first_half )
+                {
+                    AddEdge( sequence, LOADMOD_CYCLES_PER_BIT / 2 );
+                }
+            }
+        }
+        mEnvelopeActive = false;
+    }
+
+    void LoadmodWaveformGenerator::AddSequence( U8 seq )
+    {
+        if( mEnvelope )
+        {
+            EmitSequence( mEnvelopeSequences[ mEnvelopeActive ? 1 : 0 ][ seq ], mBitLength );
+            mEnvelopeActive = ( seq & 0b01 ) != 0;
+            return;
+        }
+        EmitSequence( mSequences[ seq ], mBitLength );
+    }
+
+    void LoadmodWaveformGenerator::AddFrame( const U8* data, size_t length, U8 valid_bits_in_last_byte )
+    {
+        AddSequence( LOADMOD_SEQ_D ); // SOC
+        for( size_t i = 0; i < length; i++ )
+        {
+            U8 byte = data[ i ];
+            U32 bits = ( i + 1 == length ) ? valid_bits_in_last_byte : 8;
+            for( U32 bit = 0; bit < bits; bit++ )
+            {
+                AddSequence( ( ( byte >> bit ) & 1 ) ? LOADMOD_SEQ_D : LOADMOD_SEQ_E );
+            }
+            if( bits == 8 )
+            {
+                AddSequence( HasOddOnesCount( byte ) ? LOADMOD_SEQ_E : LOADMOD_SEQ_D );
+            }
+        }
+        AddSequence( LOADMOD_SEQ_F ); // EOC
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef ISO14443A_WAVEFORM_GENERATOR
+#define ISO14443A_WAVEFORM_GENERATOR
+
+#include <cstddef>
+#include "Iso14443aDecoderTypes.h"
+
+namespace Iso14443a
+{
+    // Receives the edges of a generated waveform in increasing sample order, e.g. a simulation channel or an edge file.
+    class WaveformSink
+    {
+      public:
+        virtual ~WaveformSink()
+        {
+        }
+
+        virtual void OnEdge( U64 sample ) = 0;
+
+        // the waveform ends at the sample, edges that are held back have to be passed on now
+        virtual void Flush( U64 end_sample )
+        {
+        }
+    };
+
+    // Drops all edges, for a direction that is only timed but not generated.
+    class NullWaveformSink : public WaveformSink
+    {
+      public:
+        virtual void OnEdge( U64 sample )
+        {
+        }
+    };
+
+    // Turns frames into edges. Every sequence is a precomputed template of edge offsets, the position is kept in 1/65536 samples,
+    // so the non integer bit lengths (e.g. 943.95 samples at 100 MS/s) do not drift.
+    class WaveformGenerator
+    {
+      public:
+        explicit WaveformGenerator( WaveformSink& sink );
+
+        // end of the last frame
+        U64 GetPosition() const
+        {
+            return ( mPosition + FIXED_HALF ) >> FIXED_SHIFT;
+        }
+
+        // idle line up to the sample, does nothing if the position is already past it
+        void SkipTo( U64 sample );
+        void SkipCarrierCycles( U64 cycles );
+
+      protected:
+        static const U32 FIXED_SHIFT = 16;
+        static const U64 FIXED_HALF = 1ULL << ( FIXED_SHIFT - 1 );
+        static const U32 MAX_TEMPLATE_EDGES = 8;
+
+        struct SequenceTemplate
+        {
+            U64 offsets[ MAX_TEMPLATE_EDGES ];
+            U32 count{ 0U };
+        };
+
+        void SetupTiming( U32 sample_rate_hz, U32 carrier_hz );
+        U64 CarrierCyclesToFixed( U64 cycles ) const;
+        void AddPulse( SequenceTemplate& sequence, U64 start_cycles, U64 length_cycles ) const;
+        void AddEdge( SequenceTemplate& sequence, U64 cycles ) const;
+
+        void EmitSequence( const SequenceTemplate& sequence, U64 length )
+        {
+            for( U32 i = 0; i < sequence.count; i++ )
+            {
+                mSink.OnEdge( ( mPosition + sequence.offsets[ i ] + FIXED_HALF ) >> FIXED_SHIFT );
+            }
+            mPosition += length;
+        }
+
+        WaveformSink& mSink;
+        U32 mSampleRateHz;
+        U32 mCarrierHz;
+        U64 mPosition;
+    };
+
+    // PCD to PICC: 100% ASK with Modified Miller coding, all four bit rates. A pause is low on a line that idles high.
+    class AskWaveformGenerator : public WaveformGenerator
+    {
+      public:
+        explicit AskWaveformGenerator( WaveformSink& sink );
+
+        void Setup( U32 sample_rate_hz, U32 carrier_hz );
+        void SetBitRate( BitRate bit_rate )
+        {
+            mBitRate = bit_rate;
+        }
+
+        // SOC, the data (complete bytes with odd parity) and EOC
+        void AddFrame( const U8* data, size_t length, U8 valid_bits_in_last_byte );
+
+      protected:
+        void AddBit( bool bit );
+
+        BitRate mBitRate;
+        bool mPreviousBit;
+        U64 mBitLength[ BIT_RATE_COUNT ];
+        SequenceTemplate mSequences[ BIT_RATE_COUNT ][ 3 ]; // indexed by ASK_SEQ_Y, ASK_SEQ_X, ASK_SEQ_Z
+    };
+
+    // PICC to PCD: load modulation with a fc/16 subcarrier and Manchester coding (106 kbit/s). The line follows the subcarrier
+    // and idles low, or with SetEnvelope() it is the demodulated envelope that is active for each modulated bit half.
+    class LoadmodWaveformGenerator : public WaveformGenerator
+    {
+      public:
+        explicit LoadmodWaveformGenerator( WaveformSink& sink );
+
+        void Setup( U32 sample_rate_hz, U32 carrier_hz );
+        void SetEnvelope( bool envelope )
+        {
+            mEnvelope = envelope;
+        }
+
+        // SOC, the data (complete bytes with odd parity) and EOC
+        void AddFrame( const U8* data, size_t length, U8 valid_bits_in_last_byte );
+
+      protected:
+        void AddSequence( U8 seq );
+
+        U64 mBitLength;
+        bool mEnvelope;
+        bool mEnvelopeActive;
+        SequenceTemplate mSequences[ 3 ]; // indexed by LOADMOD_SEQ_F, LOADMOD_SEQ_E, LOADMOD_SEQ_D
+        // the envelope only has edges where the level changes, so its templates depend on the level at the end of the last one
+        SequenceTemplate mEnvelopeSequences[ 2 ][ 3 ];
+    };
+}
+
+#endif // ISO14443A_WAVEFORM_GENERATOR
@@ -0,0 +1,160 @@
+#include "Iso14443aWaveformImpairments.h"
+
+namespace Iso14443a
+{
+    PulseJitterFilter::PulseJitterFilter( WaveformSink& sink, U64 max_shift, U64 seed )
+        : mSink( sink ), mRandom( seed ), mMaxShift( max_shift ), mInPulse( false ), mPulseStart( 0 ), mHasPending( false ), mPending( 0 )
+    {
+    }
+
+    void PulseJitterFilter::OnEdge( U64 sample )
+    {
+        if( !mInPulse )
+        {
+            // the end of the previous pulse has to stay before this edge
+            if( mHasPending )
+            {
+                mSink.OnEdge( mPending < sample ? mPending : sample - 1 );
+                mHasPending = false;
+            }
+            mSink.OnEdge( sample );
+            mPulseStart = sample;
+            mInPulse = true;
+            return;
+        }
+
+        mInPulse = false;
+        if( mMaxShift == 0 )
+        {
+            mSink.OnEdge( sample );
+            return;
+        }
+
+        U64 shift = mRandom.Below( 2 * mMaxShift + 1 );
+        U64 end = sample + shift;
+        end = end > mMaxShift ? end - mMaxShift : 0;
+        mPending = end > mPulseStart ? end : mPulseStart + 1;
+        mHasPending = true;
+    }
+
+    void PulseJitterFilter::Flush( U64 end_sample )
+    {
+        if( mHasPending )
+        {
+            mSink.OnEdge( mPending );
+            mHasPending = false;
+        }
+        mSink.Flush( end_sample );
+    }
+
+    PulseDropoutFilter::PulseDropoutFilter( WaveformSink& sink, U32 rate_ppm, U32 run_length, U64 seed )
+        : mSink( sink ),
+          mRandom( seed ),
+          mRatePpm( rate_ppm ),
+          mRunLength( run_length != 0 ? run_length : 1 ),
+          mInPulse( false ),
+          mDropping( false ),
+          mRunLeft( 0 ),
+          mDroppedPulses( 0 )
+    {
+    }
+
+    void PulseDropoutFilter::OnEdge( U64 sample )
+    {
+        if( mInPulse )
+        {
+            mInPulse = false;
+            if( !mDropping )
+            {
+                mSink.OnEdge( sample );
+            }
+            return;
+        }
+
+        mInPulse = true;
+        if( mRunLeft > 0 )
+        {
+            mRunLeft--;
+            mDropping = true;
+        }
+        else
+        {
+            mDropping = ( mRatePpm != 0 ) && ( mRandom.Below( 1000000 ) < mRatePpm );
+            if( mDropping )
+            {
+                mRunLeft = mRunLength - 1;
+            }
+        }
+
+        if( mDropping )
+        {
+            mDroppedPulses++;
+        }
+        else
+        {
+            mSink.OnEdge( sample );
+        }
+    }
+
+    void PulseDropoutFilter::Flush( U64 end_sample )
+    {
+        mSink.Flush( end_sample );
+    }
+
+    GlitchFilter::GlitchFilter( WaveformSink& sink, U64 mean_interval, U64 width, U64 seed )
+        : mSink( sink ),
+          mRandom( seed ),
+          mMeanInterval( mean_interval ),
+          mWidth( width != 0 ? width : 1 ),
+          mNextGlitch( 0 ),
+          mLastEdge( 0 ),
+          mHasEdge( false ),
+          mGlitches( 0 )
+    {
+        if( mMeanInterval != 0 )
+        {
+            ScheduleNext();
+        }
+    }
+
+    void GlitchFilter::ScheduleNext()
+    {
+        // uniform distance between 1 and twice the mean interval
+        mNextGlitch += 1 + mRandom.Below( 2 * mMeanInterval );
+    }
+
+    void GlitchFilter::AddGlitchesBefore( U64 sample )
+    {
+        if( mMeanInterval == 0 )
+        {
+            return;
+        }
+
+        while( mNextGlitch + mWidth < sample )
+        {
+            if( !mHasEdge || ( mNextGlitch > mLastEdge ) )
+            {
+                mSink.OnEdge( mNextGlitch );
+                mSink.OnEdge( mNextGlitch + mWidth );
+                mLastEdge = mNextGlitch + mWidth;
+                mHasEdge = true;
+                mGlitches++;
+            }
+            ScheduleNext();
+        }
+    }
+
+    void GlitchFilter::OnEdge( U64 sample )
+    {
+        AddGlitchesBefore( sample );
+        mSink.OnEdge( sample );
+        mLastEdge = sample;
+        mHasEdge = true;
+    }
+
+    void GlitchFilter::Flush( U64 end_sample )
+    {
+        AddGlitchesBefore( end_sample );
+        mSink.Flush( end_sample );
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef ISO14443A_WAVEFORM_IMPAIRMENTS
+#define ISO14443A_WAVEFORM_IMPAIRMENTS
+
+#include "Iso14443aWaveformGenerator.h"
+
+// Filters between a waveform generator and its sink that make the generated edges look like a real capture. The generators
+// write pulses, every pulse is a pair of edges (pause or subcarrier period) that starts and ends on the idle line, so the
+// filters know which edge ends a pulse without looking at the line state.
+namespace Iso14443a
+{
+    // xorshift64*, the same seed gives the same capture on every platform (unlike the std distributions)
+    class ImpairmentRandom
+    {
+      public:
+        explicit ImpairmentRandom( U64 seed ) : mState( seed ^ 0x9E3779B97F4A7C15ULL )
+        {
+            if( mState == 0 )
+            {
+                mState = 1;
+            }
+        }
+
+        U64 Next()
+        {
+            mState ^= mState >> 12;
+            mState ^= mState << 25;
+            mState ^= mState >> 27;
+            return mState * 0x2545F4914F6CDD1DULL;
+        }
+
+        // 0 ... limit - 1, limit must not be 0
+        U64 Below( U64 limit )
+        {
+            return Next() % limit;
+        }
+
+      protected:
+        U64 mState;
+    };
+
+    // Moves the end of every pulse by up to +-max_shift samples, which changes the pause width (ASK) or the duty cycle of the
+    // subcarrier (LOADMOD). The end is held back until the next edge, so it never reaches the edges around it.
+    class PulseJitterFilter : public WaveformSink
+    {
+      public:
+        PulseJitterFilter( WaveformSink& sink, U64 max_shift, U64 seed );
+
+        virtual void OnEdge( U64 sample );
+        virtual void Flush( U64 end_sample );
+
+      protected:
+        WaveformSink& mSink;
+        ImpairmentRandom mRandom;
+        U64 mMaxShift;
+        bool mInPulse;
+        U64 mPulseStart;
+        bool mHasPending;
+        U64 mPending;
+    };
+
+    // Drops pulses with a probability of rate_ppm per million pulses, every dropout removes run_length pulses in a row,
+    // e.g. missing subcarrier periods of a weakly coupled PICC.
+    class PulseDropoutFilter : public WaveformSink
+    {
+      public:
+        PulseDropoutFilter( WaveformSink& sink, U32 rate_ppm, U32 run_length, U64 seed );
+
+        virtual void OnEdge( U64 sample );
+        virtual void Flush( U64 end_sample );
+
+        U64 GetDroppedPulses() const
+        {
+            return mDroppedPulses;
+        }
+
+      protected:
+        WaveformSink& mSink;
+        ImpairmentRandom mRandom;
+        U32 mRatePpm;
+        U32 mRunLength;
+        bool mInPulse;
+        bool mDropping;
+        U32 mRunLeft;
+        U64 mDroppedPulses;
+    };
+
+    // Adds short pulses of width samples at random positions, on average one every mean_interval samples. A glitch is only placed
+    // where it fits between two edges.
+    class GlitchFilter : public WaveformSink
+    {
+      public:
+        GlitchFilter( WaveformSink& sink, U64 mean_interval, U64 width, U64 seed );
+
+        virtual void OnEdge( U64 sample );
+        virtual void Flush( U64 end_sample );
+
+        U64 GetGlitches() const
+        {
+            return mGlitches;
+        }
+
+      protected:
+        void AddGlitchesBefore( U64 sample );
+        void ScheduleNext();
+
+        WaveformSink& mSink;
+        ImpairmentRandom mRandom;
+        U64 mMeanInterval;
+        U64 mWidth;
+        U64 mNextGlitch;
+        U64 mLastEdge;
+        bool mHasEdge;
+        U64 mGlitches;
+    };
+}
+
+#endif // ISO14443A_WAVEFORM_IMPAIRMENTS
@@ -0,0 +1,97 @@
+#include "Iso14443aWorkStealingPool.h"
+
+namespace Iso14443a
+{
+    WorkStealingPool::WorkStealingPool( U32 thread_count ) : mThreadCount( thread_count > 0 ? thread_count : 1 ), mStolenItems( 0 )
+    {
+        for( U32 i = 0; i < mThreadCount; i++ )
+        {
+            mQueues.emplace_back( new WorkerQueue() );
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        Wait();
+    }
+
+    void WorkStealingPool::Start( U32 item_count, const Task& task )
+    {
+        Wait();
+
+        mTask = task;
+        mStolenItems = 0;
+        for( U32 item = 0; item < item_count; item++ )
+        {
+            mQueues[ item % mThreadCount ]->items.push_back( item );
+        }
+        for( U32 worker = 0; worker < mThreadCount; worker++ )
+        {
+            mThreads.emplace_back( &WorkStealingPool::Work, this, worker );
+        }
+    }
+
+    void WorkStealingPool::Wait()
+    {
+        for( std::thread& thread : mThreads )
+        {
+            thread.join();
+        }
+        mThreads.clear();
+    }
+
+    void WorkStealingPool::Work( U32 worker )
+    {
+        U32 item;
+        while( PopItem( worker, item ) || StealItems( worker, item ) )
+        {
+            mTask( item );
+        }
+    }
+
+    bool WorkStealingPool::PopItem( U32 worker, U32& item )
+    {
+        WorkerQueue& queue = *mQueues[ worker ];
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        if( queue.items.empty() )
+        {
+            return false;
+        }
+        item = queue.items.front();
+        queue.items.pop_front();
+        return true;
+    }
+
+    bool WorkStealingPool::StealItems( U32 thief, U32& item )
+    {
+        // no items are added after the start, so once all queues are empty every item is taken
+        for( U32 offset = 1; offset < mThreadCount; offset++ )
+        {
+            WorkerQueue& victim = *mQueues[ ( thief + offset ) % mThreadCount ];
+            std::deque<U32> stolen;
+            {
+                std::lock_guard<std::mutex> lock( victim.mutex );
+                size_t steal_count = ( victim.items.size() + 1 ) / 2;
+                for( size_t i = 0; i < steal_count; i++ )
+                {
+                    stolen.push_front( victim.items.back() );
+                    victim.items.pop_back();
+                }
+            }
+            if( stolen.empty() )
+            {
+                continue;
+            }
+
+            mStolenItems += stolen.size();
+            item = stolen.front();
+            stolen.pop_front();
+
+            WorkerQueue& queue = *mQueues[ thief ];
+            std::lock_guard<std::mutex> lock( queue.mutex );
+            queue.items.insert( queue.items.end(), stolen.begin(), stolen.end() );
+            return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef ISO14443A_WORK_STEALING_POOL
+#define ISO14443A_WORK_STEALING_POOL
+
+#include "Iso14443aDecoderTypes.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Iso14443a
+{
+    // Runs a task for a range of items on a fixed number of threads. The items are dealt round robin, so all threads work near
+    // the start of the range first. A thread that runs out of items steals the last half of the items of another thread.
+    class WorkStealingPool
+    {
+      public:
+        typedef std::function<void( U32 item )> Task;
+
+        explicit WorkStealingPool( U32 thread_count );
+        ~WorkStealingPool();
+
+        // Starts the task for the items [0, item_count) and returns at once, Wait() blocks until all of them are done.
+        void Start( U32 item_count, const Task& task );
+        void Wait();
+
+        U32 GetThreadCount() const
+        {
+            return mThreadCount;
+        }
+
+        U64 GetStolenItems() const
+        {
+            return mStolenItems.load();
+        }
+
+      protected:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<U32> items;
+        };
+
+        void Work( U32 worker );
+        bool PopItem( U32 worker, U32& item );
+        bool StealItems( U32 thief, U32& item );
+
+        U32 mThreadCount;
+        std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+        std::vector<std::thread> mThreads;
+        Task mTask;
+        std::atomic<U64> mStolenItems;
+    };
+}
+
+#endif // ISO14443A_WORK_STEALING_POOL
@@ -0,0 +1,372 @@
+#include "Iso14443aDualAnalyzer.h"
+#include "Iso14443aDualAnalyzerSettings.h"
+#include "Iso14443aDualAnalyzerResults.h"
+#include "AnalyzerHelpers.h"
+#include <AnalyzerChannelData.h>
+
+static const U32 COMMIT_MAX_PENDING_FRAMES = 1024;
+
+
+Iso14443aDualAnalyzer::Iso14443aDualAnalyzer()
+    : Analyzer2(),
+      mSettings( new Iso14443aDualAnalyzerSettings() ),
+      mPcdSink( *this, false ),
+      mPiccSink( *this, true ),
+      mDualDecoder( mPcdEdgeSource, mPiccEdgeSource, mPcdSink, mPiccSink, *this ),
+      mBlockDecoder( *this ),
+      mLastFrameEndSample( -1 ),
+      mSimulationInitilized( false )
+{
+    SetAnalyzerSettings( mSettings.get() );
+    UseFrameV2();
+}
+
+Iso14443aDualAnalyzer::~Iso14443aDualAnalyzer()
+{
+    KillThread();
+}
+
+void Iso14443aDualAnalyzer::SetupResults()
+{
+    mResults.reset( new Iso14443aDualAnalyzerResults( this, mSettings.get() ) );
+    SetAnalyzerResults( mResults.get() );
+
+    if( mSettings->mPcdInputChannel != UNDEFINED_CHANNEL )
+        mResults->AddChannelBubblesWillAppearOn( mSettings->mPcdInputChannel );
+    if( mSettings->mPiccInputChannel != UNDEFINED_CHANNEL )
+        mResults->AddChannelBubblesWillAppearOn( mSettings->mPiccInputChannel );
+}
+
+
+Iso14443aDualAnalyzer::DirectionSink::DirectionSink( Iso14443aDualAnalyzer& analyzer, bool is_picc )
+    : mAnalyzer( analyzer ), mIsPicc( is_picc )
+{
+}
+
+Channel& Iso14443aDualAnalyzer::DirectionSink::GetChannel()
+{
+    return mIsPicc ? mAnalyzer.mSettings->mPiccInputChannel : mAnalyzer.mSettings->mPcdInputChannel;
+}
+
+void Iso14443aDualAnalyzer::DirectionSink::OnMarker( U64 sample, Iso14443a::MarkerType type )
+{
+    switch( type )
+    {
+    case Iso14443a::MarkerType::SequenceStart:
+        mAnalyzer.mResults->AddMarker( sample, AnalyzerResults::Start, GetChannel() );
+        break;
+    case Iso14443a::MarkerType::SamplingPoint:
+        mAnalyzer.mResults->AddMarker( sample, AnalyzerResults::Dot, GetChannel() );
+        break;
+    case Iso14443a::MarkerType::Error:
+        mAnalyzer.mResults->AddMarker( sample, AnalyzerResults::ErrorX, GetChannel() );
+        break;
+    }
+}
+
+void Iso14443aDualAnalyzer::DirectionSink::OnStartOfCommunication( U64 start_sample, U64 end_sample )
+{
+    Frame frame;
+    frame.mType = FRAME_TYPE_VIEW_BYTES_SOC;
+    frame.mFlags = mIsPicc ? FRAME_FLAG_PICC : 0;
+    frame.mStartingSampleInclusive = start_sample;
+    frame.mEndingSampleInclusive = end_sample;
+    mAnalyzer.QueueResultFrame( frame );
+}
+
+void Iso14443aDualAnalyzer::DirectionSink::OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+{
+    Frame frame;
+    frame.mData1 = byte;
+    frame.mData2 = valid_bits;
+    frame.mType = FRAME_TYPE_VIEW_BYTES_BYTE;
+    frame.mFlags = ( mIsPicc ? FRAME_FLAG_PICC : 0 ) | ( parity_error ? FRAME_FLAG_PARITY_ERROR : 0 );
+    frame.mStartingSampleInclusive = start_sample;
+    frame.mEndingSampleInclusive = end_sample;
+    mAnalyzer.QueueResultFrame( frame );
+}
+
+void Iso14443aDualAnalyzer::DirectionSink::OnEndOfCommunication( U64 start_sample, U64 end_sample )
+{
+    Frame frame;
+    frame.mType = FRAME_TYPE_VIEW_BYTES_EOC;
+    frame.mFlags = mIsPicc ? FRAME_FLAG_PICC : 0;
+    frame.mStartingSampleInclusive = start_sample;
+    frame.mEndingSampleInclusive = end_sample;
+    mAnalyzer.QueueResultFrame( frame );
+}
+
+void Iso14443aDualAnalyzer::QueueResultFrame( const Frame& frame )
+{
+    mPendingFrames[ ( frame.mFlags & FRAME_FLAG_PICC ) ? 1 : 0 ].push_back( frame );
+}
+
+void Iso14443aDualAnalyzer::OnDecodedUpTo( U64 sample )
+{
+    std::deque<Frame>& pcd_frames = mPendingFrames[ 0 ];
+    std::deque<Frame>& picc_frames = mPendingFrames[ 1 ];
+    if( pcd_frames.empty() && picc_frames.empty() )
+    {
+        return;
+    }
+
+    // no frame can start before the sample any more, so the waiting frames of both directions are merged up to it
+    S64 last_frame_end_sample = mLastFrameEndSample;
+    for( ;; )
+    {
+        bool pcd_ready = !pcd_frames.empty() && ( U64( pcd_frames.front().mStartingSampleInclusive ) < sample );
+        bool picc_ready = !picc_frames.empty() && ( U64( picc_frames.front().mStartingSampleInclusive ) < sample );
+        if( !pcd_ready && !picc_ready )
+        {
+            break;
+        }
+
+        bool take_pcd =
+            pcd_ready && ( !picc_ready || ( pcd_frames.front().mStartingSampleInclusive <= picc_frames.front().mStartingSampleInclusive ) );
+        std::deque<Frame>& frames = take_pcd ? pcd_frames : picc_frames;
+        AddResultFrame( frames.front() );
+        frames.pop_front();
+    }
+
+    // the bubbles of a finished frame are visible right away
+    if( mLastFrameEndSample != last_frame_end_sample )
+    {
+        mResults->CommitResults();
+        ReportProgress( U64( mLastFrameEndSample ) );
+        mCommitScheduler.Flush( U64( mLastFrameEndSample ) );
+    }
+}
+
+void Iso14443aDualAnalyzer::AddResultFrame( Frame& frame )
+{
+    // both directions can still overlap (e.g. a glitch on the PICC channel during a command), then the later frame gives way
+    if( frame.mStartingSampleInclusive <= mLastFrameEndSample )
+    {
+        frame.mStartingSampleInclusive = mLastFrameEndSample + 1;
+        if( frame.mStartingSampleInclusive > frame.mEndingSampleInclusive )
+        {
+            return;
+        }
+    }
+    mLastFrameEndSample = frame.mEndingSampleInclusive;
+
+    mResults->AddFrame( frame );
+    if( mCommitScheduler.AddFrame( frame.mEndingSampleInclusive ) )
+    {
+        mResults->CommitResults();
+        ReportProgress( frame.mEndingSampleInclusive );
+    }
+}
+
+void Iso14443aDualAnalyzer::OnTransaction( const Iso14443a::DecodedFrame* command, const Iso14443a::DecodedFrame* response,
+                                           U64 start_sample, U64 end_sample )
+{
+    // the response is interpreted by the command before it
+    Iso14443a::CommandType command_type =
+        command != nullptr ? mCommandDecoder.DecodeCommand( *command ) : Iso14443a::CommandType::Unknown;
+    Iso14443a::CommandType response_type =
+        response != nullptr ? mCommandDecoder.DecodeResponse( *response ) : Iso14443a::CommandType::Unknown;
+
+    // ISO14443-4 blocks, a finished APDU is queued in front of the transaction of its first block
+    Iso14443a::BlockInfo command_block;
+    Iso14443a::BlockInfo response_block;
+    if( ( command_type != Iso14443a::CommandType::Unknown ) || ( response_type != Iso14443a::CommandType::Unknown ) )
+    {
+        // an ISO14443-3 frame leaves the ISO14443-4 protocol, an unfinished chain was aborted
+        mBlockDecoder.Reset();
+    }
+    if( ( command != nullptr ) && ( command_type == Iso14443a::CommandType::Unknown ) )
+    {
+        // the ASK decoder keeps the end of the frame exclusive
+        mBlockDecoder.DecodeBlock( *command, false, command->frame_start_sample, command->frame_end_sample - 1, command_block );
+    }
+    if( ( response != nullptr ) && ( response_type == Iso14443a::CommandType::Unknown ) )
+    {
+        mBlockDecoder.DecodeBlock( *response, true, response->frame_start_sample, response->frame_end_sample, response_block );
+    }
+
+    // a response APDU starts after the command of its transaction
+    Iso14443aFrameV2Queue::Record& frameV2 = mFramesV2.Insert( "transaction", start_sample, end_sample );
+
+    if( command != nullptr )
+    {
+        frameV2.AddByteArray( "command", command->data.data(), command->data.size() );
+        frameV2.AddString( "command_status", Iso14443a::GetFrameStatusString( command->error ) );
+        frameV2.AddString( "command_crc", Iso14443a::GetCrcStatusString( command->crc ) );
+        frameV2.AddInteger( "bit_rate", Iso14443a::GetBitRateKbps( command->bit_rate ) );
+        frameV2.AddString( "command_type", Iso14443a::GetCommandTypeString( command_type ) );
+        if( command_block.type != Iso14443a::BlockType::None )
+        {
+            frameV2.AddString( "command_block", Iso14443a::GetBlockTypeString( command_block.type ) );
+        }
+    }
+    else
+    {
+        frameV2.AddString( "command_status", "NONE" );
+    }
+
+    if( response != nullptr )
+    {
+        frameV2.AddByteArray( "response", response->data.data(), response->data.size() );
+        frameV2.AddString( "response_status", Iso14443a::GetFrameStatusString( response->error ) );
+        frameV2.AddString( "response_crc", Iso14443a::GetCrcStatusString( response->crc ) );
+        frameV2.AddString( "response_type", Iso14443a::GetCommandTypeString( response_type ) );
+        if( response_block.type != Iso14443a::BlockType::None )
+        {
+            frameV2.AddString( "response_block", Iso14443a::GetBlockTypeString( response_block.type ) );
+        }
+    }
+    else
+    {
+        frameV2.AddString( "response_status", "NONE" );
+    }
+
+    frameV2.AddInteger( "cascade_level", mCommandDecoder.GetCascadeLevel() );
+    if( mCommandDecoder.GetUidLength() > 0 )
+    {
+        frameV2.AddByteArray( "uid", mCommandDecoder.GetUid(), mCommandDecoder.GetUidLength() );
+    }
+
+    if( !mBlockDecoder.IsChaining() )
+    {
+        mFramesV2.Flush( *mResults );
+    }
+    mResults->CommitResults();
+}
+
+void Iso14443aDualAnalyzer::OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample )
+{
+    Iso14443aFrameV2Queue::Record& frameV2 = mFramesV2.Insert( "apdu", start_sample, end_sample );
+
+    frameV2.AddString( "direction", is_response ? "PICC" : "PCD" );
+    frameV2.AddByteArray( "data", data, length );
+    frameV2.AddInteger( "blocks", block_count );
+}
+
+void Iso14443aDualAnalyzer::WorkerThread()
+{
+    mSampleRateHz = GetSampleRate();
+
+    mPcdSerial = GetAnalyzerChannelData( mSettings->mPcdInputChannel );
+    mPiccSerial = GetAnalyzerChannelData( mSettings->mPiccInputChannel );
+
+    mPcdEdgeSource.SetChannelData( mPcdSerial );
+    mPiccEdgeSource.SetChannelData( mPiccSerial );
+
+    Iso14443a::AskDecoder& pcd_decoder = mDualDecoder.GetPcdDecoder();
+    Iso14443a::LoadmodDecoder& picc_decoder = mDualDecoder.GetPiccDecoder();
+
+    pcd_decoder.Setup( mSampleRateHz, mSettings->mCarrierHz,
+                       mSettings->mPcdIdleState == BIT_HIGH ? Iso14443a::LINE_HIGH : Iso14443a::LINE_LOW,
+                       mSettings->mPcdDecodingMode == DualPcdDecodingMode::PcdPauseEdges ? Iso14443a::AskSequenceDetection::PauseEdges
+                                                                                         : Iso14443a::AskSequenceDetection::SamplingPoints );
+    picc_decoder.Setup( mSampleRateHz, mSettings->mCarrierHz,
+                        mSettings->mPiccIdleState == BIT_HIGH ? Iso14443a::LINE_HIGH : Iso14443a::LINE_LOW,
+                        mSettings->mPiccDecodingMode == DualPiccDecodingMode::PiccSubcarrierEdges
+                            ? Iso14443a::LoadmodSequenceDetection::SubcarrierEdges
+                            : Iso14443a::LoadmodSequenceDetection::SamplingPoints );
+
+    // both channels measure the carrier on their own frames
+    pcd_decoder.SetCarrierCalibration( mSettings->mCalibrationFrames );
+    picc_decoder.SetCarrierCalibration( mSettings->mCalibrationFrames );
+
+    if( mSettings->mPcdBitRate == DualPcdBitRate::BitRateDetect )
+    {
+        pcd_decoder.SetBitRateDetection( true );
+    }
+    else
+    {
+        // the fixed bit rates are listed in the same order as in the core
+        pcd_decoder.SetBitRateDetection( false );
+        pcd_decoder.SetBitRate( Iso14443a::BitRate( U32( mSettings->mPcdBitRate ) ) );
+    }
+
+    Iso14443a::MarkerDetail marker_detail = Iso14443a::MarkerDetail::None;
+    switch( mSettings->mMarkerDetail )
+    {
+    case DualMarkerDetail::NoMarkers:
+        marker_detail = Iso14443a::MarkerDetail::None;
+        break;
+    case DualMarkerDetail::ErrorMarkers:
+        marker_detail = Iso14443a::MarkerDetail::Errors;
+        break;
+    case DualMarkerDetail::SequenceStartMarkers:
+        marker_detail = Iso14443a::MarkerDetail::SequenceStarts;
+        break;
+    case DualMarkerDetail::SamplingPointMarkers:
+        marker_detail = Iso14443a::MarkerDetail::SamplingPoints;
+        break;
+    }
+    pcd_decoder.SetMarkerDetail( marker_detail );
+    picc_decoder.SetMarkerDetail( marker_detail );
+
+    mCommandDecoder.Reset();
+    mBlockDecoder.Reset();
+    mPendingFrames[ 0 ].clear();
+    mPendingFrames[ 1 ].clear();
+    mLastFrameEndSample = -1;
+    mFramesV2.Clear();
+
+    // search the next edge of both channels in steps of 1 ms
+    mDualDecoder.Setup( mSampleRateHz / 1000 );
+
+    // commit at least every 10 ms of signal
+    mCommitScheduler.Setup( mSampleRateHz / 100, COMMIT_MAX_PENDING_FRAMES );
+
+    // Wait for idle state on both channels
+    mDualDecoder.WaitForIdle();
+
+    for( ;; )
+    {
+        mDualDecoder.DecodeFrame();
+    }
+}
+
+bool Iso14443aDualAnalyzer::NeedsRerun()
+{
+    return false;
+}
+
+U32 Iso14443aDualAnalyzer::GenerateSimulationData( U64 minimum_sample_index, U32 device_sample_rate,
+                                                   SimulationChannelDescriptor** simulation_channels )
+{
+    if( mSimulationInitilized == false )
+    {
+        mSimulationDataGenerator.Initialize( GetSimulationSampleRate(), mSettings->mCarrierHz, mSettings.get() );
+        mSimulationInitilized = true;
+    }
+
+    return mSimulationDataGenerator.GenerateSimulationData( minimum_sample_index, device_sample_rate, simulation_channels );
+}
+
+U32 Iso14443aDualAnalyzer::GetMinimumSampleRateHz()
+{
+    // Subcarrier = (13,56 MHz / 16) = ca. 848kHz
+    // Multiplikator = 3 for the PICC channel, the PCD channel needs 4 at the higher bit rates (short pauses)
+    //   => 2,54 MHz / 3,39 MHz
+    if( mSettings->mPcdBitRate == DualPcdBitRate::BitRate106 )
+    {
+        return ( mSettings->mCarrierHz * 3 ) / 16;
+    }
+    return ( mSettings->mCarrierHz * 4 ) / 16;
+}
+
+const char* Iso14443aDualAnalyzer::GetAnalyzerName() const
+{
+    return "ISO14443A-DUAL";
+}
+
+const char* GetAnalyzerName()
+{
+    return "ISO14443A-DUAL";
+}
+
+Analyzer* CreateAnalyzer()
+{
+    return new Iso14443aDualAnalyzer();
+}
+
+void DestroyAnalyzer( Analyzer* analyzer )
+{
+    delete analyzer;
+}
@@ -0,0 +1,95 @@
+#ifndef ISO14443A_DUAL_ANALYZER_H
+#define ISO14443A_DUAL_ANALYZER_H
+
+#include <Analyzer.h>
+#include "Iso14443aDualAnalyzerResults.h"
+#include "Iso14443aDualAnalyzerSettings.h"
+#include "Iso14443aDualSimulationDataGenerator.h"
+#include "Iso14443aChannelEdgeSource.h"
+#include "Iso14443aDualDecoder.h"
+#include "Iso14443aCommitScheduler.h"
+#include "Iso14443aCommandDecoder.h"
+#include "Iso14443aBlockDecoder.h"
+#include "Iso14443aFrameV2Queue.h"
+#include <deque>
+
+
+class Iso14443aDualAnalyzerSettings;
+class ANALYZER_EXPORT Iso14443aDualAnalyzer : public Analyzer2, public Iso14443a::TransactionSink, public Iso14443a::ApduSink
+{
+  public:
+    Iso14443aDualAnalyzer();
+    virtual ~Iso14443aDualAnalyzer();
+
+    virtual void SetupResults();
+    virtual void WorkerThread();
+
+    virtual U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channels );
+    virtual U32 GetMinimumSampleRateHz();
+
+    virtual const char* GetAnalyzerName() const;
+    virtual bool NeedsRerun();
+
+  protected: // transaction sink
+    virtual void OnTransaction( const Iso14443a::DecodedFrame* command, const Iso14443a::DecodedFrame* response, U64 start_sample,
+                                U64 end_sample );
+    virtual void OnDecodedUpTo( U64 sample );
+
+  protected: // apdu sink
+    virtual void OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample );
+
+  protected: // decoder sinks
+    // Adds the markers and queues the byte frames of one direction, the frames of the PICC carry FRAME_FLAG_PICC.
+    class DirectionSink : public Iso14443a::DecoderSink
+    {
+      public:
+        DirectionSink( Iso14443aDualAnalyzer& analyzer, bool is_picc );
+
+        virtual void OnMarker( U64 sample, Iso14443a::MarkerType type );
+        virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample );
+        virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample );
+        virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample );
+
+      protected:
+        Channel& GetChannel();
+
+        Iso14443aDualAnalyzer& mAnalyzer;
+        bool mIsPicc;
+    };
+
+  protected: // functions
+    void QueueResultFrame( const Frame& frame );
+    void AddResultFrame( Frame& frame );
+
+  protected: // vars
+    std::unique_ptr<Iso14443aDualAnalyzerSettings> mSettings;
+    std::unique_ptr<Iso14443aDualAnalyzerResults> mResults;
+    AnalyzerChannelData* mPcdSerial;
+    AnalyzerChannelData* mPiccSerial;
+    Iso14443aChannelEdgeSource mPcdEdgeSource;
+    Iso14443aChannelEdgeSource mPiccEdgeSource;
+    DirectionSink mPcdSink;
+    DirectionSink mPiccSink;
+    Iso14443a::DualDecoder mDualDecoder;
+    Iso14443a::CommitScheduler mCommitScheduler;
+    Iso14443a::CommandDecoder mCommandDecoder;
+    Iso14443a::BlockDecoder mBlockDecoder;
+
+    // The frames of each direction (PCD, PICC) wait until no frame of the other one can start before them, then both are merged
+    // in sample order. The FrameV2s of chained blocks wait for the APDU that spans them.
+    std::deque<Frame> mPendingFrames[ 2 ];
+    S64 mLastFrameEndSample;
+    Iso14443aFrameV2Queue mFramesV2;
+
+    Iso14443aDualSimulationDataGenerator mSimulationDataGenerator;
+    bool mSimulationInitilized;
+
+    // Serial analysis vars:
+    U32 mSampleRateHz;
+};
+
+extern "C" ANALYZER_EXPORT const char* __cdecl GetAnalyzerName();
+extern "C" ANALYZER_EXPORT Analyzer* __cdecl CreateAnalyzer();
+extern "C" ANALYZER_EXPORT void __cdecl DestroyAnalyzer( Analyzer* analyzer );
+
+#endif // ISO14443A_DUAL_ANALYZER_H
@@ -0,0 +1,68 @@
+#include "Iso14443aDualAnalyzerResults.h"
+#include "Iso14443aDualAnalyzer.h"
+#include "Iso14443aDualAnalyzerSettings.h"
+#include "Iso14443aResultsExport.h"
+
+Iso14443aDualAnalyzerResults::Iso14443aDualAnalyzerResults( Iso14443aDualAnalyzer* analyzer, Iso14443aDualAnalyzerSettings* settings )
+    : AnalyzerResults(), mSettings( settings ), mAnalyzer( analyzer ), mResultText( nullptr, 0 )
+{
+}
+
+Iso14443aDualAnalyzerResults::~Iso14443aDualAnalyzerResults()
+{
+}
+
+
+void Iso14443aDualAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base )
+{
+    ClearResultStrings();
+    Frame frame = GetFrame( frame_index );
+
+    // every frame belongs to one of both channels
+    Channel& frame_channel = ( frame.mFlags & FRAME_FLAG_PICC ) ? mSettings->mPiccInputChannel : mSettings->mPcdInputChannel;
+    if( !( channel == frame_channel ) )
+    {
+        return;
+    }
+
+    mResultText.AddBubbleText( *this, frame, display_base );
+}
+
+void Iso14443aDualAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+{
+    Iso14443aResultsExport exporter( *this, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate(), false, true );
+    switch( export_type_user_id )
+    {
+        case ExportBytes:
+            exporter.ExportBytes( file, display_base );
+            break;
+        case ExportFrames:
+            exporter.ExportFrames( file );
+            break;
+        case ExportPcapng:
+            exporter.ExportPcapng( file );
+            break;
+        default:
+            exporter.ExportValues( file, display_base, true );
+            break;
+    }
+}
+
+void Iso14443aDualAnalyzerResults::GenerateFrameTabularText( U64 frame_index, DisplayBase display_base )
+{
+#ifdef SUPPORTS_PROTOCOL_SEARCH
+    Frame frame = GetFrame( frame_index );
+    ClearTabularText();
+    mResultText.AddTabularText( *this, frame, display_base, ( frame.mFlags & FRAME_FLAG_PICC ) ? "PICC " : "PCD " );
+#endif
+}
+
+void Iso14443aDualAnalyzerResults::GeneratePacketTabularText( U64 packet_id, DisplayBase display_base )
+{
+    // not supported
+}
+
+void Iso14443aDualAnalyzerResults::GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base )
+{
+    // not supported
+}
@@ -0,0 +1,32 @@
+#ifndef ISO14443A_DUAL_ANALYZER_RESULTS
+#define ISO14443A_DUAL_ANALYZER_RESULTS
+
+#include <AnalyzerResults.h>
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aResultFrames.h"
+#include "Iso14443aResultText.h"
+
+class Iso14443aDualAnalyzer;
+class Iso14443aDualAnalyzerSettings;
+
+class Iso14443aDualAnalyzerResults : public AnalyzerResults
+{
+  public:
+    Iso14443aDualAnalyzerResults( Iso14443aDualAnalyzer* analyzer, Iso14443aDualAnalyzerSettings* settings );
+    virtual ~Iso14443aDualAnalyzerResults();
+
+    virtual void GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base );
+    virtual void GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id );
+
+    virtual void GenerateFrameTabularText( U64 frame_index, DisplayBase display_base );
+    virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base );
+    virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base );
+
+  protected: // functions
+  protected: // vars
+    Iso14443aDualAnalyzerSettings* mSettings;
+    Iso14443aDualAnalyzer* mAnalyzer;
+    Iso14443aResultText mResultText;
+};
+
+#endif // ISO14443A_DUAL_ANALYZER_RESULTS
@@ -0,0 +1,206 @@
+#include "Iso14443aDualAnalyzerSettings.h"
+#include <AnalyzerHelpers.h>
+#include "Iso14443aDecoderTypes.h"
+
+
+Iso14443aDualAnalyzerSettings::Iso14443aDualAnalyzerSettings()
+    : mPcdInputChannel( UNDEFINED_CHANNEL ),
+      mPiccInputChannel( UNDEFINED_CHANNEL ),
+      mPcdIdleState( BIT_HIGH ),
+      mPiccIdleState( BIT_LOW ),
+      mPcdDecodingMode( DualPcdDecodingMode::PcdPauseEdges ),
+      mPiccDecodingMode( DualPiccDecodingMode::PiccSubcarrierEdges ),
+      mPcdBitRate( DualPcdBitRate::BitRate106 ),
+      mMarkerDetail( DualMarkerDetail::ErrorMarkers ),
+      mCarrierHz( Iso14443a::NOMINAL_CARRIER_HZ ),
+      mCalibrationFrames( 0 )
+{
+    mPcdInputChannelInterface.reset( new AnalyzerSettingInterfaceChannel() );
+    mPcdInputChannelInterface->SetTitleAndTooltip( "PCD Channel (ASK)", "" );
+    mPcdInputChannelInterface->SetChannel( mPcdInputChannel );
+
+    mPiccInputChannelInterface.reset( new AnalyzerSettingInterfaceChannel() );
+    mPiccInputChannelInterface->SetTitleAndTooltip( "PICC Channel (LOADMOD)", "" );
+    mPiccInputChannelInterface->SetChannel( mPiccInputChannel );
+
+    mPcdIdleStateInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mPcdIdleStateInterface->SetTitleAndTooltip( "PCD Idle State", "" );
+    mPcdIdleStateInterface->AddNumber( BIT_LOW, "IDLE Low", "" );
+    mPcdIdleStateInterface->AddNumber( BIT_HIGH, "IDLE High", "" );
+    mPcdIdleStateInterface->SetNumber( mPcdIdleState );
+
+    mPiccIdleStateInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mPiccIdleStateInterface->SetTitleAndTooltip( "PICC Idle State", "" );
+    mPiccIdleStateInterface->AddNumber( BIT_LOW, "IDLE Low", "" );
+    mPiccIdleStateInterface->AddNumber( BIT_HIGH, "IDLE High", "" );
+    mPiccIdleStateInterface->SetNumber( mPiccIdleState );
+
+    mPcdDecodingModeInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mPcdDecodingModeInterface->SetTitleAndTooltip( "PCD Decoding", "" );
+    mPcdDecodingModeInterface->AddNumber( DualPcdDecodingMode::PcdSamplingPoints, "Sampling Points", "" );
+    mPcdDecodingModeInterface->AddNumber( DualPcdDecodingMode::PcdPauseEdges, "Pause Edges", "" );
+    mPcdDecodingModeInterface->SetNumber( mPcdDecodingMode );
+
+    mPiccDecodingModeInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mPiccDecodingModeInterface->SetTitleAndTooltip( "PICC Decoding", "" );
+    mPiccDecodingModeInterface->AddNumber( DualPiccDecodingMode::PiccSamplingPoints, "Sampling Points", "" );
+    mPiccDecodingModeInterface->AddNumber( DualPiccDecodingMode::PiccSubcarrierEdges, "Subcarrier Edges", "" );
+    mPiccDecodingModeInterface->SetNumber( mPiccDecodingMode );
+
+    mPcdBitRateInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mPcdBitRateInterface->SetTitleAndTooltip( "PCD Bit Rate", "" );
+    mPcdBitRateInterface->AddNumber( DualPcdBitRate::BitRate106, "106 kBit/s", "" );
+    mPcdBitRateInterface->AddNumber( DualPcdBitRate::BitRate212, "212 kBit/s", "" );
+    mPcdBitRateInterface->AddNumber( DualPcdBitRate::BitRate424, "424 kBit/s", "" );
+    mPcdBitRateInterface->AddNumber( DualPcdBitRate::BitRate848, "848 kBit/s", "" );
+    mPcdBitRateInterface->AddNumber( DualPcdBitRate::BitRateDetect, "Detect", "" );
+    mPcdBitRateInterface->SetNumber( mPcdBitRate );
+
+    mMarkerDetailInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mMarkerDetailInterface->SetTitleAndTooltip( "Markers", "" );
+    mMarkerDetailInterface->AddNumber( DualMarkerDetail::NoMarkers, "None", "" );
+    mMarkerDetailInterface->AddNumber( DualMarkerDetail::ErrorMarkers, "Errors Only", "" );
+    mMarkerDetailInterface->AddNumber( DualMarkerDetail::SequenceStartMarkers, "Sequence Starts", "" );
+    mMarkerDetailInterface->AddNumber( DualMarkerDetail::SamplingPointMarkers, "Sampling Points", "" );
+    mMarkerDetailInterface->SetNumber( mMarkerDetail );
+
+    mCarrierHzInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mCarrierHzInterface->SetTitleAndTooltip( "Carrier (Hz)", "" );
+    mCarrierHzInterface->SetMin( Iso14443a::MIN_CARRIER_HZ );
+    mCarrierHzInterface->SetMax( Iso14443a::MAX_CARRIER_HZ );
+    mCarrierHzInterface->SetInteger( mCarrierHz );
+
+    mCalibrationFramesInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mCalibrationFramesInterface->SetTitleAndTooltip( "Carrier Calibration", "" );
+    mCalibrationFramesInterface->AddNumber( 0, "Off", "" );
+    mCalibrationFramesInterface->AddNumber( 8, "First 8 Frames", "" );
+    mCalibrationFramesInterface->AddNumber( 32, "First 32 Frames", "" );
+    mCalibrationFramesInterface->AddNumber( 128, "First 128 Frames", "" );
+    mCalibrationFramesInterface->SetNumber( mCalibrationFrames );
+
+    AddInterface( mPcdInputChannelInterface.get() );
+    AddInterface( mPiccInputChannelInterface.get() );
+    AddInterface( mPcdIdleStateInterface.get() );
+    AddInterface( mPiccIdleStateInterface.get() );
+    AddInterface( mPcdDecodingModeInterface.get() );
+    AddInterface( mPiccDecodingModeInterface.get() );
+    AddInterface( mPcdBitRateInterface.get() );
+    AddInterface( mMarkerDetailInterface.get() );
+    AddInterface( mCarrierHzInterface.get() );
+    AddInterface( mCalibrationFramesInterface.get() );
+
+    AddExportOption( ExportText, "Export as text/csv file" );
+    AddExportExtension( ExportText, "text", "txt" );
+    AddExportExtension( ExportText, "csv", "csv" );
+    AddExportOption( ExportPcapng, "Export as pcapng file (Wireshark)" );
+    AddExportExtension( ExportPcapng, "pcapng", "pcapng" );
+    AddExportOption( ExportBytes, "Export bytes as text/csv file" );
+    AddExportExtension( ExportBytes, "csv", "csv" );
+    AddExportOption( ExportFrames, "Export frames as text/csv file" );
+    AddExportExtension( ExportFrames, "csv", "csv" );
+
+    ClearChannels();
+    AddChannel( mPcdInputChannel, "PCD", false );
+    AddChannel( mPiccInputChannel, "PICC", false );
+}
+
+Iso14443aDualAnalyzerSettings::~Iso14443aDualAnalyzerSettings()
+{
+}
+
+bool Iso14443aDualAnalyzerSettings::SetSettingsFromInterfaces()
+{
+    Channel pcd_channel = mPcdInputChannelInterface->GetChannel();
+    Channel picc_channel = mPiccInputChannelInterface->GetChannel();
+    if( pcd_channel == picc_channel )
+    {
+        SetErrorText( "PCD and PICC must be on different channels." );
+        return false;
+    }
+
+    if( !Iso14443a::IsValidCarrier( U32( mCarrierHzInterface->GetInteger() ) ) )
+    {
+        SetErrorText( "The carrier must be between 13 and 14 MHz." );
+        return false;
+    }
+
+    mPcdInputChannel = pcd_channel;
+    mPiccInputChannel = picc_channel;
+    mPcdIdleState = ( BitState )U32( mPcdIdleStateInterface->GetNumber() );
+    mPiccIdleState = ( BitState )U32( mPiccIdleStateInterface->GetNumber() );
+    mPcdDecodingMode = ( DualPcdDecodingMode )U32( mPcdDecodingModeInterface->GetNumber() );
+    mPiccDecodingMode = ( DualPiccDecodingMode )U32( mPiccDecodingModeInterface->GetNumber() );
+    mPcdBitRate = ( DualPcdBitRate )U32( mPcdBitRateInterface->GetNumber() );
+    mMarkerDetail = ( DualMarkerDetail )U32( mMarkerDetailInterface->GetNumber() );
+    mCarrierHz = U32( mCarrierHzInterface->GetInteger() );
+    mCalibrationFrames = U32( mCalibrationFramesInterface->GetNumber() );
+
+    ClearChannels();
+    AddChannel( mPcdInputChannel, "PCD", true );
+    AddChannel( mPiccInputChannel, "PICC", true );
+
+    return true;
+}
+
+void Iso14443aDualAnalyzerSettings::UpdateInterfacesFromSettings()
+{
+    mPcdInputChannelInterface->SetChannel( mPcdInputChannel );
+    mPiccInputChannelInterface->SetChannel( mPiccInputChannel );
+    mPcdIdleStateInterface->SetNumber( mPcdIdleState );
+    mPiccIdleStateInterface->SetNumber( mPiccIdleState );
+    mPcdDecodingModeInterface->SetNumber( mPcdDecodingMode );
+    mPiccDecodingModeInterface->SetNumber( mPiccDecodingMode );
+    mPcdBitRateInterface->SetNumber( mPcdBitRate );
+    mMarkerDetailInterface->SetNumber( mMarkerDetail );
+    mCarrierHzInterface->SetInteger( int( mCarrierHz ) );
+    mCalibrationFramesInterface->SetNumber( mCalibrationFrames );
+}
+
+void Iso14443aDualAnalyzerSettings::LoadSettings( const char* settings )
+{
+    SimpleArchive text_archive;
+    text_archive.SetString( settings );
+
+    text_archive >> mPcdInputChannel;
+    text_archive >> mPiccInputChannel;
+    text_archive >> *( U32* )&mPcdIdleState;
+    text_archive >> *( U32* )&mPiccIdleState;
+    text_archive >> *( U32* )&mPcdDecodingMode;
+    text_archive >> *( U32* )&mPiccDecodingMode;
+    text_archive >> *( U32* )&mPcdBitRate;
+    text_archive >> *( U32* )&mMarkerDetail;
+
+    // settings saved by older versions end here
+    if( !( text_archive >> mCarrierHz ) || !Iso14443a::IsValidCarrier( mCarrierHz ) )
+    {
+        mCarrierHz = Iso14443a::NOMINAL_CARRIER_HZ;
+    }
+    if( !( text_archive >> mCalibrationFrames ) )
+    {
+        mCalibrationFrames = 0;
+    }
+
+    ClearChannels();
+    AddChannel( mPcdInputChannel, "PCD", true );
+    AddChannel( mPiccInputChannel, "PICC", true );
+
+    UpdateInterfacesFromSettings();
+}
+
+const char* Iso14443aDualAnalyzerSettings::SaveSettings()
+{
+    SimpleArchive text_archive;
+
+    text_archive << mPcdInputChannel;
+    text_archive << mPiccInputChannel;
+    text_archive << mPcdIdleState;
+    text_archive << mPiccIdleState;
+    text_archive << mPcdDecodingMode;
+    text_archive << mPiccDecodingMode;
+    text_archive << mPcdBitRate;
+    text_archive << mMarkerDetail;
+    text_archive << mCarrierHz;
+    text_archive << mCalibrationFrames;
+
+    return SetReturnString( text_archive.GetString() );
+}
@@ -0,0 +1,80 @@
+#ifndef ISO14443A_DUAL_ANALYZER_SETTINGS
+#define ISO14443A_DUAL_ANALYZER_SETTINGS
+
+#include <AnalyzerSettings.h>
+#include <AnalyzerTypes.h>
+
+enum DualPcdDecodingMode
+{
+    PcdSamplingPoints = 0,
+    PcdPauseEdges = 1,
+};
+
+enum DualPiccDecodingMode
+{
+    PiccSamplingPoints = 0,
+    PiccSubcarrierEdges = 1,
+};
+
+enum DualMarkerDetail
+{
+    NoMarkers = 0,
+    ErrorMarkers = 1,
+    SequenceStartMarkers = 2,
+    SamplingPointMarkers = 3,
+};
+
+enum DualPcdBitRate
+{
+    BitRate106 = 0,
+    BitRate212 = 1,
+    BitRate424 = 2,
+    BitRate848 = 3,
+    BitRateDetect = 4,
+};
+
+enum DualExportType
+{
+    ExportText = 0,
+    ExportPcapng = 1,
+    ExportBytes = 2,
+    ExportFrames = 3,
+};
+
+class Iso14443aDualAnalyzerSettings : public AnalyzerSettings
+{
+  public:
+    Iso14443aDualAnalyzerSettings();
+    virtual ~Iso14443aDualAnalyzerSettings();
+
+    virtual bool SetSettingsFromInterfaces();
+    void UpdateInterfacesFromSettings();
+    virtual void LoadSettings( const char* settings );
+    virtual const char* SaveSettings();
+
+
+    Channel mPcdInputChannel;
+    Channel mPiccInputChannel;
+    BitState mPcdIdleState;
+    BitState mPiccIdleState;
+    DualPcdDecodingMode mPcdDecodingMode;
+    DualPiccDecodingMode mPiccDecodingMode;
+    DualPcdBitRate mPcdBitRate;
+    DualMarkerDetail mMarkerDetail;
+    U32 mCarrierHz;
+    U32 mCalibrationFrames;
+
+  protected:
+    std::unique_ptr<AnalyzerSettingInterfaceChannel> mPcdInputChannelInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceChannel> mPiccInputChannelInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mPcdIdleStateInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mPiccIdleStateInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mPcdDecodingModeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mPiccDecodingModeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mPcdBitRateInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mMarkerDetailInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mCarrierHzInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mCalibrationFramesInterface;
+};
+
+#endif // ISO14443A_DUAL_ANALYZER_SETTINGS
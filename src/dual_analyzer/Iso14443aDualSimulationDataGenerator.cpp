@@ -0,0 +1,54 @@
+#include "Iso14443aDualSimulationDataGenerator.h"
+#include "Iso14443aDualAnalyzerSettings.h"
+
+#include <AnalyzerHelpers.h>
+
+Iso14443aDualSimulationDataGenerator::Iso14443aDualSimulationDataGenerator()
+    : mSettings( nullptr ),
+      mSimulationSampleRateHz( 0 ),
+      mPcdSimulationData( nullptr ),
+      mPiccSimulationData( nullptr ),
+      mSessionGenerator( mPcdSimulationSink, mPiccSimulationSink )
+{
+}
+
+Iso14443aDualSimulationDataGenerator::~Iso14443aDualSimulationDataGenerator()
+{
+}
+
+void Iso14443aDualSimulationDataGenerator::Initialize( U32 simulation_sample_rate, U32 carrier_hz, Iso14443aDualAnalyzerSettings* settings )
+{
+    mSimulationSampleRateHz = simulation_sample_rate;
+    mSettings = settings;
+
+    mPcdSimulationData = mSimulationChannels.Add( mSettings->mPcdInputChannel, simulation_sample_rate, mSettings->mPcdIdleState );
+    mPiccSimulationData = mSimulationChannels.Add( mSettings->mPiccInputChannel, simulation_sample_rate, mSettings->mPiccIdleState );
+    mPcdSimulationSink.SetChannel( mPcdSimulationData );
+    mPiccSimulationSink.SetChannel( mPiccSimulationData );
+
+    std::vector<Iso14443a::ScriptFrame> frames;
+    std::string error;
+    Iso14443a::ParseFrameScript( Iso14443a::GetDefaultFrameScript(), frames, error );
+    mSessionGenerator.Setup( simulation_sample_rate, carrier_hz, frames );
+    if( mSettings->mPcdBitRate != DualPcdBitRate::BitRateDetect )
+    {
+        mSessionGenerator.SetPcdBitRate( Iso14443a::BitRate( U32( mSettings->mPcdBitRate ) ) );
+    }
+}
+
+U32 Iso14443aDualSimulationDataGenerator::GenerateSimulationData( U64 largest_sample_requested, U32 sample_rate,
+                                                                  SimulationChannelDescriptor** simulation_channels )
+{
+    U64 adjusted_largest_sample_requested = AnalyzerHelpers::AdjustSimulationTargetSample( largest_sample_requested, sample_rate, mSimulationSampleRateHz );
+
+    // both directions share one time line, the channels follow up to the end of the last frame
+    while( mSessionGenerator.GetPosition() < adjusted_largest_sample_requested )
+    {
+        mSessionGenerator.AddNextFrame();
+    }
+    mPcdSimulationSink.AdvanceTo( mSessionGenerator.GetPosition() );
+    mPiccSimulationSink.AdvanceTo( mSessionGenerator.GetPosition() );
+
+    *simulation_channels = mSimulationChannels.GetArray();
+    return mSimulationChannels.GetCount();
+}
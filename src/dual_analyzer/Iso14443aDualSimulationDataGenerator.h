@@ -0,0 +1,29 @@
+#ifndef ISO14443A_DUAL_SIMULATION_DATA_GENERATOR
+#define ISO14443A_DUAL_SIMULATION_DATA_GENERATOR
+
+#include <SimulationChannelDescriptor.h>
+#include "Iso14443aSessionGenerator.h"
+#include "Iso14443aSimulationSink.h"
+class Iso14443aDualAnalyzerSettings;
+
+class Iso14443aDualSimulationDataGenerator
+{
+  public:
+    Iso14443aDualSimulationDataGenerator();
+    ~Iso14443aDualSimulationDataGenerator();
+
+    void Initialize( U32 simulation_sample_rate, U32 carrier_hz, Iso14443aDualAnalyzerSettings* settings );
+    U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channels );
+
+  protected:
+    Iso14443aDualAnalyzerSettings* mSettings;
+    U32 mSimulationSampleRateHz;
+
+    SimulationChannelDescriptorGroup mSimulationChannels;
+    SimulationChannelDescriptor* mPcdSimulationData;
+    SimulationChannelDescriptor* mPiccSimulationData;
+    Iso14443aSimulationSink mPcdSimulationSink;
+    Iso14443aSimulationSink mPiccSimulationSink;
+    Iso14443a::SessionGenerator mSessionGenerator;
+};
+#endif // ISO14443A_DUAL_SIMULATION_DATA_GENERATOR
@@ -0,0 +1,344 @@
+#include "Iso14443aEdgeFile.h"
+#include "Iso14443aFrameScript.h"
+#include "Iso14443aSessionGenerator.h"
+#include "Iso14443aWaveformImpairments.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Iso14443a;
+
+struct ImpairmentSettings
+{
+    U64 jitter_samples{ 0U };
+    U64 glitch_interval_samples{ 0U };
+    U64 glitch_width_samples{ 1U };
+    U32 dropout_ppm{ 0U };
+    U32 dropout_length{ 1U };
+    U64 seed{ 1U };
+};
+
+// Streams the edges of a line into an edge file, the writer only keeps its buffer in memory.
+class EdgeFileSink : public WaveformSink
+{
+  public:
+    bool Open( const char* file_name, const EdgeStreamHeader& header )
+    {
+        return mWriter.Open( file_name, header );
+    }
+
+    bool Close()
+    {
+        return mWriter.Close();
+    }
+
+    virtual void OnEdge( U64 sample )
+    {
+        mWriter.AddEdge( sample );
+        mEdges++;
+    }
+
+    U64 GetEdgeCount() const
+    {
+        return mEdges;
+    }
+
+  protected:
+    EdgeFileWriter mWriter;
+    U64 mEdges{ 0U };
+};
+
+// One generated line: dropouts, pulse jitter and glitches in front of the edge file.
+class GeneratedLine
+{
+  public:
+    GeneratedLine( const ImpairmentSettings& settings, U64 seed, bool with_dropouts )
+        : mGlitchFilter( mFileSink, settings.glitch_interval_samples, settings.glitch_width_samples, seed * 3 ),
+          mJitterFilter( mGlitchFilter, settings.jitter_samples, seed * 3 + 1 ),
+          mDropoutFilter( mJitterFilter, with_dropouts ? settings.dropout_ppm : 0, settings.dropout_length, seed * 3 + 2 )
+    {
+    }
+
+    bool Open( const char* file_name, const EdgeStreamHeader& header )
+    {
+        return mFileSink.Open( file_name, header );
+    }
+
+    bool Close( U64 end_sample )
+    {
+        mDropoutFilter.Flush( end_sample );
+        return mFileSink.Close();
+    }
+
+    WaveformSink& GetInput()
+    {
+        return mDropoutFilter;
+    }
+
+    void PrintSummary( const char* name ) const
+    {
+        fprintf( stderr, "%-13s %llu edges, %llu dropped pulses, %llu glitches\n", name, mFileSink.GetEdgeCount(),
+                 mDropoutFilter.GetDroppedPulses(), mGlitchFilter.GetGlitches() );
+    }
+
+  protected:
+    EdgeFileSink mFileSink;
+    GlitchFilter mGlitchFilter;
+    PulseJitterFilter mJitterFilter;
+    PulseDropoutFilter mDropoutFilter;
+};
+
+static bool ReadScript( const char* file_name, std::vector<ScriptFrame>& frames )
+{
+    std::ifstream file_stream( file_name );
+    if( !file_stream )
+    {
+        fprintf( stderr, "could not read script %s\n", file_name );
+        return false;
+    }
+
+    std::stringstream text;
+    text << file_stream.rdbuf();
+    std::string error;
+    if( !ParseFrameScript( text.str().c_str(), frames, error ) )
+    {
+        fprintf( stderr, "%s: %s\n", file_name, error.c_str() );
+        return false;
+    }
+    return true;
+}
+
+static U64 NanosecondsToSamples( double ns, U32 sample_rate_hz )
+{
+    return ns > 0.0 ? U64( ns * sample_rate_hz / 1e9 + 0.5 ) : 0;
+}
+
+static void PrintUsage()
+{
+    fprintf( stderr, "usage: Iso14443aGenerator ask|loadmod <edge file> [options]\n"
+                     "       Iso14443aGenerator dual <ask edge file> <loadmod edge file> [options]\n"
+                     "  --sample-rate <hz>          sample rate of the capture (default: 100000000)\n"
+                     "  --duration <s>              length of the capture (default: 1)\n"
+                     "  --frames <n>                stop after n frames instead\n"
+                     "  --script <file>             frame script (default: activation, chained APDU, DESELECT, HLTA)\n"
+                     "  --bit-rate 106|212|424|848  ask: bit rate of all PCD frames (default: as in the script)\n"
+                     "  --envelope                  loadmod: write the demodulated envelope instead of the subcarrier\n"
+                     "  --idle high|low             idle state of the line (default: high for ask, low for loadmod)\n"
+                     "  --carrier-deviation <ppm>   carrier frequency deviation from 13.56 MHz\n"
+                     "  --jitter <ns>               moves the end of every pause / subcarrier period by up to +-ns\n"
+                     "  --glitch-interval <us>      mean distance between glitches, 0 disables (default: 0)\n"
+                     "  --glitch-width <ns>         width of a glitch (default: 20)\n"
+                     "  --dropouts <ppm>            loadmod: dropouts per million subcarrier periods (default: 0)\n"
+                     "  --dropout-length <n>        loadmod: subcarrier periods missing per dropout (default: 1)\n"
+                     "  --seed <n>                  seed of the impairments (default: 1)\n" );
+}
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 3 )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    bool is_ask = strcmp( argv[ 1 ], "ask" ) == 0;
+    bool is_dual = strcmp( argv[ 1 ], "dual" ) == 0;
+    if( !is_ask && !is_dual && ( strcmp( argv[ 1 ], "loadmod" ) != 0 ) )
+    {
+        PrintUsage();
+        return 1;
+    }
+    if( is_dual && ( argc < 4 ) )
+    {
+        PrintUsage();
+        return 1;
+    }
+    const char* pcd_file = ( is_ask || is_dual ) ? argv[ 2 ] : nullptr;
+    const char* picc_file = is_dual ? argv[ 3 ] : ( is_ask ? nullptr : argv[ 2 ] );
+
+    LineState idle_state = is_ask ? LINE_HIGH : LINE_LOW;
+    U32 sample_rate_hz = 100000000;
+    double duration_s = 1.0;
+    U64 max_frames = 0;
+    const char* script_file = nullptr;
+    bool force_bit_rate = false;
+    bool envelope = false;
+    BitRate bit_rate = BitRate::Fc128;
+    double carrier_deviation_ppm = 0.0;
+    double jitter_ns = 0.0;
+    double glitch_interval_us = 0.0;
+    double glitch_width_ns = 20.0;
+    ImpairmentSettings impairments;
+    for( int i = is_dual ? 4 : 3; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "--sample-rate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            sample_rate_hz = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--duration" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            duration_s = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--frames" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            max_frames = strtoull( argv[ ++i ], nullptr, 10 );
+        }
+        else if( ( strcmp( argv[ i ], "--script" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            script_file = argv[ ++i ];
+        }
+        else if( ( strcmp( argv[ i ], "--bit-rate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            i++;
+            for( U32 rate = 0; rate < BIT_RATE_COUNT; rate++ )
+            {
+                if( strtoul( argv[ i ], nullptr, 10 ) == GetBitRateKbps( BitRate( rate ) ) )
+                {
+                    bit_rate = BitRate( rate );
+                    force_bit_rate = true;
+                }
+            }
+        }
+        else if( ( strcmp( argv[ i ], "--envelope" ) == 0 ) && !is_ask )
+        {
+            envelope = true;
+        }
+        else if( ( strcmp( argv[ i ], "--idle" ) == 0 ) && ( i + 1 < argc ) && !is_dual )
+        {
+            idle_state = strcmp( argv[ ++i ], "low" ) == 0 ? LINE_LOW : LINE_HIGH;
+        }
+        else if( ( strcmp( argv[ i ], "--carrier-deviation" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            carrier_deviation_ppm = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--jitter" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            jitter_ns = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--glitch-interval" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            glitch_interval_us = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--glitch-width" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            glitch_width_ns = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--dropouts" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            impairments.dropout_ppm = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--dropout-length" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            impairments.dropout_length = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--seed" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            impairments.seed = strtoull( argv[ ++i ], nullptr, 10 );
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if( sample_rate_hz == 0 )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<ScriptFrame> frames;
+    std::string error;
+    if( script_file != nullptr ? !ReadScript( script_file, frames ) : !ParseFrameScript( GetDefaultFrameScript(), frames, error ) )
+    {
+        return 1;
+    }
+
+    impairments.jitter_samples = NanosecondsToSamples( jitter_ns, sample_rate_hz );
+    impairments.glitch_interval_samples = NanosecondsToSamples( glitch_interval_us * 1000.0, sample_rate_hz );
+    impairments.glitch_width_samples = NanosecondsToSamples( glitch_width_ns, sample_rate_hz );
+    U32 carrier_hz = U32( NOMINAL_CARRIER_HZ * ( 1.0 + carrier_deviation_ppm / 1e6 ) + 0.5 );
+
+    NullWaveformSink null_sink;
+    std::unique_ptr<GeneratedLine> pcd_line;
+    std::unique_ptr<GeneratedLine> picc_line;
+    if( pcd_file != nullptr )
+    {
+        EdgeStreamHeader header;
+        header.sample_rate_hz = sample_rate_hz;
+        header.initial_state = is_dual ? LINE_HIGH : idle_state;
+        pcd_line.reset( new GeneratedLine( impairments, impairments.seed, false ) );
+        if( !pcd_line->Open( pcd_file, header ) )
+        {
+            fprintf( stderr, "could not write %s\n", pcd_file );
+            return 1;
+        }
+    }
+    if( picc_file != nullptr )
+    {
+        EdgeStreamHeader header;
+        header.sample_rate_hz = sample_rate_hz;
+        header.initial_state = is_dual ? LINE_LOW : idle_state;
+        picc_line.reset( new GeneratedLine( impairments, impairments.seed + 1, true ) );
+        if( !picc_line->Open( picc_file, header ) )
+        {
+            fprintf( stderr, "could not write %s\n", picc_file );
+            return 1;
+        }
+    }
+
+    SessionGenerator generator( pcd_line ? pcd_line->GetInput() : null_sink, picc_line ? picc_line->GetInput() : null_sink );
+    generator.Setup( sample_rate_hz, carrier_hz, frames );
+    if( force_bit_rate )
+    {
+        generator.SetPcdBitRate( bit_rate );
+    }
+    generator.SetPiccEnvelope( envelope );
+
+    U64 end_sample = U64( duration_s * sample_rate_hz );
+    auto start_time = std::chrono::steady_clock::now();
+    while( ( max_frames != 0 ) ? ( generator.GetFrameCount() < max_frames ) : ( generator.GetPosition() < end_sample ) )
+    {
+        generator.AddNextFrame();
+    }
+    end_sample = generator.GetPosition();
+
+    bool written = true;
+    if( pcd_line && !pcd_line->Close( end_sample ) )
+    {
+        fprintf( stderr, "could not write %s\n", pcd_file );
+        written = false;
+    }
+    if( picc_line && !picc_line->Close( end_sample ) )
+    {
+        fprintf( stderr, "could not write %s\n", picc_file );
+        written = false;
+    }
+    double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+    double capture_s = double( end_sample ) / sample_rate_hz;
+
+    fprintf( stderr, "frames:       %llu\n", generator.GetFrameCount() );
+    fprintf( stderr, "carrier:      %u Hz\n", carrier_hz );
+    fprintf( stderr, "capture:      %.3f s (%llu samples)\n", capture_s, end_sample );
+    if( pcd_line )
+    {
+        pcd_line->PrintSummary( "pcd:" );
+    }
+    if( picc_line )
+    {
+        picc_line->PrintSummary( "picc:" );
+    }
+    fprintf( stderr, "elapsed:      %.3f s\n", elapsed_s );
+    if( elapsed_s > 0.0 )
+    {
+        fprintf( stderr, "realtime:     %.1fx\n", capture_s / elapsed_s );
+    }
+
+    return written ? 0 : 1;
+}
@@ -0,0 +1,504 @@
+#include <Analyzer.h>
+#include <AnalyzerChannelData.h>
+#include "Iso14443aEdgeFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Runs an unmodified analyzer plugin (linked into this executable) on recorded or simulated captures, without Logic 2.
+// Only the exported CreateAnalyzer/DestroyAnalyzer and the SDK interfaces are used, the analyzer is driven like Logic 2 does.
+
+extern "C" const char* GetAnalyzerName();
+extern "C" Analyzer* CreateAnalyzer();
+extern "C" void DestroyAnalyzer( Analyzer* analyzer );
+
+// every capture ends this long after its last edge, so the decoders see the end of the last frame
+static const U32 CAPTURE_TAIL_DIVIDER = 1000;
+
+struct CaptureChannel
+{
+    Channel channel;
+    BitState initial_state{ BIT_LOW };
+    std::vector<U64> edges;
+};
+
+struct RunnerOptions
+{
+    std::vector<const char*> capture_files;
+    std::vector<const char*> settings;
+    U32 sample_rate_hz{ 0U };
+    double simulate_s{ 0.0 };
+    U32 repeat{ 1U };
+    bool bubbles{ false };
+    bool print{ false };
+    bool list{ false };
+    S32 export_id{ -1 };
+    const char* export_file{ nullptr };
+};
+
+static std::vector<AnalyzerSettingInterfaceChannel*> GetChannelInterfaces( AnalyzerSettings* settings )
+{
+    std::vector<AnalyzerSettingInterfaceChannel*> channel_interfaces;
+    for( AnalyzerSettingInterface* setting_interface : settings->GetInterfaces() )
+    {
+        AnalyzerSettingInterfaceChannel* channel_interface = dynamic_cast<AnalyzerSettingInterfaceChannel*>( setting_interface );
+        if( channel_interface != nullptr )
+        {
+            channel_interfaces.push_back( channel_interface );
+        }
+    }
+    return channel_interfaces;
+}
+
+static void ListSettings( AnalyzerSettings* settings )
+{
+    for( AnalyzerSettingInterface* setting_interface : settings->GetInterfaces() )
+    {
+        AnalyzerSettingInterfaceNumberList* number_list = dynamic_cast<AnalyzerSettingInterfaceNumberList*>( setting_interface );
+        if( dynamic_cast<AnalyzerSettingInterfaceChannel*>( setting_interface ) != nullptr )
+        {
+            printf( "%s: <capture>\n", setting_interface->GetTitle() );
+        }
+        else if( number_list != nullptr )
+        {
+            printf( "%s:", setting_interface->GetTitle() );
+            for( U32 i = 0; i < number_list->GetListboxNumbersCount(); i++ )
+            {
+                bool is_selected = number_list->GetListboxNumber( i ) == number_list->GetNumber();
+                printf( "%s %s%s", i > 0 ? "," : "", number_list->GetListboxString( i ), is_selected ? " (default)" : "" );
+            }
+            printf( "\n" );
+        }
+        else
+        {
+            printf( "%s: <value>\n", setting_interface->GetTitle() );
+        }
+    }
+    for( const AnalyzerSettings::ExportOption& option : settings->GetExportOptions() )
+    {
+        printf( "export %u: %s\n", option.user_id, option.menu_text.c_str() );
+    }
+}
+
+// "<title>=<value>", a number list takes the text of an entry or its number
+static bool ApplySetting( AnalyzerSettings* settings, const char* assignment )
+{
+    const char* separator = strchr( assignment, '=' );
+    if( separator == nullptr )
+    {
+        fprintf( stderr, "setting %s: expected <title>=<value>\n", assignment );
+        return false;
+    }
+    std::string title( assignment, separator - assignment );
+    const char* value = separator + 1;
+
+    for( AnalyzerSettingInterface* setting_interface : settings->GetInterfaces() )
+    {
+        if( title != setting_interface->GetTitle() )
+        {
+            continue;
+        }
+
+        AnalyzerSettingInterfaceNumberList* number_list = dynamic_cast<AnalyzerSettingInterfaceNumberList*>( setting_interface );
+        AnalyzerSettingInterfaceInteger* integer = dynamic_cast<AnalyzerSettingInterfaceInteger*>( setting_interface );
+        AnalyzerSettingInterfaceText* text = dynamic_cast<AnalyzerSettingInterfaceText*>( setting_interface );
+        AnalyzerSettingInterfaceBool* boolean = dynamic_cast<AnalyzerSettingInterfaceBool*>( setting_interface );
+        if( number_list != nullptr )
+        {
+            char* number_end = nullptr;
+            double number = strtod( value, &number_end );
+            bool is_number = ( number_end != value ) && ( *number_end == '\0' );
+            for( U32 i = 0; i < number_list->GetListboxNumbersCount(); i++ )
+            {
+                bool matches_number = is_number && ( number == number_list->GetListboxNumber( i ) );
+                if( matches_number || ( strcmp( value, number_list->GetListboxString( i ) ) == 0 ) )
+                {
+                    number_list->SetNumber( number_list->GetListboxNumber( i ) );
+                    return true;
+                }
+            }
+        }
+        else if( integer != nullptr )
+        {
+            integer->SetInteger( atoi( value ) );
+            return true;
+        }
+        else if( text != nullptr )
+        {
+            text->SetText( value );
+            return true;
+        }
+        else if( boolean != nullptr )
+        {
+            boolean->SetValue( ( strcmp( value, "1" ) == 0 ) || ( strcmp( value, "true" ) == 0 ) );
+            return true;
+        }
+        fprintf( stderr, "setting %s: unknown value %s\n", title.c_str(), value );
+        return false;
+    }
+
+    fprintf( stderr, "unknown setting %s, see --list\n", title.c_str() );
+    return false;
+}
+
+// Creates the analyzer with the channels of the captures and the requested settings, the way Logic 2 does before a run.
+static Analyzer* CreateConfiguredAnalyzer( const RunnerOptions& options )
+{
+    Analyzer* analyzer = CreateAnalyzer();
+    AnalyzerSettings* settings = analyzer->GetAnalyzerSettings();
+
+    std::vector<AnalyzerSettingInterfaceChannel*> channel_interfaces = GetChannelInterfaces( settings );
+    for( U32 i = 0; i < channel_interfaces.size(); i++ )
+    {
+        channel_interfaces[ i ]->SetChannel( Channel( 0, i ) );
+    }
+
+    for( const char* assignment : options.settings )
+    {
+        if( !ApplySetting( settings, assignment ) )
+        {
+            DestroyAnalyzer( analyzer );
+            return nullptr;
+        }
+    }
+    if( !settings->SetSettingsFromInterfaces() )
+    {
+        fprintf( stderr, "invalid settings: %s\n", settings->GetErrorText() );
+        DestroyAnalyzer( analyzer );
+        return nullptr;
+    }
+    return analyzer;
+}
+
+static bool LoadCaptures( const RunnerOptions& options, U32 channel_count, U32& sample_rate_hz, std::vector<CaptureChannel>& captures )
+{
+    if( options.capture_files.size() != channel_count )
+    {
+        fprintf( stderr, "%s needs %u capture(s), got %u\n", GetAnalyzerName(), channel_count, U32( options.capture_files.size() ) );
+        return false;
+    }
+
+    for( U32 i = 0; i < channel_count; i++ )
+    {
+        Iso14443a::EdgeStreamHeader header;
+        CaptureChannel capture;
+        if( !Iso14443a::ReadEdgeFile( options.capture_files[ i ], header, capture.edges ) )
+        {
+            fprintf( stderr, "could not read capture %s\n", options.capture_files[ i ] );
+            return false;
+        }
+        if( ( i > 0 ) && ( header.sample_rate_hz != sample_rate_hz ) )
+        {
+            fprintf( stderr, "the captures have different sample rates\n" );
+            return false;
+        }
+        sample_rate_hz = header.sample_rate_hz;
+        capture.channel = Channel( 0, i );
+        capture.initial_state = header.initial_state == Iso14443a::LINE_HIGH ? BIT_HIGH : BIT_LOW;
+        captures.push_back( std::move( capture ) );
+    }
+    return true;
+}
+
+// Records the simulation data of the analyzer as captures.
+static bool SimulateCaptures( const RunnerOptions& options, std::vector<CaptureChannel>& captures )
+{
+    Analyzer* analyzer = CreateConfiguredAnalyzer( options );
+    if( analyzer == nullptr )
+    {
+        return false;
+    }
+    analyzer->SetSampleRate( options.sample_rate_hz );
+    analyzer->SetSimulationSampleRate( options.sample_rate_hz );
+
+    SimulationChannelDescriptor* simulation_channels = nullptr;
+    U64 end_sample = U64( options.simulate_s * options.sample_rate_hz );
+    U32 channel_count = analyzer->GenerateSimulationData( end_sample, options.sample_rate_hz, &simulation_channels );
+    for( U32 i = 0; i < channel_count; i++ )
+    {
+        CaptureChannel capture;
+        capture.channel = simulation_channels[ i ].GetChannel();
+        capture.initial_state = simulation_channels[ i ].GetInitialBitState();
+        capture.edges = simulation_channels[ i ].GetEdges();
+        captures.push_back( std::move( capture ) );
+    }
+    DestroyAnalyzer( analyzer );
+    return channel_count > 0;
+}
+
+static void PrintFramesV2( AnalyzerResults* results )
+{
+    for( const AnalyzerResults::FrameV2Record& record : results->GetFramesV2() )
+    {
+        printf( "%s,%llu,%llu", record.type.c_str(), record.starting_sample, record.ending_sample );
+        for( const std::pair<std::string, std::string>& field : record.frame.GetFields() )
+        {
+            printf( ",%s=%s", field.first.c_str(), field.second.c_str() );
+        }
+        printf( "\n" );
+    }
+}
+
+// Generates the bubble and tabular text of every frame in all display bases, like scrolling through the whole capture.
+static void RunBubbles( AnalyzerResults* results, Channel channel )
+{
+    static const DisplayBase display_bases[] = { Binary, Decimal, Hexadecimal, ASCII, AsciiHex };
+
+    U64 frame_count = results->GetNumFrames();
+    U64 strings = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for( DisplayBase display_base : display_bases )
+    {
+        for( U64 i = 0; i < frame_count; i++ )
+        {
+            results->GenerateBubbleText( i, channel, display_base );
+            strings += results->GetResultStrings().size();
+            results->GenerateFrameTabularText( i, display_base );
+            strings += results->GetTabularText().size();
+        }
+    }
+    double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+
+    fprintf( stderr, "bubbles:      %llu strings for %llu frames in %.3f s", strings, frame_count * 5, elapsed_s );
+    if( elapsed_s > 0.0 )
+    {
+        fprintf( stderr, " (%.0f frames/s)", frame_count * 5 / elapsed_s );
+    }
+    fprintf( stderr, "\n" );
+}
+
+static void RunExport( AnalyzerResults* results, U32 export_id, const char* file_name )
+{
+    auto start_time = std::chrono::steady_clock::now();
+    results->GenerateExportFile( file_name, Hexadecimal, export_id );
+    double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+
+    FILE* file = fopen( file_name, "rb" );
+    long file_size = -1;
+    if( file != nullptr )
+    {
+        fseek( file, 0, SEEK_END );
+        file_size = ftell( file );
+        fclose( file );
+    }
+    fprintf( stderr, "export:       %u to %s, %ld bytes in %.3f s\n", export_id, file_name, file_size, elapsed_s );
+}
+
+static void PrintUsage()
+{
+    fprintf( stderr, "usage: <runner> <capture>... [options]\n"
+                     "       <runner> --simulate <seconds> [options]\n"
+                     "       <runner> --list\n"
+                     "  runs the %s analyzer plugin without Logic 2\n"
+                     "  <capture>            edge stream (.edges) per channel of the analyzer, in the order of its settings\n"
+                     "  --simulate <s>       decode the simulation data of the analyzer instead of captures\n"
+                     "  --sample-rate <hz>   sample rate of the simulation (default: 100000000)\n"
+                     "  --set <title>=<value>   analyzer setting, e.g. \"Output Format=Sequences\" (see --list)\n"
+                     "  --repeat <n>         run the analyzer n times, the fastest run is reported (default: 1)\n"
+                     "  --bubbles            generate the bubble and tabular text of every frame\n"
+                     "  --export <id> <file>   run an export option of the analyzer (see --list)\n"
+                     "  --print              print every FrameV2\n"
+                     "  --list               list the settings and export options\n"
+                     "  exits with 2 if the results break the rules of Logic 2 (order errors)\n",
+             GetAnalyzerName() );
+}
+
+int main( int argc, char* argv[] )
+{
+    RunnerOptions options;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "--simulate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            options.simulate_s = atof( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--sample-rate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            options.sample_rate_hz = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--set" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            options.settings.push_back( argv[ ++i ] );
+        }
+        else if( ( strcmp( argv[ i ], "--repeat" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            options.repeat = std::max( U32( strtoul( argv[ ++i ], nullptr, 10 ) ), 1U );
+        }
+        else if( strcmp( argv[ i ], "--bubbles" ) == 0 )
+        {
+            options.bubbles = true;
+        }
+        else if( ( strcmp( argv[ i ], "--export" ) == 0 ) && ( i + 2 < argc ) )
+        {
+            options.export_id = S32( strtol( argv[ ++i ], nullptr, 10 ) );
+            options.export_file = argv[ ++i ];
+        }
+        else if( strcmp( argv[ i ], "--print" ) == 0 )
+        {
+            options.print = true;
+        }
+        else if( strcmp( argv[ i ], "--list" ) == 0 )
+        {
+            options.list = true;
+        }
+        else if( argv[ i ][ 0 ] != '-' )
+        {
+            options.capture_files.push_back( argv[ i ] );
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if( options.list )
+    {
+        Analyzer* analyzer = CreateAnalyzer();
+        printf( "%s\n", GetAnalyzerName() );
+        ListSettings( analyzer->GetAnalyzerSettings() );
+        DestroyAnalyzer( analyzer );
+        return 0;
+    }
+
+    std::vector<CaptureChannel> captures;
+    U32 sample_rate_hz = 0;
+    if( options.simulate_s > 0.0 )
+    {
+        if( options.sample_rate_hz == 0 )
+        {
+            options.sample_rate_hz = 100000000;
+        }
+        sample_rate_hz = options.sample_rate_hz;
+        if( !SimulateCaptures( options, captures ) )
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        Analyzer* analyzer = CreateAnalyzer();
+        U32 channel_count = U32( GetChannelInterfaces( analyzer->GetAnalyzerSettings() ).size() );
+        DestroyAnalyzer( analyzer );
+        if( options.capture_files.empty() )
+        {
+            PrintUsage();
+            return 1;
+        }
+        if( !LoadCaptures( options, channel_count, sample_rate_hz, captures ) )
+        {
+            return 1;
+        }
+    }
+
+    U64 edge_count = 0;
+    U64 end_sample = U64( options.simulate_s * sample_rate_hz );
+    for( const CaptureChannel& capture : captures )
+    {
+        edge_count += capture.edges.size();
+        if( !capture.edges.empty() )
+        {
+            end_sample = std::max( end_sample, capture.edges.back() + sample_rate_hz / CAPTURE_TAIL_DIVIDER );
+        }
+    }
+
+    double best_s = 0.0;
+    int exit_code = 0;
+    for( U32 pass = 0; pass < options.repeat; pass++ )
+    {
+        Analyzer* analyzer = CreateConfiguredAnalyzer( options );
+        if( analyzer == nullptr )
+        {
+            return 1;
+        }
+        analyzer->SetSampleRate( sample_rate_hz );
+        analyzer->SetSimulationSampleRate( sample_rate_hz );
+
+        std::vector<std::unique_ptr<AnalyzerChannelData>> channel_data;
+        for( const CaptureChannel& capture : captures )
+        {
+            channel_data.emplace_back( new AnalyzerChannelData( capture.edges, capture.initial_state, end_sample ) );
+            analyzer->SetChannelData( capture.channel, channel_data.back().get() );
+        }
+        analyzer->SetupResults();
+
+        // the worker thread of an analyzer never returns, it runs until the end of the capture
+        auto start_time = std::chrono::steady_clock::now();
+        try
+        {
+            analyzer->WorkerThread();
+        }
+        catch( const HeadlessEndOfCapture& )
+        {
+        }
+        double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+        if( ( pass == 0 ) || ( elapsed_s < best_s ) )
+        {
+            best_s = elapsed_s;
+        }
+
+        if( pass + 1 < options.repeat )
+        {
+            DestroyAnalyzer( analyzer );
+            continue;
+        }
+
+        AnalyzerResults* results = analyzer->GetAnalyzerResults();
+        if( options.print )
+        {
+            PrintFramesV2( results );
+        }
+
+        double capture_s = double( end_sample ) / sample_rate_hz;
+        fprintf( stderr, "analyzer:     %s\n", GetAnalyzerName() );
+        fprintf( stderr, "capture:      %llu edges on %u channel(s), %.3f s at %u Hz\n", edge_count, U32( captures.size() ), capture_s,
+                 sample_rate_hz );
+        fprintf( stderr, "frames:       %llu (%llu committed)\n", results->GetNumFrames(), results->GetNumCommittedFrames() );
+        std::vector<std::pair<std::string, U64>> frames_per_type;
+        for( const AnalyzerResults::FrameV2Record& record : results->GetFramesV2() )
+        {
+            auto it = std::find_if( frames_per_type.begin(), frames_per_type.end(),
+                                    [&record]( const std::pair<std::string, U64>& entry ) { return entry.first == record.type; } );
+            if( it == frames_per_type.end() )
+            {
+                frames_per_type.push_back( std::make_pair( record.type, 1ULL ) );
+            }
+            else
+            {
+                it->second++;
+            }
+        }
+        for( const std::pair<std::string, U64>& entry : frames_per_type )
+        {
+            fprintf( stderr, "  %-12s %llu\n", entry.first.c_str(), entry.second );
+        }
+        fprintf( stderr, "markers:      %llu\n", results->GetNumMarkers() );
+        fprintf( stderr, "commits:      %llu\n", results->GetNumCommits() );
+        fprintf( stderr, "order errors: %llu\n", results->GetOrderViolations() );
+        if( results->GetOrderViolations() > 0 )
+        {
+            exit_code = 2;
+        }
+        fprintf( stderr, "elapsed:      %.3f s (best of %u)\n", best_s, options.repeat );
+        if( best_s > 0.0 )
+        {
+            fprintf( stderr, "throughput:   %.0f edges/s, %.1fx realtime\n", edge_count / best_s, capture_s / best_s );
+        }
+
+        if( options.bubbles && !captures.empty() )
+        {
+            RunBubbles( results, captures.front().channel );
+        }
+        if( options.export_file != nullptr )
+        {
+            RunExport( results, U32( options.export_id ), options.export_file );
+        }
+        DestroyAnalyzer( analyzer );
+    }
+    return exit_code;
+}
@@ -0,0 +1,991 @@
+#include <Analyzer.h>
+#include <AnalyzerChannelData.h>
+#include <AnalyzerHelpers.h>
+#include <AnalyzerResults.h>
+#include <AnalyzerSettings.h>
+#include <SimulationChannelDescriptor.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// In-memory implementation of the Analyzer SDK stand-in (see sdk/LogicPublicTypes.h).
+
+AnalyzerChannelData::AnalyzerChannelData( const std::vector<U64>& edges, BitState initial_state, U64 end_sample )
+    : mEdges( edges.data() ),
+      mNextEdge( edges.data() ),
+      mEdgesEnd( edges.data() + edges.size() ),
+      mEndSample( end_sample ),
+      mSampleNumber( 0 ),
+      mBitState( initial_state )
+{
+}
+
+U64 AnalyzerChannelData::GetSampleNumber()
+{
+    return mSampleNumber;
+}
+
+BitState AnalyzerChannelData::GetBitState()
+{
+    return mBitState;
+}
+
+U32 AnalyzerChannelData::Advance( U32 num_samples )
+{
+    return AdvanceToAbsPosition( mSampleNumber + num_samples );
+}
+
+U32 AnalyzerChannelData::AdvanceToAbsPosition( U64 sample_number )
+{
+    if( sample_number > mEndSample )
+    {
+        throw HeadlessEndOfCapture();
+    }
+    if( sample_number < mSampleNumber )
+    {
+        return 0;
+    }
+
+    U32 edges_passed = 0;
+    while( ( mNextEdge != mEdgesEnd ) && ( *mNextEdge <= sample_number ) )
+    {
+        mNextEdge++;
+        edges_passed++;
+    }
+    if( edges_passed & 1 )
+    {
+        mBitState = mBitState == BIT_LOW ? BIT_HIGH : BIT_LOW;
+    }
+    mSampleNumber = sample_number;
+    return edges_passed;
+}
+
+void AnalyzerChannelData::AdvanceToNextEdge()
+{
+    if( mNextEdge == mEdgesEnd )
+    {
+        throw HeadlessEndOfCapture();
+    }
+    mSampleNumber = *mNextEdge++;
+    mBitState = mBitState == BIT_LOW ? BIT_HIGH : BIT_LOW;
+}
+
+U64 AnalyzerChannelData::GetSampleOfNextEdge()
+{
+    if( mNextEdge == mEdgesEnd )
+    {
+        throw HeadlessEndOfCapture();
+    }
+    return *mNextEdge;
+}
+
+bool AnalyzerChannelData::WouldAdvancingCauseTransition( U32 num_samples )
+{
+    return WouldAdvancingToAbsPositionCauseTransition( mSampleNumber + num_samples );
+}
+
+bool AnalyzerChannelData::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+{
+    if( ( mNextEdge != mEdgesEnd ) && ( *mNextEdge <= sample_number ) )
+    {
+        return true;
+    }
+    // Logic 2 would wait for the capture to reach the sample
+    if( sample_number > mEndSample )
+    {
+        throw HeadlessEndOfCapture();
+    }
+    return false;
+}
+
+void AnalyzerChannelData::TrackMinimumPulseWidth()
+{
+}
+
+U64 AnalyzerChannelData::GetMinimumPulseWidthSoFar()
+{
+    return 0;
+}
+
+bool AnalyzerChannelData::DoMoreTransitionsExistInCurrentData()
+{
+    return mNextEdge != mEdgesEnd;
+}
+
+Analyzer::Analyzer()
+    : mSettings( nullptr ), mResults( nullptr ), mSampleRateHz( 0 ), mSimulationSampleRateHz( 0 ), mProgress( 0 )
+{
+}
+
+Analyzer::~Analyzer()
+{
+}
+
+void Analyzer::SetupResults()
+{
+}
+
+void Analyzer::SetAnalyzerSettings( AnalyzerSettings* settings )
+{
+    mSettings = settings;
+}
+
+void Analyzer::SetAnalyzerResults( AnalyzerResults* results )
+{
+    mResults = results;
+}
+
+AnalyzerChannelData* Analyzer::GetAnalyzerChannelData( Channel& channel )
+{
+    std::map<Channel, AnalyzerChannelData*>::iterator it = mChannelData.find( channel );
+    return it != mChannelData.end() ? it->second : nullptr;
+}
+
+void Analyzer::ReportProgress( U64 sample_number )
+{
+    mProgress = sample_number;
+}
+
+U64 Analyzer::GetTriggerSample()
+{
+    return 0;
+}
+
+U32 Analyzer::GetSampleRate()
+{
+    return mSampleRateHz;
+}
+
+U32 Analyzer::GetSimulationSampleRate()
+{
+    return mSimulationSampleRateHz;
+}
+
+void Analyzer::CheckIfThreadShouldExit()
+{
+}
+
+void Analyzer::KillThread()
+{
+}
+
+Analyzer2::Analyzer2() : mUseFrameV2( false )
+{
+}
+
+void Analyzer2::SetupResults()
+{
+}
+
+void Analyzer2::UseFrameV2()
+{
+    mUseFrameV2 = true;
+}
+
+Frame::Frame() : mStartingSampleInclusive( 0 ), mEndingSampleInclusive( 0 ), mData1( 0 ), mData2( 0 ), mType( 0 ), mFlags( 0 )
+{
+}
+
+bool Frame::HasFlag( U8 flag )
+{
+    return ( mFlags & flag ) != 0;
+}
+
+void FrameV2::AddString( const char* key, const char* value )
+{
+    mFields.push_back( std::make_pair( std::string( key ), std::string( value ) ) );
+}
+
+void FrameV2::AddDouble( const char* key, double value )
+{
+    char text[ 32 ];
+    snprintf( text, sizeof( text ), "%g", value );
+    mFields.push_back( std::make_pair( std::string( key ), std::string( text ) ) );
+}
+
+void FrameV2::AddInteger( const char* key, S64 value )
+{
+    char text[ 32 ];
+    snprintf( text, sizeof( text ), "%lld", value );
+    mFields.push_back( std::make_pair( std::string( key ), std::string( text ) ) );
+}
+
+void FrameV2::AddBoolean( const char* key, bool value )
+{
+    mFields.push_back( std::make_pair( std::string( key ), std::string( value ? "true" : "false" ) ) );
+}
+
+void FrameV2::AddByte( const char* key, U8 value )
+{
+    char text[ 8 ];
+    snprintf( text, sizeof( text ), "%02X", value );
+    mFields.push_back( std::make_pair( std::string( key ), std::string( text ) ) );
+}
+
+void FrameV2::AddByteArray( const char* key, const U8* data, U64 length )
+{
+    static const char hex_digits[] = "0123456789ABCDEF";
+    std::string text;
+    text.reserve( size_t( length * 2 ) );
+    for( U64 i = 0; i < length; i++ )
+    {
+        text += hex_digits[ data[ i ] >> 4 ];
+        text += hex_digits[ data[ i ] & 0xF ];
+    }
+    mFields.push_back( std::make_pair( std::string( key ), text ) );
+}
+
+AnalyzerResults::AnalyzerResults() : mMarkers( 0 ), mPackets( 0 ), mCommits( 0 ), mCommittedFrames( 0 ), mOrderViolations( 0 )
+{
+}
+
+AnalyzerResults::~AnalyzerResults()
+{
+}
+
+void AnalyzerResults::AddMarker( U64 sample_number, MarkerType marker_type, Channel& channel )
+{
+    std::map<Channel, U64>::iterator it = mLastMarkerSample.find( channel );
+    if( it == mLastMarkerSample.end() )
+    {
+        mLastMarkerSample[ channel ] = sample_number;
+    }
+    else
+    {
+        // Logic 2 needs the markers of a channel in sample order
+        if( sample_number < it->second )
+        {
+            AnalyzerHelpers::Assert( "marker added before the previous marker of its channel" );
+        }
+        it->second = sample_number;
+    }
+    mMarkers++;
+}
+
+U64 AnalyzerResults::AddFrame( const Frame& frame )
+{
+    if( frame.mEndingSampleInclusive < frame.mStartingSampleInclusive )
+    {
+        mOrderViolations++;
+    }
+    // a frame starts after the last sample of the frame before it, they must not even share a sample
+    if( !mFrames.empty() && ( frame.mStartingSampleInclusive <= mFrames.back().mEndingSampleInclusive ) )
+    {
+        mOrderViolations++;
+    }
+    mFrames.push_back( frame );
+    return mFrames.size() - 1;
+}
+
+void AnalyzerResults::AddFrameV2( const FrameV2& frame, const char* type, U64 starting_sample, U64 ending_sample )
+{
+    // a FrameV2 may span others (e.g. an APDU the FrameV2s of its blocks), but they are added in the order of their start
+    if( ending_sample < starting_sample )
+    {
+        mOrderViolations++;
+    }
+    if( !mFramesV2.empty() && ( starting_sample < mFramesV2.back().starting_sample ) )
+    {
+        mOrderViolations++;
+    }
+    FrameV2Record record;
+    record.type = type;
+    record.starting_sample = starting_sample;
+    record.ending_sample = ending_sample;
+    record.frame = frame;
+    mFramesV2.push_back( record );
+}
+
+U64 AnalyzerResults::CommitPacketAndStartNewPacket()
+{
+    return mPackets++;
+}
+
+void AnalyzerResults::CancelPacketAndStartNewPacket()
+{
+}
+
+void AnalyzerResults::AddPacketToTransaction( U64 transaction_id, U64 packet_id )
+{
+}
+
+void AnalyzerResults::AddChannelBubblesWillAppearOn( const Channel& channel )
+{
+}
+
+void AnalyzerResults::CommitResults()
+{
+    mCommits++;
+    mCommittedFrames = mFrames.size();
+}
+
+U64 AnalyzerResults::GetNumFrames()
+{
+    return mFrames.size();
+}
+
+U64 AnalyzerResults::GetNumPackets()
+{
+    return mPackets;
+}
+
+Frame AnalyzerResults::GetFrame( U64 frame_id )
+{
+    return mFrames[ size_t( frame_id ) ];
+}
+
+std::string AnalyzerResults::JoinStrings( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5,
+                                          const char* str6 )
+{
+    std::string text;
+    const char* strings[] = { str1, str2, str3, str4, str5, str6 };
+    for( const char* str : strings )
+    {
+        if( str != NULL )
+        {
+            text += str;
+        }
+    }
+    return text;
+}
+
+void AnalyzerResults::ClearTabularText()
+{
+    mTabularText.clear();
+}
+
+void AnalyzerResults::AddTabularText( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5,
+                                      const char* str6 )
+{
+    mTabularText.push_back( JoinStrings( str1, str2, str3, str4, str5, str6 ) );
+}
+
+void AnalyzerResults::ClearResultStrings()
+{
+    mResultStrings.clear();
+}
+
+void AnalyzerResults::AddResultString( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5,
+                                       const char* str6 )
+{
+    mResultStrings.push_back( JoinStrings( str1, str2, str3, str4, str5, str6 ) );
+}
+
+bool AnalyzerResults::UpdateExportProgressAndCheckForCancel( U64 completed_frames, U64 total_frames )
+{
+    return false;
+}
+
+AnalyzerSettingInterface::AnalyzerSettingInterface()
+{
+}
+
+AnalyzerSettingInterface::~AnalyzerSettingInterface()
+{
+}
+
+void AnalyzerSettingInterface::SetTitleAndTooltip( const char* title, const char* tooltip )
+{
+    mTitle = title;
+    mTooltip = tooltip;
+}
+
+AnalyzerSettingInterfaceChannel::AnalyzerSettingInterfaceChannel() : mChannel( UNDEFINED_CHANNEL ), mSelectionOfNoneIsAllowed( false )
+{
+}
+
+Channel AnalyzerSettingInterfaceChannel::GetChannel()
+{
+    return mChannel;
+}
+
+void AnalyzerSettingInterfaceChannel::SetChannel( const Channel& channel )
+{
+    mChannel = channel;
+}
+
+void AnalyzerSettingInterfaceChannel::SetSelectionOfNoneIsAllowed( bool is_allowed )
+{
+    mSelectionOfNoneIsAllowed = is_allowed;
+}
+
+AnalyzerSettingInterfaceNumberList::AnalyzerSettingInterfaceNumberList() : mNumber( 0.0 )
+{
+}
+
+double AnalyzerSettingInterfaceNumberList::GetNumber()
+{
+    return mNumber;
+}
+
+void AnalyzerSettingInterfaceNumberList::SetNumber( double number )
+{
+    mNumber = number;
+}
+
+void AnalyzerSettingInterfaceNumberList::AddNumber( double number, const char* str, const char* tooltip )
+{
+    mNumbers.push_back( number );
+    mStrings.push_back( str );
+    mTooltips.push_back( tooltip );
+}
+
+void AnalyzerSettingInterfaceNumberList::ClearNumbers()
+{
+    mNumbers.clear();
+    mStrings.clear();
+    mTooltips.clear();
+}
+
+AnalyzerSettingInterfaceInteger::AnalyzerSettingInterfaceInteger() : mInteger( 0 ), mMin( 0 ), mMax( 0 )
+{
+}
+
+int AnalyzerSettingInterfaceInteger::GetInteger()
+{
+    return mInteger;
+}
+
+void AnalyzerSettingInterfaceInteger::SetInteger( int integer )
+{
+    mInteger = integer;
+}
+
+void AnalyzerSettingInterfaceInteger::SetMax( int max )
+{
+    mMax = max;
+}
+
+void AnalyzerSettingInterfaceInteger::SetMin( int min )
+{
+    mMin = min;
+}
+
+AnalyzerSettingInterfaceText::AnalyzerSettingInterfaceText() : mTextType( NormalText )
+{
+}
+
+const char* AnalyzerSettingInterfaceText::GetText()
+{
+    return mText.c_str();
+}
+
+void AnalyzerSettingInterfaceText::SetText( const char* text )
+{
+    mText = text;
+}
+
+void AnalyzerSettingInterfaceText::SetTextType( TextType text_type )
+{
+    mTextType = text_type;
+}
+
+AnalyzerSettingInterfaceBool::AnalyzerSettingInterfaceBool() : mValue( false )
+{
+}
+
+bool AnalyzerSettingInterfaceBool::GetValue()
+{
+    return mValue;
+}
+
+void AnalyzerSettingInterfaceBool::SetValue( bool value )
+{
+    mValue = value;
+}
+
+void AnalyzerSettingInterfaceBool::SetCheckBoxText( const char* text )
+{
+    mCheckBoxText = text;
+}
+
+AnalyzerSettings::AnalyzerSettings()
+{
+}
+
+AnalyzerSettings::~AnalyzerSettings()
+{
+}
+
+void AnalyzerSettings::ClearChannels()
+{
+    mChannels.clear();
+}
+
+void AnalyzerSettings::AddChannel( Channel& channel, const char* channel_label, bool is_used )
+{
+    mChannels.push_back( channel );
+}
+
+void AnalyzerSettings::SetErrorText( const char* error_text )
+{
+    mErrorText = error_text;
+}
+
+void AnalyzerSettings::AddInterface( AnalyzerSettingInterface* analyzer_setting_interface )
+{
+    mInterfaces.push_back( analyzer_setting_interface );
+}
+
+void AnalyzerSettings::AddExportOption( U32 user_id, const char* menu_text )
+{
+    ExportOption option;
+    option.user_id = user_id;
+    option.menu_text = menu_text;
+    mExportOptions.push_back( option );
+}
+
+void AnalyzerSettings::AddExportExtension( U32 user_id, const char* extension_description, const char* extension )
+{
+}
+
+const char* AnalyzerSettings::SetReturnString( const char* str )
+{
+    mReturnString = str;
+    return mReturnString.c_str();
+}
+
+bool AnalyzerHelpers::IsEven( U64 value )
+{
+    return ( value & 1 ) == 0;
+}
+
+bool AnalyzerHelpers::IsOdd( U64 value )
+{
+    return ( value & 1 ) != 0;
+}
+
+U32 AnalyzerHelpers::GetOnesCount( U64 value )
+{
+    U32 count = 0;
+    for( ; value != 0; value &= value - 1 )
+    {
+        count++;
+    }
+    return count;
+}
+
+U32 AnalyzerHelpers::Diff32( U32 a, U32 b )
+{
+    return a > b ? a - b : b - a;
+}
+
+void AnalyzerHelpers::GetNumberString( U64 number, DisplayBase display_base, U32 num_data_bits, char* result_string,
+                                       U32 result_string_max_length )
+{
+    if( ( num_data_bits == 0 ) || ( num_data_bits > 64 ) )
+    {
+        num_data_bits = 64;
+    }
+
+    switch( display_base )
+    {
+    case Binary:
+    {
+        std::string text = "0b";
+        for( U32 bit = num_data_bits; bit > 0; bit-- )
+        {
+            text += ( ( number >> ( bit - 1 ) ) & 1 ) ? '1' : '0';
+        }
+        snprintf( result_string, result_string_max_length, "%s", text.c_str() );
+        break;
+    }
+    case Decimal:
+        snprintf( result_string, result_string_max_length, "%llu", number );
+        break;
+    case Hexadecimal:
+        snprintf( result_string, result_string_max_length, "0x%0*llX", int( ( num_data_bits + 3 ) / 4 ), number );
+        break;
+    case ASCII:
+    case AsciiHex:
+    {
+        char ascii[ 8 ];
+        if( ( number >= 0x20 ) && ( number < 0x7F ) )
+        {
+            snprintf( ascii, sizeof( ascii ), "%c", char( number ) );
+        }
+        else
+        {
+            snprintf( ascii, sizeof( ascii ), "\\x%02llX", number & 0xFF );
+        }
+        if( display_base == ASCII )
+        {
+            snprintf( result_string, result_string_max_length, "%s", ascii );
+        }
+        else
+        {
+            snprintf( result_string, result_string_max_length, "'%s' (0x%0*llX)", ascii, int( ( num_data_bits + 3 ) / 4 ), number );
+        }
+        break;
+    }
+    }
+}
+
+void AnalyzerHelpers::GetTimeString( U64 sample, U64 trigger_sample, U32 sample_rate_hz, char* result_string,
+                                     U32 result_string_max_length )
+{
+    double time_s = ( double( sample ) - double( trigger_sample ) ) / sample_rate_hz;
+    snprintf( result_string, result_string_max_length, "%.9f", time_s );
+}
+
+void AnalyzerHelpers::Assert( const char* message )
+{
+    fprintf( stderr, "assert: %s\n", message );
+    abort();
+}
+
+U64 AnalyzerHelpers::AdjustSimulationTargetSample( U64 target_sample, U32 sample_rate, U32 simulation_sample_rate )
+{
+    if( ( sample_rate == simulation_sample_rate ) || ( sample_rate == 0 ) )
+    {
+        return target_sample;
+    }
+    // split up, so target_sample * simulation_sample_rate does not overflow
+    U64 whole_seconds = target_sample / sample_rate;
+    U64 remaining_samples = target_sample % sample_rate;
+    return whole_seconds * simulation_sample_rate + remaining_samples * simulation_sample_rate / sample_rate;
+}
+
+bool AnalyzerHelpers::DoChannelsOverlap( const Channel* channel_array, U32 num_channels )
+{
+    for( U32 i = 0; i < num_channels; i++ )
+    {
+        for( U32 j = i + 1; j < num_channels; j++ )
+        {
+            if( ( channel_array[ i ] == channel_array[ j ] ) && ( channel_array[ i ] != UNDEFINED_CHANNEL ) )
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void AnalyzerHelpers::SaveFile( const char* file_name, const U8* data, U32 data_length, bool is_binary )
+{
+    FILE* file = fopen( file_name, is_binary ? "wb" : "w" );
+    if( file != nullptr )
+    {
+        fwrite( data, 1, data_length, file );
+        fclose( file );
+    }
+}
+
+S64 AnalyzerHelpers::ConvertToSignedNumber( U64 number, U32 num_bits )
+{
+    if( ( num_bits == 0 ) || ( num_bits >= 64 ) )
+    {
+        return S64( number );
+    }
+    U64 sign_bit = 1ULL << ( num_bits - 1 );
+    return ( number & sign_bit ) ? S64( number | ~( ( 1ULL << num_bits ) - 1 ) ) : S64( number );
+}
+
+SimpleArchive::SimpleArchive() : mReadPosition( 0 )
+{
+}
+
+SimpleArchive::~SimpleArchive()
+{
+}
+
+void SimpleArchive::SetString( const char* archive_string )
+{
+    mString = archive_string;
+    mReadPosition = 0;
+}
+
+const char* SimpleArchive::GetString()
+{
+    return mString.c_str();
+}
+
+bool SimpleArchive::ReadToken( std::string& token )
+{
+    while( ( mReadPosition < mString.size() ) && ( mString[ mReadPosition ] == ' ' ) )
+    {
+        mReadPosition++;
+    }
+    if( mReadPosition >= mString.size() )
+    {
+        return false;
+    }
+    size_t end = mString.find( ' ', mReadPosition );
+    if( end == std::string::npos )
+    {
+        end = mString.size();
+    }
+    token = mString.substr( mReadPosition, end - mReadPosition );
+    mReadPosition = end;
+    return true;
+}
+
+bool SimpleArchive::operator<<( U64 data )
+{
+    mString += std::to_string( data ) + " ";
+    return true;
+}
+
+bool SimpleArchive::operator<<( U32 data )
+{
+    mString += std::to_string( data ) + " ";
+    return true;
+}
+
+bool SimpleArchive::operator<<( S64 data )
+{
+    mString += std::to_string( data ) + " ";
+    return true;
+}
+
+bool SimpleArchive::operator<<( S32 data )
+{
+    mString += std::to_string( data ) + " ";
+    return true;
+}
+
+bool SimpleArchive::operator<<( double data )
+{
+    char text[ 32 ];
+    snprintf( text, sizeof( text ), "%.17g ", data );
+    mString += text;
+    return true;
+}
+
+bool SimpleArchive::operator<<( bool data )
+{
+    mString += data ? "1 " : "0 ";
+    return true;
+}
+
+bool SimpleArchive::operator<<( const char* data )
+{
+    mString += std::to_string( strlen( data ) ) + ":" + data + " ";
+    return true;
+}
+
+bool SimpleArchive::operator<<( Channel& data )
+{
+    mString += std::to_string( data.mDeviceId ) + " " + std::to_string( data.mChannelIndex ) + " ";
+    mString += std::to_string( U32( data.mDataType ) ) + " ";
+    return true;
+}
+
+bool SimpleArchive::operator>>( U64& data )
+{
+    std::string token;
+    if( !ReadToken( token ) )
+    {
+        return false;
+    }
+    data = strtoull( token.c_str(), nullptr, 10 );
+    return true;
+}
+
+bool SimpleArchive::operator>>( U32& data )
+{
+    U64 value;
+    if( !( *this >> value ) )
+    {
+        return false;
+    }
+    data = U32( value );
+    return true;
+}
+
+bool SimpleArchive::operator>>( S64& data )
+{
+    std::string token;
+    if( !ReadToken( token ) )
+    {
+        return false;
+    }
+    data = strtoll( token.c_str(), nullptr, 10 );
+    return true;
+}
+
+bool SimpleArchive::operator>>( S32& data )
+{
+    S64 value;
+    if( !( *this >> value ) )
+    {
+        return false;
+    }
+    data = S32( value );
+    return true;
+}
+
+bool SimpleArchive::operator>>( double& data )
+{
+    std::string token;
+    if( !ReadToken( token ) )
+    {
+        return false;
+    }
+    data = strtod( token.c_str(), nullptr );
+    return true;
+}
+
+bool SimpleArchive::operator>>( bool& data )
+{
+    U64 value;
+    if( !( *this >> value ) )
+    {
+        return false;
+    }
+    data = value != 0;
+    return true;
+}
+
+bool SimpleArchive::operator>>( char const** data )
+{
+    while( ( mReadPosition < mString.size() ) && ( mString[ mReadPosition ] == ' ' ) )
+    {
+        mReadPosition++;
+    }
+    size_t separator = mString.find( ':', mReadPosition );
+    if( separator == std::string::npos )
+    {
+        return false;
+    }
+    size_t length = size_t( strtoull( mString.c_str() + mReadPosition, nullptr, 10 ) );
+    if( separator + 1 + length > mString.size() )
+    {
+        return false;
+    }
+    mReadStrings.push_back( mString.substr( separator + 1, length ) );
+    mReadPosition = separator + 1 + length;
+    *data = mReadStrings.back().c_str();
+    return true;
+}
+
+bool SimpleArchive::operator>>( Channel& data )
+{
+    U64 device_id;
+    U32 channel_index;
+    U32 data_type;
+    if( !( *this >> device_id ) || !( *this >> channel_index ) || !( *this >> data_type ) )
+    {
+        return false;
+    }
+    data = Channel( device_id, channel_index, ChannelDataType( data_type ) );
+    return true;
+}
+
+ClockGenerator::ClockGenerator() : mSamplesPerHalfPeriod( 1.0 ), mSampleRateHz( 1.0 ), mError( 0.0 )
+{
+}
+
+ClockGenerator::~ClockGenerator()
+{
+}
+
+void ClockGenerator::Init( double target_frequency, U32 sample_rate_hz )
+{
+    mSampleRateHz = sample_rate_hz;
+    mSamplesPerHalfPeriod = mSampleRateHz / ( target_frequency * 2.0 );
+    mError = 0.0;
+}
+
+U32 ClockGenerator::AdvanceByHalfPeriod( double multiple )
+{
+    double samples = mSamplesPerHalfPeriod * multiple + mError;
+    U32 whole_samples = U32( samples );
+    mError = samples - whole_samples;
+    return whole_samples;
+}
+
+U32 ClockGenerator::AdvanceByTimeS( double time_s )
+{
+    double samples = mSampleRateHz * time_s + mError;
+    U32 whole_samples = U32( samples );
+    mError = samples - whole_samples;
+    return whole_samples;
+}
+
+SimulationChannelDescriptor::SimulationChannelDescriptor()
+    : mChannel( UNDEFINED_CHANNEL ), mSampleRateHz( 0 ), mInitialBitState( BIT_LOW ), mCurrentBitState( BIT_LOW ), mCurrentSample( 0 )
+{
+}
+
+void SimulationChannelDescriptor::Transition()
+{
+    mEdges.push_back( mCurrentSample );
+    mCurrentBitState = mCurrentBitState == BIT_LOW ? BIT_HIGH : BIT_LOW;
+}
+
+void SimulationChannelDescriptor::TransitionIfNeeded( BitState bit_state )
+{
+    if( mCurrentBitState != bit_state )
+    {
+        Transition();
+    }
+}
+
+void SimulationChannelDescriptor::Advance( U32 num_samples_to_advance )
+{
+    mCurrentSample += num_samples_to_advance;
+}
+
+BitState SimulationChannelDescriptor::GetCurrentBitState()
+{
+    return mCurrentBitState;
+}
+
+U64 SimulationChannelDescriptor::GetCurrentSampleNumber()
+{
+    return mCurrentSample;
+}
+
+void SimulationChannelDescriptor::SetChannel( Channel& channel )
+{
+    mChannel = channel;
+}
+
+void SimulationChannelDescriptor::SetSampleRate( U32 sample_rate_hz )
+{
+    mSampleRateHz = sample_rate_hz;
+}
+
+void SimulationChannelDescriptor::SetInitialBitState( BitState intial_bit_state )
+{
+    mInitialBitState = intial_bit_state;
+    mCurrentBitState = intial_bit_state;
+}
+
+SimulationChannelDescriptorGroup::SimulationChannelDescriptorGroup()
+{
+    mChannels.reserve( MAX_CHANNELS );
+}
+
+SimulationChannelDescriptor* SimulationChannelDescriptorGroup::Add( Channel& channel, U32 sample_rate, BitState intial_bit_state )
+{
+    if( mChannels.size() >= MAX_CHANNELS )
+    {
+        AnalyzerHelpers::Assert( "too many simulation channels" );
+    }
+    mChannels.push_back( SimulationChannelDescriptor() );
+    SimulationChannelDescriptor* descriptor = &mChannels.back();
+    descriptor->SetChannel( channel );
+    descriptor->SetSampleRate( sample_rate );
+    descriptor->SetInitialBitState( intial_bit_state );
+    return descriptor;
+}
+
+void SimulationChannelDescriptorGroup::AdvanceAll( U32 num_samples_to_advance )
+{
+    for( SimulationChannelDescriptor& descriptor : mChannels )
+    {
+        descriptor.Advance( num_samples_to_advance );
+    }
+}
+
+SimulationChannelDescriptor* SimulationChannelDescriptorGroup::GetArray()
+{
+    return mChannels.data();
+}
+
+U32 SimulationChannelDescriptorGroup::GetCount()
+{
+    return U32( mChannels.size() );
+}
@@ -0,0 +1,87 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerSettings.h"
+#include "AnalyzerResults.h"
+#include "SimulationChannelDescriptor.h"
+#include <map>
+#include <memory>
+
+class AnalyzerChannelData;
+
+class ANALYZER_EXPORT Analyzer
+{
+  public:
+    Analyzer();
+    virtual ~Analyzer();
+
+    virtual void WorkerThread() = 0;
+    virtual U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate,
+                                        SimulationChannelDescriptor** simulation_channels ) = 0;
+    virtual U32 GetMinimumSampleRateHz() = 0;
+    virtual const char* GetAnalyzerName() const = 0;
+    virtual bool NeedsRerun() = 0;
+    virtual void SetupResults();
+
+    void SetAnalyzerSettings( AnalyzerSettings* settings );
+    void SetAnalyzerResults( AnalyzerResults* results );
+
+    AnalyzerChannelData* GetAnalyzerChannelData( Channel& channel );
+
+    void ReportProgress( U64 sample_number );
+    U64 GetTriggerSample();
+    U32 GetSampleRate();
+    U32 GetSimulationSampleRate();
+
+    void CheckIfThreadShouldExit();
+    void KillThread();
+
+    // headless runner only
+    AnalyzerSettings* GetAnalyzerSettings()
+    {
+        return mSettings;
+    }
+    AnalyzerResults* GetAnalyzerResults()
+    {
+        return mResults;
+    }
+    void SetSampleRate( U32 sample_rate_hz )
+    {
+        mSampleRateHz = sample_rate_hz;
+    }
+    void SetSimulationSampleRate( U32 sample_rate_hz )
+    {
+        mSimulationSampleRateHz = sample_rate_hz;
+    }
+    void SetChannelData( const Channel& channel, AnalyzerChannelData* channel_data )
+    {
+        mChannelData[ channel ] = channel_data;
+    }
+    U64 GetProgress() const
+    {
+        return mProgress;
+    }
+
+  private:
+    AnalyzerSettings* mSettings;
+    AnalyzerResults* mResults;
+    std::map<Channel, AnalyzerChannelData*> mChannelData;
+    U32 mSampleRateHz;
+    U32 mSimulationSampleRateHz;
+    U64 mProgress;
+};
+
+class ANALYZER_EXPORT Analyzer2 : public Analyzer
+{
+  public:
+    Analyzer2();
+
+    virtual void SetupResults();
+    void UseFrameV2();
+
+  private:
+    bool mUseFrameV2;
+};
+
+#endif // ANALYZER_H
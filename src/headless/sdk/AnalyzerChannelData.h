@@ -0,0 +1,44 @@
+#ifndef ANALYZER_CHANNEL_DATA
+#define ANALYZER_CHANNEL_DATA
+
+#include "LogicPublicTypes.h"
+#include <vector>
+
+// Thrown when the analyzer asks for samples after the end of the capture. In Logic 2 the call would block until the capture
+// grows and the worker thread is ended from outside, here the runner catches it.
+class HeadlessEndOfCapture
+{
+};
+
+// One channel of a capture as a list of ascending edge sample numbers.
+class AnalyzerChannelData
+{
+  public:
+    AnalyzerChannelData( const std::vector<U64>& edges, BitState initial_state, U64 end_sample );
+
+    U64 GetSampleNumber();
+    BitState GetBitState();
+
+    U32 Advance( U32 num_samples );
+    U32 AdvanceToAbsPosition( U64 sample_number );
+    void AdvanceToNextEdge();
+
+    U64 GetSampleOfNextEdge();
+    bool WouldAdvancingCauseTransition( U32 num_samples );
+    bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number );
+
+    void TrackMinimumPulseWidth();
+    U64 GetMinimumPulseWidthSoFar();
+
+    bool DoMoreTransitionsExistInCurrentData();
+
+  protected:
+    const U64* mEdges;
+    const U64* mNextEdge;
+    const U64* mEdgesEnd;
+    U64 mEndSample;
+    U64 mSampleNumber;
+    BitState mBitState;
+};
+
+#endif // ANALYZER_CHANNEL_DATA
@@ -0,0 +1,81 @@
+#ifndef ANALYZERHELPERS_H
+#define ANALYZERHELPERS_H
+
+#include "Analyzer.h"
+#include <string>
+#include <vector>
+
+class AnalyzerHelpers
+{
+  public:
+    static bool IsEven( U64 value );
+    static bool IsOdd( U64 value );
+    static U32 GetOnesCount( U64 value );
+    static U32 Diff32( U32 a, U32 b );
+
+    static void GetNumberString( U64 number, DisplayBase display_base, U32 num_data_bits, char* result_string,
+                                 U32 result_string_max_length );
+    static void GetTimeString( U64 sample, U64 trigger_sample, U32 sample_rate_hz, char* result_string, U32 result_string_max_length );
+
+    static void Assert( const char* message );
+    static U64 AdjustSimulationTargetSample( U64 target_sample, U32 sample_rate, U32 simulation_sample_rate );
+
+    static bool DoChannelsOverlap( const Channel* channel_array, U32 num_channels );
+    static void SaveFile( const char* file_name, const U8* data, U32 data_length, bool is_binary = false );
+
+    static S64 ConvertToSignedNumber( U64 number, U32 num_bits );
+};
+
+// Values separated by spaces, strings are stored with their length in front, so they may contain spaces.
+class SimpleArchive
+{
+  public:
+    SimpleArchive();
+    ~SimpleArchive();
+
+    void SetString( const char* archive_string );
+    const char* GetString();
+
+    bool operator<<( U64 data );
+    bool operator<<( U32 data );
+    bool operator<<( S64 data );
+    bool operator<<( S32 data );
+    bool operator<<( double data );
+    bool operator<<( bool data );
+    bool operator<<( const char* data );
+    bool operator<<( Channel& data );
+
+    bool operator>>( U64& data );
+    bool operator>>( U32& data );
+    bool operator>>( S64& data );
+    bool operator>>( S32& data );
+    bool operator>>( double& data );
+    bool operator>>( bool& data );
+    bool operator>>( char const** data );
+    bool operator>>( Channel& data );
+
+  protected:
+    bool ReadToken( std::string& token );
+
+    std::string mString;
+    size_t mReadPosition;
+    std::vector<std::string> mReadStrings;
+};
+
+class ClockGenerator
+{
+  public:
+    ClockGenerator();
+    ~ClockGenerator();
+
+    void Init( double target_frequency, U32 sample_rate_hz );
+    U32 AdvanceByHalfPeriod( double multiple = 1.0 );
+    U32 AdvanceByTimeS( double time_s );
+
+  protected:
+    double mSamplesPerHalfPeriod;
+    double mSampleRateHz;
+    double mError;
+};
+
+#endif // ANALYZERHELPERS_H
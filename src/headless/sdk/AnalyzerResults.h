@@ -0,0 +1,159 @@
+#ifndef ANALYZER_RESULTS
+#define ANALYZER_RESULTS
+
+#include "LogicPublicTypes.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define DISPLAY_AS_ERROR_FLAG ( 1 << 7 )
+#define DISPLAY_AS_WARNING_FLAG ( 1 << 6 )
+
+#define INVALID_RESULT_INDEX 0xFFFFFFFFFFFFFFFFull
+
+class Frame
+{
+  public:
+    Frame();
+
+    bool HasFlag( U8 flag );
+
+    S64 mStartingSampleInclusive;
+    S64 mEndingSampleInclusive;
+    U64 mData1;
+    U64 mData2;
+    U8 mType;
+    U8 mFlags;
+};
+
+// Keeps every field as key and text, so the runner can print them.
+class FrameV2
+{
+  public:
+    void AddString( const char* key, const char* value );
+    void AddDouble( const char* key, double value );
+    void AddInteger( const char* key, S64 value );
+    void AddBoolean( const char* key, bool value );
+    void AddByte( const char* key, U8 value );
+    void AddByteArray( const char* key, const U8* data, U64 length );
+
+    // headless runner only
+    const std::vector<std::pair<std::string, std::string> >& GetFields() const
+    {
+        return mFields;
+    }
+
+  protected:
+    std::vector<std::pair<std::string, std::string> > mFields;
+};
+
+// In-memory result store. Besides storing the results it checks the rules of Logic 2: frames and the markers of a channel
+// in ascending order, frames without overlap, FrameV2s in the order of their start.
+class AnalyzerResults
+{
+  public:
+    enum MarkerType
+    {
+        Dot,
+        ErrorDot,
+        Square,
+        ErrorSquare,
+        UpArrow,
+        DownArrow,
+        X,
+        ErrorX,
+        Start,
+        Stop,
+        One,
+        Zero
+    };
+
+    AnalyzerResults();
+    virtual ~AnalyzerResults();
+
+    virtual void GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base ) = 0;
+    virtual void GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id ) = 0;
+    virtual void GenerateFrameTabularText( U64 frame_index, DisplayBase display_base ) = 0;
+    virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base ) = 0;
+    virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base ) = 0;
+
+    void AddMarker( U64 sample_number, MarkerType marker_type, Channel& channel );
+
+    U64 AddFrame( const Frame& frame );
+    void AddFrameV2( const FrameV2& frame, const char* type, U64 starting_sample, U64 ending_sample );
+    U64 CommitPacketAndStartNewPacket();
+    void CancelPacketAndStartNewPacket();
+    void AddPacketToTransaction( U64 transaction_id, U64 packet_id );
+    void AddChannelBubblesWillAppearOn( const Channel& channel );
+
+    void CommitResults();
+
+    U64 GetNumFrames();
+    U64 GetNumPackets();
+    Frame GetFrame( U64 frame_id );
+
+    void ClearTabularText();
+    void AddTabularText( const char* str1, const char* str2 = NULL, const char* str3 = NULL, const char* str4 = NULL,
+                         const char* str5 = NULL, const char* str6 = NULL );
+
+    void ClearResultStrings();
+    void AddResultString( const char* str1, const char* str2 = NULL, const char* str3 = NULL, const char* str4 = NULL,
+                          const char* str5 = NULL, const char* str6 = NULL );
+
+    bool UpdateExportProgressAndCheckForCancel( U64 completed_frames, U64 total_frames );
+
+    // headless runner only
+    struct FrameV2Record
+    {
+        std::string type;
+        U64 starting_sample;
+        U64 ending_sample;
+        FrameV2 frame;
+    };
+    const std::vector<FrameV2Record>& GetFramesV2() const
+    {
+        return mFramesV2;
+    }
+    const std::vector<std::string>& GetResultStrings() const
+    {
+        return mResultStrings;
+    }
+    const std::vector<std::string>& GetTabularText() const
+    {
+        return mTabularText;
+    }
+    U64 GetNumMarkers() const
+    {
+        return mMarkers;
+    }
+    U64 GetNumCommits() const
+    {
+        return mCommits;
+    }
+    U64 GetNumCommittedFrames() const
+    {
+        return mCommittedFrames;
+    }
+    U64 GetOrderViolations() const
+    {
+        return mOrderViolations;
+    }
+
+  private:
+    static std::string JoinStrings( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5,
+                                    const char* str6 );
+
+    std::vector<Frame> mFrames;
+    std::vector<FrameV2Record> mFramesV2;
+    std::vector<std::string> mResultStrings;
+    std::vector<std::string> mTabularText;
+    std::map<Channel, U64> mLastMarkerSample;
+    U64 mMarkers;
+    U64 mPackets;
+    U64 mCommits;
+    U64 mCommittedFrames;
+    U64 mOrderViolations;
+};
+
+#endif // ANALYZER_RESULTS
@@ -0,0 +1,125 @@
+#ifndef ANALYZER_SETTING_INTERFACE
+#define ANALYZER_SETTING_INTERFACE
+
+#include "LogicPublicTypes.h"
+#include <string>
+#include <vector>
+
+class AnalyzerSettingInterface
+{
+  public:
+    AnalyzerSettingInterface();
+    virtual ~AnalyzerSettingInterface();
+
+    void SetTitleAndTooltip( const char* title, const char* tooltip );
+
+    // headless runner only
+    const char* GetTitle() const
+    {
+        return mTitle.c_str();
+    }
+
+  protected:
+    std::string mTitle;
+    std::string mTooltip;
+};
+
+class AnalyzerSettingInterfaceChannel : public AnalyzerSettingInterface
+{
+  public:
+    AnalyzerSettingInterfaceChannel();
+
+    Channel GetChannel();
+    void SetChannel( const Channel& channel );
+    void SetSelectionOfNoneIsAllowed( bool is_allowed );
+
+  protected:
+    Channel mChannel;
+    bool mSelectionOfNoneIsAllowed;
+};
+
+class AnalyzerSettingInterfaceNumberList : public AnalyzerSettingInterface
+{
+  public:
+    AnalyzerSettingInterfaceNumberList();
+
+    double GetNumber();
+    void SetNumber( double number );
+
+    void AddNumber( double number, const char* str, const char* tooltip );
+    void ClearNumbers();
+
+    // headless runner only
+    U32 GetListboxNumbersCount() const
+    {
+        return U32( mNumbers.size() );
+    }
+    double GetListboxNumber( U32 index ) const
+    {
+        return mNumbers[ index ];
+    }
+    const char* GetListboxString( U32 index ) const
+    {
+        return mStrings[ index ].c_str();
+    }
+
+  protected:
+    double mNumber;
+    std::vector<double> mNumbers;
+    std::vector<std::string> mStrings;
+    std::vector<std::string> mTooltips;
+};
+
+class AnalyzerSettingInterfaceInteger : public AnalyzerSettingInterface
+{
+  public:
+    AnalyzerSettingInterfaceInteger();
+
+    int GetInteger();
+    void SetInteger( int integer );
+
+    void SetMax( int max );
+    void SetMin( int min );
+
+  protected:
+    int mInteger;
+    int mMin;
+    int mMax;
+};
+
+class AnalyzerSettingInterfaceText : public AnalyzerSettingInterface
+{
+  public:
+    enum TextType
+    {
+        NormalText,
+        FilePath,
+        FolderPath
+    };
+
+    AnalyzerSettingInterfaceText();
+
+    const char* GetText();
+    void SetText( const char* text );
+    void SetTextType( TextType text_type );
+
+  protected:
+    std::string mText;
+    TextType mTextType;
+};
+
+class AnalyzerSettingInterfaceBool : public AnalyzerSettingInterface
+{
+  public:
+    AnalyzerSettingInterfaceBool();
+
+    bool GetValue();
+    void SetValue( bool value );
+    void SetCheckBoxText( const char* text );
+
+  protected:
+    bool mValue;
+    std::string mCheckBoxText;
+};
+
+#endif // ANALYZER_SETTING_INTERFACE
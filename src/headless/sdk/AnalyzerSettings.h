@@ -0,0 +1,59 @@
+#ifndef ANALYZER_SETTINGS
+#define ANALYZER_SETTINGS
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerSettingInterface.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class AnalyzerSettings
+{
+  public:
+    AnalyzerSettings();
+    virtual ~AnalyzerSettings();
+
+    virtual bool SetSettingsFromInterfaces() = 0;
+    virtual void LoadSettings( const char* settings ) = 0;
+    virtual const char* SaveSettings() = 0;
+
+    // headless runner only
+    struct ExportOption
+    {
+        U32 user_id;
+        std::string menu_text;
+    };
+    const std::vector<AnalyzerSettingInterface*>& GetInterfaces() const
+    {
+        return mInterfaces;
+    }
+    const std::vector<ExportOption>& GetExportOptions() const
+    {
+        return mExportOptions;
+    }
+    const char* GetErrorText() const
+    {
+        return mErrorText.c_str();
+    }
+
+  protected:
+    void ClearChannels();
+    void AddChannel( Channel& channel, const char* channel_label, bool is_used );
+
+    void SetErrorText( const char* error_text );
+    void AddInterface( AnalyzerSettingInterface* analyzer_setting_interface );
+
+    void AddExportOption( U32 user_id, const char* menu_text );
+    void AddExportExtension( U32 user_id, const char* extension_description, const char* extension );
+
+    const char* SetReturnString( const char* str );
+
+  private:
+    std::vector<AnalyzerSettingInterface*> mInterfaces;
+    std::vector<ExportOption> mExportOptions;
+    std::vector<Channel> mChannels;
+    std::string mErrorText;
+    std::string mReturnString;
+};
+
+#endif // ANALYZER_SETTINGS
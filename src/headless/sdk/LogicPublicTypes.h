@@ -0,0 +1,89 @@
+#ifndef LOGICPUBLICTYPES
+#define LOGICPUBLICTYPES
+
+// Stand-ins for the headers of the Saleae Analyzer SDK with the same names. They declare the part of the SDK the plugins use,
+// so the plugin sources compile unchanged against the in-memory implementation of the headless runner.
+
+#if defined( _WIN32 )
+#define ANALYZER_EXPORT
+#else
+#define __cdecl
+#define ANALYZER_EXPORT __attribute__( ( visibility( "default" ) ) )
+#endif
+
+typedef signed char S8;
+typedef short S16;
+typedef int S32;
+typedef long long int S64;
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+typedef unsigned int U32;
+typedef unsigned long long int U64;
+
+enum DisplayBase
+{
+    Binary,
+    Decimal,
+    Hexadecimal,
+    ASCII,
+    AsciiHex
+};
+
+enum BitState
+{
+    BIT_LOW,
+    BIT_HIGH
+};
+
+enum ChannelDataType
+{
+    ANALOG_CHANNEL,
+    DIGITAL_CHANNEL,
+    UNKNOWN_CHANNEL
+};
+
+class Channel
+{
+  public:
+    Channel() : mDeviceId( 0 ), mChannelIndex( 0 ), mDataType( DIGITAL_CHANNEL )
+    {
+    }
+    Channel( U64 device_id, U32 channel_index, ChannelDataType data_type = DIGITAL_CHANNEL )
+        : mDeviceId( device_id ), mChannelIndex( channel_index ), mDataType( data_type )
+    {
+    }
+
+    bool operator==( const Channel& other ) const
+    {
+        return ( mDeviceId == other.mDeviceId ) && ( mChannelIndex == other.mChannelIndex ) && ( mDataType == other.mDataType );
+    }
+    bool operator!=( const Channel& other ) const
+    {
+        return !( *this == other );
+    }
+    bool operator<( const Channel& other ) const
+    {
+        if( mDeviceId != other.mDeviceId )
+        {
+            return mDeviceId < other.mDeviceId;
+        }
+        if( mChannelIndex != other.mChannelIndex )
+        {
+            return mChannelIndex < other.mChannelIndex;
+        }
+        return mDataType < other.mDataType;
+    }
+    bool operator>( const Channel& other ) const
+    {
+        return other < *this;
+    }
+
+    U64 mDeviceId;
+    U32 mChannelIndex;
+    ChannelDataType mDataType;
+};
+
+static const Channel UNDEFINED_CHANNEL = Channel( 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFF, UNKNOWN_CHANNEL );
+
+#endif // LOGICPUBLICTYPES
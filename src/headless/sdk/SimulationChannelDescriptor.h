@@ -0,0 +1,64 @@
+#ifndef SIMULATION_CHANNEL_DESCRIPTOR
+#define SIMULATION_CHANNEL_DESCRIPTOR
+
+#include "LogicPublicTypes.h"
+#include <vector>
+
+class SimulationChannelDescriptor
+{
+  public:
+    SimulationChannelDescriptor();
+
+    void Transition();
+    void TransitionIfNeeded( BitState bit_state );
+    void Advance( U32 num_samples_to_advance );
+
+    BitState GetCurrentBitState();
+    U64 GetCurrentSampleNumber();
+
+    void SetChannel( Channel& channel );
+    void SetSampleRate( U32 sample_rate_hz );
+    void SetInitialBitState( BitState intial_bit_state );
+
+    // headless runner only
+    const Channel& GetChannel() const
+    {
+        return mChannel;
+    }
+    BitState GetInitialBitState() const
+    {
+        return mInitialBitState;
+    }
+    const std::vector<U64>& GetEdges() const
+    {
+        return mEdges;
+    }
+
+  protected:
+    Channel mChannel;
+    U32 mSampleRateHz;
+    BitState mInitialBitState;
+    BitState mCurrentBitState;
+    U64 mCurrentSample;
+    std::vector<U64> mEdges;
+};
+
+class SimulationChannelDescriptorGroup
+{
+  public:
+    SimulationChannelDescriptorGroup();
+
+    SimulationChannelDescriptor* Add( Channel& channel, U32 sample_rate, BitState intial_bit_state );
+    void AdvanceAll( U32 num_samples_to_advance );
+
+    SimulationChannelDescriptor* GetArray();
+    U32 GetCount();
+
+  protected:
+    // the descriptors are handed out as pointers, so the storage never moves
+    static const U32 MAX_CHANNELS = 16;
+
+    std::vector<SimulationChannelDescriptor> mChannels;
+};
+
+#endif // SIMULATION_CHANNEL_DESCRIPTOR
@@ -1,17 +1,19 @@
 #include "Iso14443aLoadmodAnalyzer.h"
 #include "Iso14443aLoadmodAnalyzerSettings.h"
 #include "Iso14443aLoadmodAnalyzerResults.h"
+#include "Iso14443aBlockFields.h"
 #include "AnalyzerHelpers.h"
 #include <AnalyzerChannelData.h>
-#include <deque>
-#include <tuple>
-#include <algorithm>
 
-U32 FREQ_CARRIER = 13560000;
+static const U32 COMMIT_MAX_PENDING_FRAMES = 1024;
 
 
 Iso14443aLoadmodAnalyzer::Iso14443aLoadmodAnalyzer()
-    : Analyzer2(), mSettings( new Iso14443aLoadmodAnalyzerSettings() ), mSimulationInitilized( false )
+    : Analyzer2(),
+      mSettings( new Iso14443aLoadmodAnalyzerSettings() ),
+      mLoadmodDecoder( mLoadmodEdgeSource, *this ),
+      mBlockDecoder( *this ),
+      mSimulationInitilized( false )
 {
     SetAnalyzerSettings( mSettings.get() );
     UseFrameV2();
@@ -32,281 +34,139 @@ void Iso14443aLoadmodAnalyzer::SetupResults()
 }
 
 
-std::tuple<U8, U64> Iso14443aLoadmodAnalyzer::ReceiveLoadmodSeq( LoadmodFrame& loadmod_frame )
+void Iso14443aLoadmodAnalyzer::OnMarker( U64 sample, Iso14443a::MarkerType type )
 {
-    U32 bit_changes = 0;
-    U8 seq = 0;
-    BitState bit_state = BIT_LOW;
-
-    U64 seq_start_sample = loadmod_frame.frame_start_sample + U64( loadmod_frame.seq_num * mLoadmodSamplesPerBit );
-    loadmod_frame.seq_num++;
-
-    // mark start of sequence
-    mResults->AddMarker( U64( seq_start_sample ), AnalyzerResults::Start, mSettings->mLoadmodInputChannel );
-
-    // wait for first bit quarter
-    loadmod_frame.frame_end_sample = seq_start_sample + U64( mLoadmodSamplesPerBit * ( 1.0 / 4.0 ) );
-    bit_changes = mLoadmodSerial->AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
-
-    // save bit state in the middel of the bit half to check the state
-    bit_state = mLoadmodSerial->GetBitState();
-
-    // mark sampling point
-    mResults->AddMarker( mLoadmodSerial->GetSampleNumber(), AnalyzerResults::Dot, mSettings->mLoadmodInputChannel );
-
-    // wait for second bit quarter
-    loadmod_frame.frame_end_sample = seq_start_sample + U64( mLoadmodSamplesPerBit * ( 2.0 / 4.0 ) );
-    bit_changes += mLoadmodSerial->AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
-    if( ( bit_changes >= 6 ) && ( bit_changes <= 9 ) )
+    switch( type )
     {
-        // modulation available
-        seq |= 0b10;
-    }
-    else if( ( bit_state == mLoadmodIdleState ) && ( bit_changes <= 2 ) )
-    {
-        // no modulation available
-    }
-    else
-    {
-        return { LOADMOD_SEQ_ERROR, seq_start_sample };
+    case Iso14443a::MarkerType::SequenceStart:
+        mResults->AddMarker( sample, AnalyzerResults::Start, mSettings->mLoadmodInputChannel );
+        break;
+    case Iso14443a::MarkerType::SamplingPoint:
+        mResults->AddMarker( sample, AnalyzerResults::Dot, mSettings->mLoadmodInputChannel );
+        break;
+    case Iso14443a::MarkerType::Error:
+        mResults->AddMarker( sample, AnalyzerResults::ErrorX, mSettings->mLoadmodInputChannel );
+        break;
     }
+}
 
-    // mark sampling point
-    mResults->AddMarker( mLoadmodSerial->GetSampleNumber(), AnalyzerResults::Dot, mSettings->mLoadmodInputChannel );
-
-    // wait for third bit quarter
-    loadmod_frame.frame_end_sample = seq_start_sample + U64( mLoadmodSamplesPerBit * ( 3.0 / 4.0 ) );
-    bit_changes = mLoadmodSerial->AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
-
-    // save bit state in the middel of the bit half to check the state
-    bit_state = mLoadmodSerial->GetBitState();
-
-    // mark sampling point
-    mResults->AddMarker( mLoadmodSerial->GetSampleNumber(), AnalyzerResults::Dot, mSettings->mLoadmodInputChannel );
-
-    // wait for fourth bit quarter
-    loadmod_frame.frame_end_sample = seq_start_sample + U64( mLoadmodSamplesPerBit );
-    bit_changes += mLoadmodSerial->AdvanceToAbsPosition( loadmod_frame.frame_end_sample );
-
-    if( ( bit_changes >= 6 ) && ( bit_changes <= 9 ) )
-    {
-        // modulation available
-        seq |= 0b01;
-    }
-    else if( ( bit_state == mLoadmodIdleState ) && ( bit_changes <= 2 ) )
-    {
-        // no modulation available
-    }
-    else
+void Iso14443aLoadmodAnalyzer::AddResultFrame( Frame& frame )
+{
+    mResults->AddFrame( frame );
+    if( mCommitScheduler.AddFrame( frame.mEndingSampleInclusive ) )
     {
-        return { LOADMOD_SEQ_ERROR, seq_start_sample };
+        mResults->CommitResults();
+        ReportProgress( frame.mEndingSampleInclusive );
     }
+}
 
+void Iso14443aLoadmodAnalyzer::OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+{
     if( mLoadmodOutputFormat == LoadmodOutputFormat::Sequences )
     {
         Frame frame;
         frame.mType = FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE;
         frame.mData1 = seq;
-        frame.mStartingSampleInclusive = seq_start_sample;
-        frame.mEndingSampleInclusive = S64( seq_start_sample + mLoadmodSamplesPerBit );
-        mResults->AddFrame( frame );
-        mResults->CommitResults();
-        ReportProgress( frame.mEndingSampleInclusive );
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
-
-    return { seq, seq_start_sample };
 }
 
-
-Iso14443aLoadmodAnalyzer::LoadmodFrame::LoadmodError
-Iso14443aLoadmodAnalyzer::ReceiveLoadmodFrameStartOfCommunication( LoadmodFrame& loadmod_frame )
+void Iso14443aLoadmodAnalyzer::OnStartOfCommunication( U64 start_sample, U64 end_sample )
 {
-    // wait for edge as start condition (eg. rising edge)
-    mLoadmodSerial->AdvanceToNextEdge();
-    loadmod_frame.frame_start_sample = mLoadmodSerial->GetSampleNumber();
-    loadmod_frame.seq_num = 0;
-
-    // detect start of communication
-    auto seq = ReceiveLoadmodSeq( loadmod_frame );
-
-    if( std::get<0>( seq ) != LOADMOD_SEQ_D )
+    if( mLoadmodOutputFormat == LoadmodOutputFormat::Bytes )
     {
-        // ERROR
-        loadmod_frame.error = LoadmodFrame::LoadmodError::ErrorWrongSoc;
-        return loadmod_frame.error;
+        Frame frame;
+        frame.mType = FRAME_TYPE_VIEW_BYTES_SOC;
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
+}
 
-    // Save SOC
+void Iso14443aLoadmodAnalyzer::OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+{
     if( mLoadmodOutputFormat == LoadmodOutputFormat::Bytes )
     {
         Frame frame;
-        frame.mType = FRAME_TYPE_VIEW_BYTES_SOC;
-        frame.mStartingSampleInclusive = loadmod_frame.frame_start_sample;
-        frame.mEndingSampleInclusive = U64( loadmod_frame.frame_start_sample + mLoadmodSamplesPerBit ) - 1;
-        mResults->AddFrame( frame );
-        mResults->CommitResults();
-        ReportProgress( frame.mEndingSampleInclusive );
+        frame.mData1 = byte;
+        frame.mData2 = valid_bits;
+        frame.mType = FRAME_TYPE_VIEW_BYTES_BYTE;
+        frame.mFlags = parity_error ? FRAME_FLAG_PARITY_ERROR : 0;
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
-
-    return LoadmodFrame::LoadmodError::Ok;
 }
 
-
-Iso14443aLoadmodAnalyzer::LoadmodFrame::LoadmodError Iso14443aLoadmodAnalyzer::ReceiveLoadmodFrameData( LoadmodFrame& loadmod_frame )
+void Iso14443aLoadmodAnalyzer::OnEndOfCommunication( U64 start_sample, U64 end_sample )
 {
-    bool end_of_communication = false;
-
-    std::deque<std::tuple<U8, U64>> bit_buffer;
-
-    while( true )
+    if( mLoadmodOutputFormat == LoadmodOutputFormat::Bytes )
     {
-        auto seq = ReceiveLoadmodSeq( loadmod_frame );
-
-        if( std::get<0>( seq ) == LOADMOD_SEQ_D )
-        {
-            // logic "1"
-            bit_buffer.push_back( { 1, std::get<1>( seq ) } );
-        }
-        else if( std::get<0>( seq ) == LOADMOD_SEQ_E )
-        {
-            // logic "0"
-            bit_buffer.push_back( { 0, std::get<1>( seq ) } );
-        }
-        else if( std::get<0>( seq ) == LOADMOD_SEQ_F )
-        {
-            end_of_communication = true;
-        }
-        else
-        {
-            // ERROR
-            loadmod_frame.error = LoadmodFrame::LoadmodError::ErrorWrongSequence;
-            return loadmod_frame.error;
-        }
-
-        bool byte_complete = bit_buffer.size() == 9; // 8 data bits + 1 parity bit
-
-        // If a byte is completely recevied or an "end of communication" is detected (incomplete bytes are valid) show it
-        if( byte_complete || end_of_communication )
-        {
-            S8 bits_in_byte = S8( bit_buffer.size() );
-
-            if( end_of_communication )
-            {
-                bits_in_byte--; // last bit belogs to eoc
-            }
-
-            if( bits_in_byte > 0 )
-            {
-                U64 bit_starting_sample = std::get<1>( bit_buffer[ 0 ] );
-                U64 bit_ending_sample = 0;
-                U8 byte = 0;
-                for( U8 i = 0; i < std::min( U8( bits_in_byte ), U8( 8 ) ); i++ )
-                {
-                    byte |= std::get<0>( bit_buffer[ 0 ] ) << i;
-                    bit_ending_sample = std::get<1>( bit_buffer[ 0 ] );
-                    bit_buffer.pop_front();
-                }
-
-                U8 frame_flags = 0;
-                if( bits_in_byte == 9 )
-                {
-                    U8 parity_bit = std::get<0>( bit_buffer[ 0 ] );
-                    bit_ending_sample = std::get<1>( bit_buffer[ 0 ] );
-                    bit_buffer.pop_front();
-                    bits_in_byte--;
-
-                    if( AnalyzerHelpers::IsOdd( AnalyzerHelpers::GetOnesCount( byte ) ) == bool( parity_bit ) )
-                    {
-                        frame_flags = FRAME_FLAG_PARITY_ERROR;
-                        loadmod_frame.error = LoadmodFrame::LoadmodError::ErrorParity;
-                    }
-                }
-
-                bit_ending_sample += U64( mLoadmodSamplesPerBit );
-
-                loadmod_frame.data.push_back( byte );
-                loadmod_frame.data_valid_bits_in_last_byte = bits_in_byte;
-
-                if( mLoadmodOutputFormat == LoadmodOutputFormat::Bytes )
-                {
-                    Frame frame;
-                    frame.mData1 = byte;
-                    frame.mData2 = bits_in_byte;
-                    frame.mType = FRAME_TYPE_VIEW_BYTES_BYTE;
-                    frame.mFlags = frame_flags;
-                    frame.mStartingSampleInclusive = bit_starting_sample;
-                    frame.mEndingSampleInclusive = bit_ending_sample;
-                    mResults->AddFrame( frame );
-                    mResults->CommitResults();
-                    ReportProgress( frame.mEndingSampleInclusive );
-                }
-            }
-        }
-
-        if( end_of_communication == true )
-        {
-            U64 eoc_starting_sample = std::get<1>( seq );
-            U64 eoc_ending_sample = U64( eoc_starting_sample + ( 2 * mLoadmodSamplesPerBit ) ) - 1;
-            loadmod_frame.frame_end_sample = eoc_ending_sample;
-
-            if( mLoadmodOutputFormat == LoadmodOutputFormat::Bytes )
-            {
-                Frame frame;
-                frame.mType = FRAME_TYPE_VIEW_BYTES_EOC;
-                frame.mStartingSampleInclusive = eoc_starting_sample;
-                frame.mEndingSampleInclusive = eoc_ending_sample;
-                mResults->AddFrame( frame );
-                mResults->CommitResults();
-                ReportProgress( frame.mEndingSampleInclusive );
-            }
-
-            // End of communication
-            break;
-        }
+        Frame frame;
+        frame.mType = FRAME_TYPE_VIEW_BYTES_EOC;
+        frame.mStartingSampleInclusive = start_sample;
+        frame.mEndingSampleInclusive = end_sample;
+        AddResultFrame( frame );
     }
 }
 
-void Iso14443aLoadmodAnalyzer::ReportLoadmodFrame( LoadmodFrame& loadmod_frame )
+void Iso14443aLoadmodAnalyzer::OnFrame( const Iso14443a::DecodedFrame& loadmod_frame, U64 start_sample, U64 end_sample )
 {
-    FrameV2 frameV2;
+    // ISO14443-3 state after this frame
+    Iso14443a::CommandType type = mCommandDecoder.DecodeResponse( loadmod_frame );
+    mLoadmodDecoder.SetUidResponseExpected( mCommandDecoder.IsUidResponseExpected() );
+
+    // ISO14443-4 block, a finished APDU is queued in front of the frame of its first block
+    Iso14443a::BlockInfo block;
+    bool has_block = false;
+    if( type == Iso14443a::CommandType::Unknown )
+    {
+        has_block = mBlockDecoder.DecodeBlock( loadmod_frame, true, start_sample, end_sample, block );
+    }
+    else
+    {
+        // an ISO14443-3 frame leaves the ISO14443-4 protocol, an unfinished chain was aborted
+        mBlockDecoder.Reset();
+    }
+
+    Iso14443aFrameV2Queue::Record& frameV2 = mFramesV2.Add( "loadmod_frame", start_sample, end_sample );
 
     frameV2.AddByteArray( "value", loadmod_frame.data.data(), loadmod_frame.data.size() );
-    const char* status = "";
-    switch( loadmod_frame.error )
-    {
-    case LoadmodFrame::LoadmodError::Ok:
-        status = "OK";
-        break;
-    case LoadmodFrame::LoadmodError::ErrorWrongSoc:
-        status = "SOC_ERROR";
-        break;
-    case LoadmodFrame::LoadmodError::ErrorWrongSequence:
-        status = "SEQUENCE_ERROR";
-        break;
-    case LoadmodFrame::LoadmodError::ErrorParity:
-        status = "PARITY_ERROR";
-        break;
-    };
-    frameV2.AddString( "status", status );
+    frameV2.AddString( "status", Iso14443a::GetFrameStatusString( loadmod_frame.error ) );
+    frameV2.AddString( "crc", Iso14443a::GetCrcStatusString( loadmod_frame.crc ) );
     frameV2.AddInteger( "valid_bits_of_last_byte", loadmod_frame.data_valid_bits_in_last_byte );
-    mResults->AddFrameV2( frameV2, "loadmod_frame", loadmod_frame.frame_start_sample, loadmod_frame.frame_end_sample );
 
-    mResults->CommitResults();
-    ReportProgress( loadmod_frame.frame_end_sample );
-}
+    frameV2.AddString( "type", Iso14443a::GetCommandTypeString( type ) );
+    frameV2.AddInteger( "cascade_level", mCommandDecoder.GetCascadeLevel() );
+    if( mCommandDecoder.GetUidLength() > 0 )
+    {
+        frameV2.AddByteArray( "uid", mCommandDecoder.GetUid(), mCommandDecoder.GetUidLength() );
+    }
 
-void Iso14443aLoadmodAnalyzer::ReceiveLoadmodFrame()
-{
-    LoadmodFrame loadmod_frame;
-    LoadmodFrame::LoadmodError loadmod_error;
+    if( has_block )
+    {
+        AddBlockFields( frameV2, block );
+    }
 
-    loadmod_error = ReceiveLoadmodFrameStartOfCommunication( loadmod_frame );
-    if( loadmod_error == LoadmodFrame::LoadmodError::Ok )
+    // the frames of a chain wait for their APDU
+    if( !mBlockDecoder.IsChaining() )
     {
-        loadmod_error = ReceiveLoadmodFrameData( loadmod_frame );
+        mFramesV2.Flush( *mResults );
     }
 
-    ReportLoadmodFrame( loadmod_frame );
+    mResults->CommitResults();
+    ReportProgress( end_sample );
+    mCommitScheduler.Flush( end_sample );
+}
+
+void Iso14443aLoadmodAnalyzer::OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample )
+{
+    Iso14443aFrameV2Queue::Record& frameV2 = mFramesV2.Insert( "apdu", start_sample, end_sample );
+
+    frameV2.AddByteArray( "data", data, length );
+    frameV2.AddInteger( "blocks", block_count );
 }
 
 void Iso14443aLoadmodAnalyzer::WorkerThread()
@@ -314,17 +174,55 @@ void Iso14443aLoadmodAnalyzer::WorkerThread()
     mSampleRateHz = GetSampleRate();
 
     mLoadmodSerial = GetAnalyzerChannelData( mSettings->mLoadmodInputChannel );
-    mLoadmodSamplesPerBit = double( mSampleRateHz ) * ( double( 128 ) / double( FREQ_CARRIER ) );
     mLoadmodIdleState = mSettings->mLoadmodIdleState;
     mLoadmodOutputFormat = mSettings->mLoadmodOutputFormat;
 
+    // the decoding modes only apply to the subcarrier, the envelope has a single one
+    Iso14443a::LoadmodSequenceDetection detection = Iso14443a::LoadmodSequenceDetection::SamplingPoints;
+    if( mSettings->mLoadmodInputType == LoadmodInputType::EnvelopeInput )
+    {
+        detection = Iso14443a::LoadmodSequenceDetection::Envelope;
+    }
+    else if( mSettings->mLoadmodDecodingMode == LoadmodDecodingMode::SubcarrierEdges )
+    {
+        detection = Iso14443a::LoadmodSequenceDetection::SubcarrierEdges;
+    }
+
+    mLoadmodEdgeSource.SetChannelData( mLoadmodSerial );
+    mLoadmodDecoder.Setup( mSampleRateHz, mSettings->mLoadmodCarrierHz,
+                           mLoadmodIdleState == BIT_HIGH ? Iso14443a::LINE_HIGH : Iso14443a::LINE_LOW, detection );
+    mLoadmodDecoder.SetCarrierCalibration( mSettings->mLoadmodCalibrationFrames );
+
+    mCommandDecoder.Reset();
+    mLoadmodDecoder.SetUidResponseExpected( mCommandDecoder.IsUidResponseExpected() );
+    mBlockDecoder.Reset();
+    mFramesV2.Clear();
+
+    // commit at least every 10 ms of signal
+    mCommitScheduler.Setup( mSampleRateHz / 100, COMMIT_MAX_PENDING_FRAMES );
+
+    switch( mSettings->mLoadmodMarkerDetail )
+    {
+    case LoadmodMarkerDetail::NoMarkers:
+        mLoadmodDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::None );
+        break;
+    case LoadmodMarkerDetail::ErrorMarkers:
+        mLoadmodDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::Errors );
+        break;
+    case LoadmodMarkerDetail::SequenceStartMarkers:
+        mLoadmodDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::SequenceStarts );
+        break;
+    case LoadmodMarkerDetail::SamplingPointMarkers:
+        mLoadmodDecoder.SetMarkerDetail( Iso14443a::MarkerDetail::SamplingPoints );
+        break;
+    }
+
     // Wait for idle state (eg. low)
-    if( mLoadmodSerial->GetBitState() != mLoadmodIdleState )
-        mLoadmodSerial->AdvanceToNextEdge();
+    mLoadmodDecoder.WaitForIdle();
 
     for( ;; )
     {
-        ReceiveLoadmodFrame();
+        mLoadmodDecoder.DecodeFrame();
     }
 }
 
@@ -338,7 +236,7 @@ U32 Iso14443aLoadmodAnalyzer::GenerateSimulationData( U64 minimum_sample_index,
 {
     if( mSimulationInitilized == false )
     {
-        mSimulationDataGenerator.Initialize( GetSimulationSampleRate(), mSettings.get() );
+        mSimulationDataGenerator.Initialize( GetSimulationSampleRate(), mSettings->mLoadmodCarrierHz, mSettings.get() );
         mSimulationInitilized = true;
     }
 
@@ -347,10 +245,17 @@ U32 Iso14443aLoadmodAnalyzer::GenerateSimulationData( U64 minimum_sample_index,
 
 U32 Iso14443aLoadmodAnalyzer::GetMinimumSampleRateHz()
 {
+    // The envelope changes twice per bit at most, the bit grid follows it with 8 samples per bit:
+    //   13,56 MHz / 16 = ca. 848 kHz
+    if( mSettings->mLoadmodInputType == LoadmodInputType::EnvelopeInput )
+    {
+        return mSettings->mLoadmodCarrierHz / 16;
+    }
+
     // Subcarrier = (13,56 MHz / 16) = ca. 848kHz
-    // Multiplikator = 4;
-    //   => 3,39 MHz
-    return ( FREQ_CARRIER * 4 ) / 16;
+    // Multiplikator = 3; (the bit grid follows the subcarrier bursts, below that the subcarrier aliases)
+    //   => 2,54 MHz
+    return ( mSettings->mLoadmodCarrierHz * 3 ) / 16;
 }
 
 const char* Iso14443aLoadmodAnalyzer::GetAnalyzerName() const
@@ -5,10 +5,16 @@
 #include "Iso14443aLoadmodAnalyzerResults.h"
 #include "Iso14443aLoadmodAnalyzerSettings.h"
 #include "Iso14443aLoadmodSimulationDataGenerator.h"
+#include "Iso14443aChannelEdgeSource.h"
+#include "Iso14443aLoadmodDecoder.h"
+#include "Iso14443aCommitScheduler.h"
+#include "Iso14443aCommandDecoder.h"
+#include "Iso14443aBlockDecoder.h"
+#include "Iso14443aFrameV2Queue.h"
 
 
 class Iso14443aLoadmodAnalyzerSettings;
-class ANALYZER_EXPORT Iso14443aLoadmodAnalyzer : public Analyzer2
+class ANALYZER_EXPORT Iso14443aLoadmodAnalyzer : public Analyzer2, public Iso14443a::DecoderSink, public Iso14443a::ApduSink
 {
   public:
     Iso14443aLoadmodAnalyzer();
@@ -23,36 +29,30 @@ class ANALYZER_EXPORT Iso14443aLoadmodAnalyzer : public Analyzer2
     virtual const char* GetAnalyzerName() const;
     virtual bool NeedsRerun();
 
-  protected: // vars
-    struct LoadmodFrame
-    {
-        U64 frame_start_sample{ 0U }; // first sample of frame
-        U64 frame_end_sample{ 0U }; // last sample of frame
-
-        U32 seq_num{ 0U }; // sequence count of complete frame
-
-        std::vector<U8> data;                  // data of the frame
-        U8 data_valid_bits_in_last_byte{ 0U }; // the last data byte can be incomplete, so here are the valid bit count saved
-
-        enum class LoadmodError
-        {
-            Ok = 0,
-            ErrorWrongSoc = 1,
-            ErrorWrongSequence = 2,
-            ErrorParity = 3,
-        };
-        LoadmodError error{ LoadmodError::Ok };
-    };
-
-    std::tuple<U8, U64> ReceiveLoadmodSeq( LoadmodFrame& loadmod_fram );
-    LoadmodFrame::LoadmodError ReceiveLoadmodFrameStartOfCommunication( LoadmodFrame& loadmod_frame );
-    LoadmodFrame::LoadmodError ReceiveLoadmodFrameData( LoadmodFrame& loadmod_frame );
-    void ReportLoadmodFrame( LoadmodFrame& loadmod_frame );
-    void ReceiveLoadmodFrame();
+  protected: // decoder sink
+    virtual void OnMarker( U64 sample, Iso14443a::MarkerType type );
+    virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample );
+    virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample );
+    virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample );
+    virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample );
+    virtual void OnFrame( const Iso14443a::DecodedFrame& loadmod_frame, U64 start_sample, U64 end_sample );
+
+  protected: // apdu sink
+    virtual void OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample );
 
+  protected: // functions
+    void AddResultFrame( Frame& frame );
+
+  protected: // vars
     std::unique_ptr<Iso14443aLoadmodAnalyzerSettings> mSettings;
     std::unique_ptr<Iso14443aLoadmodAnalyzerResults> mResults;
     AnalyzerChannelData* mLoadmodSerial;
+    Iso14443aChannelEdgeSource mLoadmodEdgeSource;
+    Iso14443a::LoadmodDecoder mLoadmodDecoder;
+    Iso14443a::CommitScheduler mCommitScheduler;
+    Iso14443a::CommandDecoder mCommandDecoder;
+    Iso14443a::BlockDecoder mBlockDecoder;
+    Iso14443aFrameV2Queue mFramesV2;
 
     Iso14443aLoadmodSimulationDataGenerator mSimulationDataGenerator;
     bool mSimulationInitilized;
@@ -60,7 +60,6 @@ class ANALYZER_EXPORT Iso14443aLoadmodAnalyzer : public Analyzer2
     // Serial analysis vars:
     U32 mSampleRateHz;
 
-    double mLoadmodSamplesPerBit;
     BitState mLoadmodIdleState;
     LoadmodOutputFormat mLoadmodOutputFormat;
 
@@ -2,21 +2,14 @@
 #define ISO14443A_LOADMOD_ANALYZER_RESULTS
 
 #include <AnalyzerResults.h>
+#include "Iso14443aDecoderTypes.h"
+#include "Iso14443aResultFrames.h"
+#include "Iso14443aResultText.h"
 
-static const U8 FRAME_TYPE_VIEW_MASK = 0b00000011;
-static const U8 FRAME_TYPE_VIEW_SEQUENCES_SEQUENCE = 0b00000000;
-static const U8 FRAME_TYPE_VIEW_BYTES_BYTE = 0b00000001;
-static const U8 FRAME_TYPE_VIEW_BYTES_SOC = 0b00000010;
-static const U8 FRAME_TYPE_VIEW_BYTES_EOC = 0b00000011;
-
-static const U8 FRAME_FLAG_PARITY_ERROR = 1;
-
-static const U8 LOADMOD_SEQ_D = 0b10;
-static const U8 LOADMOD_SEQ_E = 0b01;
-static const U8 LOADMOD_SEQ_F = 0b00;
-static const U8 LOADMOD_SEQ_ERROR = 0b100;
-
-std::string format_string( char const* const format, ... );
+using Iso14443a::LOADMOD_SEQ_D;
+using Iso14443a::LOADMOD_SEQ_E;
+using Iso14443a::LOADMOD_SEQ_F;
+using Iso14443a::LOADMOD_SEQ_ERROR;
 
 class Iso14443aLoadmodAnalyzer;
 class Iso14443aLoadmodAnalyzerSettings;
@@ -38,6 +31,7 @@ class Iso14443aLoadmodAnalyzerResults : public AnalyzerResults
   protected: // vars
     Iso14443aLoadmodAnalyzerSettings* mSettings;
     Iso14443aLoadmodAnalyzer* mAnalyzer;
+    Iso14443aResultText mResultText;
 };
 
 #endif // ISO14443A_LOADMOD_ANALYZER_RESULTS
@@ -1,9 +1,16 @@
 #include "Iso14443aLoadmodAnalyzerSettings.h"
 #include <AnalyzerHelpers.h>
+#include "Iso14443aDecoderTypes.h"
 
 
 Iso14443aLoadmodAnalyzerSettings::Iso14443aLoadmodAnalyzerSettings()
-    : mLoadmodInputChannel( UNDEFINED_CHANNEL ), mLoadmodIdleState( BIT_HIGH )
+    : mLoadmodInputChannel( UNDEFINED_CHANNEL ),
+      mLoadmodIdleState( BIT_HIGH ),
+      mLoadmodInputType( LoadmodInputType::SubcarrierInput ),
+      mLoadmodDecodingMode( LoadmodDecodingMode::SubcarrierEdges ),
+      mLoadmodMarkerDetail( LoadmodMarkerDetail::SamplingPointMarkers ),
+      mLoadmodCarrierHz( Iso14443a::NOMINAL_CARRIER_HZ ),
+      mLoadmodCalibrationFrames( 0 )
 {
     mLoadmodInputChannelInterface.reset( new AnalyzerSettingInterfaceChannel() );
     mLoadmodInputChannelInterface->SetTitleAndTooltip( "Channel", "" );
@@ -21,13 +28,60 @@ Iso14443aLoadmodAnalyzerSettings::Iso14443aLoadmodAnalyzerSettings()
     mLoadmodOutputFormatInterface->AddNumber( LoadmodOutputFormat::Bytes, "Bytes", "" );
     mLoadmodOutputFormatInterface->SetNumber( mLoadmodOutputFormat );
 
+    mLoadmodInputTypeInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mLoadmodInputTypeInterface->SetTitleAndTooltip( "Input", "" );
+    mLoadmodInputTypeInterface->AddNumber( LoadmodInputType::SubcarrierInput, "Subcarrier", "" );
+    mLoadmodInputTypeInterface->AddNumber( LoadmodInputType::EnvelopeInput, "Demodulated Envelope", "" );
+    mLoadmodInputTypeInterface->SetNumber( mLoadmodInputType );
+
+    mLoadmodDecodingModeInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mLoadmodDecodingModeInterface->SetTitleAndTooltip( "Decoding", "" );
+    mLoadmodDecodingModeInterface->AddNumber( LoadmodDecodingMode::SamplingPoints, "Sampling Points", "" );
+    mLoadmodDecodingModeInterface->AddNumber( LoadmodDecodingMode::SubcarrierEdges, "Subcarrier Edges", "" );
+    mLoadmodDecodingModeInterface->SetNumber( mLoadmodDecodingMode );
+
+    mLoadmodMarkerDetailInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mLoadmodMarkerDetailInterface->SetTitleAndTooltip( "Markers", "" );
+    mLoadmodMarkerDetailInterface->AddNumber( LoadmodMarkerDetail::NoMarkers, "None", "" );
+    mLoadmodMarkerDetailInterface->AddNumber( LoadmodMarkerDetail::ErrorMarkers, "Errors Only", "" );
+    mLoadmodMarkerDetailInterface->AddNumber( LoadmodMarkerDetail::SequenceStartMarkers, "Sequence Starts", "" );
+    mLoadmodMarkerDetailInterface->AddNumber( LoadmodMarkerDetail::SamplingPointMarkers, "Sampling Points", "" );
+    mLoadmodMarkerDetailInterface->SetNumber( mLoadmodMarkerDetail );
+
+    mLoadmodCarrierHzInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mLoadmodCarrierHzInterface->SetTitleAndTooltip( "Carrier (Hz)", "" );
+    mLoadmodCarrierHzInterface->SetMin( Iso14443a::MIN_CARRIER_HZ );
+    mLoadmodCarrierHzInterface->SetMax( Iso14443a::MAX_CARRIER_HZ );
+    mLoadmodCarrierHzInterface->SetInteger( mLoadmodCarrierHz );
+
+    mLoadmodCalibrationFramesInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mLoadmodCalibrationFramesInterface->SetTitleAndTooltip( "Carrier Calibration", "" );
+    mLoadmodCalibrationFramesInterface->AddNumber( 0, "Off", "" );
+    mLoadmodCalibrationFramesInterface->AddNumber( 8, "First 8 Frames", "" );
+    mLoadmodCalibrationFramesInterface->AddNumber( 32, "First 32 Frames", "" );
+    mLoadmodCalibrationFramesInterface->AddNumber( 128, "First 128 Frames", "" );
+    mLoadmodCalibrationFramesInterface->SetNumber( mLoadmodCalibrationFrames );
+
     AddInterface( mLoadmodInputChannelInterface.get() );
     AddInterface( mLoadmodIdleStateInterface.get() );
     AddInterface( mLoadmodOutputFormatInterface.get() );
-
-    AddExportOption( 0, "Export as text/csv file" );
-    AddExportExtension( 0, "text", "txt" );
-    AddExportExtension( 0, "csv", "csv" );
+    AddInterface( mLoadmodInputTypeInterface.get() );
+    AddInterface( mLoadmodDecodingModeInterface.get() );
+    AddInterface( mLoadmodMarkerDetailInterface.get() );
+    AddInterface( mLoadmodCarrierHzInterface.get() );
+    AddInterface( mLoadmodCalibrationFramesInterface.get() );
+
+    AddExportOption( ExportText, "Export as text/csv file" );
+    AddExportExtension( ExportText, "text", "txt" );
+    AddExportExtension( ExportText, "csv", "csv" );
+    AddExportOption( ExportPcapng, "Export as pcapng file (Wireshark)" );
+    AddExportExtension( ExportPcapng, "pcapng", "pcapng" );
+    AddExportOption( ExportSequences, "Export sequences as text/csv file" );
+    AddExportExtension( ExportSequences, "csv", "csv" );
+    AddExportOption( ExportBytes, "Export bytes as text/csv file" );
+    AddExportExtension( ExportBytes, "csv", "csv" );
+    AddExportOption( ExportFrames, "Export frames as text/csv file" );
+    AddExportExtension( ExportFrames, "csv", "csv" );
 
     ClearChannels();
     AddChannel( mLoadmodInputChannel, "LOADMOD", false );
@@ -39,9 +93,20 @@ Iso14443aLoadmodAnalyzerSettings::~Iso14443aLoadmodAnalyzerSettings()
 
 bool Iso14443aLoadmodAnalyzerSettings::SetSettingsFromInterfaces()
 {
+    if( !Iso14443a::IsValidCarrier( U32( mLoadmodCarrierHzInterface->GetInteger() ) ) )
+    {
+        SetErrorText( "The carrier must be between 13 and 14 MHz." );
+        return false;
+    }
+
     mLoadmodInputChannel = mLoadmodInputChannelInterface->GetChannel();
     mLoadmodIdleState = ( BitState )U32( mLoadmodIdleStateInterface->GetNumber() );
     mLoadmodOutputFormat = ( LoadmodOutputFormat )U32( mLoadmodOutputFormatInterface->GetNumber() );
+    mLoadmodInputType = ( LoadmodInputType )U32( mLoadmodInputTypeInterface->GetNumber() );
+    mLoadmodDecodingMode = ( LoadmodDecodingMode )U32( mLoadmodDecodingModeInterface->GetNumber() );
+    mLoadmodMarkerDetail = ( LoadmodMarkerDetail )U32( mLoadmodMarkerDetailInterface->GetNumber() );
+    mLoadmodCarrierHz = U32( mLoadmodCarrierHzInterface->GetInteger() );
+    mLoadmodCalibrationFrames = U32( mLoadmodCalibrationFramesInterface->GetNumber() );
 
     ClearChannels();
     AddChannel( mLoadmodInputChannel, "LOADMOD", true );
@@ -54,6 +119,11 @@ void Iso14443aLoadmodAnalyzerSettings::UpdateInterfacesFromSettings()
     mLoadmodInputChannelInterface->SetChannel( mLoadmodInputChannel );
     mLoadmodIdleStateInterface->SetNumber( mLoadmodIdleState );
     mLoadmodOutputFormatInterface->SetNumber( mLoadmodOutputFormat );
+    mLoadmodInputTypeInterface->SetNumber( mLoadmodInputType );
+    mLoadmodDecodingModeInterface->SetNumber( mLoadmodDecodingMode );
+    mLoadmodMarkerDetailInterface->SetNumber( mLoadmodMarkerDetail );
+    mLoadmodCarrierHzInterface->SetInteger( int( mLoadmodCarrierHz ) );
+    mLoadmodCalibrationFramesInterface->SetNumber( mLoadmodCalibrationFrames );
 }
 
 void Iso14443aLoadmodAnalyzerSettings::LoadSettings( const char* settings )
@@ -65,6 +135,28 @@ void Iso14443aLoadmodAnalyzerSettings::LoadSettings( const char* settings )
     text_archive >> *( U32* )&mLoadmodIdleState;
     text_archive >> *( U32* )&mLoadmodOutputFormat;
 
+    // settings saved by older versions end here
+    if( !( text_archive >> *( U32* )&mLoadmodDecodingMode ) )
+    {
+        mLoadmodDecodingMode = LoadmodDecodingMode::SamplingPoints;
+    }
+    if( !( text_archive >> *( U32* )&mLoadmodMarkerDetail ) )
+    {
+        mLoadmodMarkerDetail = LoadmodMarkerDetail::SamplingPointMarkers;
+    }
+    if( !( text_archive >> *( U32* )&mLoadmodInputType ) )
+    {
+        mLoadmodInputType = LoadmodInputType::SubcarrierInput;
+    }
+    if( !( text_archive >> mLoadmodCarrierHz ) || !Iso14443a::IsValidCarrier( mLoadmodCarrierHz ) )
+    {
+        mLoadmodCarrierHz = Iso14443a::NOMINAL_CARRIER_HZ;
+    }
+    if( !( text_archive >> mLoadmodCalibrationFrames ) )
+    {
+        mLoadmodCalibrationFrames = 0;
+    }
+
     ClearChannels();
     AddChannel( mLoadmodInputChannel, "LOADMOD", true );
 
@@ -78,6 +170,11 @@ const char* Iso14443aLoadmodAnalyzerSettings::SaveSettings()
     text_archive << mLoadmodInputChannel;
     text_archive << mLoadmodIdleState;
     text_archive << mLoadmodOutputFormat;
+    text_archive << mLoadmodDecodingMode;
+    text_archive << mLoadmodMarkerDetail;
+    text_archive << mLoadmodInputType;
+    text_archive << mLoadmodCarrierHz;
+    text_archive << mLoadmodCalibrationFrames;
 
     return SetReturnString( text_archive.GetString() );
 }
@@ -10,6 +10,35 @@ enum LoadmodOutputFormat
     Bytes = 1,
 };
 
+enum LoadmodInputType
+{
+    SubcarrierInput = 0,
+    EnvelopeInput = 1,
+};
+
+enum LoadmodDecodingMode
+{
+    SamplingPoints = 0,
+    SubcarrierEdges = 1,
+};
+
+enum LoadmodMarkerDetail
+{
+    NoMarkers = 0,
+    ErrorMarkers = 1,
+    SequenceStartMarkers = 2,
+    SamplingPointMarkers = 3,
+};
+
+enum LoadmodExportType
+{
+    ExportText = 0,
+    ExportPcapng = 1,
+    ExportSequences = 2,
+    ExportBytes = 3,
+    ExportFrames = 4,
+};
+
 class Iso14443aLoadmodAnalyzerSettings : public AnalyzerSettings
 {
   public:
@@ -25,11 +54,21 @@ class Iso14443aLoadmodAnalyzerSettings : public AnalyzerSettings
     Channel mLoadmodInputChannel;
     BitState mLoadmodIdleState;
     LoadmodOutputFormat mLoadmodOutputFormat;
+    LoadmodInputType mLoadmodInputType;
+    LoadmodDecodingMode mLoadmodDecodingMode;
+    LoadmodMarkerDetail mLoadmodMarkerDetail;
+    U32 mLoadmodCarrierHz;
+    U32 mLoadmodCalibrationFrames;
 
   protected:
     std::unique_ptr<AnalyzerSettingInterfaceChannel> mLoadmodInputChannelInterface;
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mLoadmodIdleStateInterface;
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mLoadmodOutputFormatInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mLoadmodInputTypeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mLoadmodDecodingModeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mLoadmodMarkerDetailInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mLoadmodCarrierHzInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mLoadmodCalibrationFramesInterface;
 };
 
 #endif // ISO14443A_LOADMOD_ANALYZER_SETTINGS
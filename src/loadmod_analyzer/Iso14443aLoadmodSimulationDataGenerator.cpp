@@ -4,8 +4,7 @@
 #include <AnalyzerHelpers.h>
 
 Iso14443aLoadmodSimulationDataGenerator::Iso14443aLoadmodSimulationDataGenerator()
-:	mSerialText( "My first analyzer, woo hoo!" ),
-	mStringIndex( 0 )
+    : mSettings( nullptr ), mSimulationSampleRateHz( 0 ), mSessionGenerator( mNullSink, mSimulationSink )
 {
 }
 
@@ -13,59 +12,36 @@ Iso14443aLoadmodSimulationDataGenerator::~Iso14443aLoadmodSimulationDataGenerato
 {
 }
 
-void Iso14443aLoadmodSimulationDataGenerator::Initialize( U32 simulation_sample_rate, Iso14443aLoadmodAnalyzerSettings* settings )
+void Iso14443aLoadmodSimulationDataGenerator::Initialize( U32 simulation_sample_rate, U32 carrier_hz,
+                                                          Iso14443aLoadmodAnalyzerSettings* settings )
 {
-	mSimulationSampleRateHz = simulation_sample_rate;
-	mSettings = settings;
-
-	mSerialSimulationData.SetChannel( mSettings->mLoadmodInputChannel );
-	mSerialSimulationData.SetSampleRate( simulation_sample_rate );
-	mSerialSimulationData.SetInitialBitState( BIT_HIGH );
-}
-
-U32 Iso14443aLoadmodSimulationDataGenerator::GenerateSimulationData( U64 largest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channel )
-{
-	U64 adjusted_largest_sample_requested = AnalyzerHelpers::AdjustSimulationTargetSample( largest_sample_requested, sample_rate, mSimulationSampleRateHz );
-
-	while( mSerialSimulationData.GetCurrentSampleNumber() < adjusted_largest_sample_requested )
-	{
-		CreateSerialByte();
-	}
-
-	*simulation_channel = &mSerialSimulationData;
-	return 1;
+    mSimulationSampleRateHz = simulation_sample_rate;
+    mSettings = settings;
+
+    mSimulationData.SetChannel( mSettings->mLoadmodInputChannel );
+    mSimulationData.SetSampleRate( simulation_sample_rate );
+    mSimulationData.SetInitialBitState( mSettings->mLoadmodIdleState );
+    mSimulationSink.SetChannel( &mSimulationData );
+
+    std::vector<Iso14443a::ScriptFrame> frames;
+    std::string error;
+    Iso14443a::ParseFrameScript( Iso14443a::GetDefaultFrameScript(), frames, error );
+    mSessionGenerator.Setup( simulation_sample_rate, carrier_hz, frames );
+    mSessionGenerator.SetPiccEnvelope( mSettings->mLoadmodInputType == LoadmodInputType::EnvelopeInput );
 }
 
-void Iso14443aLoadmodSimulationDataGenerator::CreateSerialByte()
+U32 Iso14443aLoadmodSimulationDataGenerator::GenerateSimulationData( U64 largest_sample_requested, U32 sample_rate,
+                                                                     SimulationChannelDescriptor** simulation_channel )
 {
-	U32 samples_per_bit = mSimulationSampleRateHz / 1000;//mSettings->mBitRate;
-
-	U8 byte = mSerialText[ mStringIndex ];
-	mStringIndex++;
-	if( mStringIndex == mSerialText.size() )
-		mStringIndex = 0;
-
-	//we're currenty high
-	//let's move forward a little
-	mSerialSimulationData.Advance( samples_per_bit * 10 );
-
-	mSerialSimulationData.Transition();  //low-going edge for start bit
-	mSerialSimulationData.Advance( samples_per_bit );  //add start bit time
-
-	U8 mask = 0x1 << 7;
-	for( U32 i=0; i<8; i++ )
-	{
-		if( ( byte & mask ) != 0 )
-			mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-		else
-			mSerialSimulationData.TransitionIfNeeded( BIT_LOW );
-
-		mSerialSimulationData.Advance( samples_per_bit );
-		mask = mask >> 1;
-	}
+    U64 adjusted_largest_sample_requested = AnalyzerHelpers::AdjustSimulationTargetSample( largest_sample_requested, sample_rate, mSimulationSampleRateHz );
 
-	mSerialSimulationData.TransitionIfNeeded( BIT_HIGH ); //we need to end high
+    // the frames are generated as a whole, the channel follows up to the end of the last one
+    while( mSessionGenerator.GetPosition() < adjusted_largest_sample_requested )
+    {
+        mSessionGenerator.AddNextFrame();
+    }
+    mSimulationSink.AdvanceTo( mSessionGenerator.GetPosition() );
 
-	//lets pad the end a bit for the stop bit:
-	mSerialSimulationData.Advance( samples_per_bit );
+    *simulation_channel = &mSimulationData;
+    return 1;
 }
@@ -0,0 +1,1213 @@
+#include "Iso14443aAskDecoder.h"
+#include "Iso14443aLoadmodDecoder.h"
+#include "Iso14443aDualDecoder.h"
+#include "Iso14443aReplayEdgeSource.h"
+#include "Iso14443aEdgeFile.h"
+#include "Iso14443aCommitScheduler.h"
+#include "Iso14443aCrc.h"
+#include "Iso14443aCommandDecoder.h"
+#include "Iso14443aBlockDecoder.h"
+#include "Iso14443aPcapngWriter.h"
+#include "Iso14443aExportWriter.h"
+#include "Iso14443aSegmentedDecoder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace Iso14443a;
+
+static const U32 COMMIT_MAX_PENDING_FRAMES = 1024;
+
+// Every heap allocation of the process is counted, so the summary shows whether decoding allocates per byte or frame.
+// --check-allocations fails if the decoding allocates at all once the first frame has sized the buffers.
+static std::atomic<U64> allocation_count( 0 );
+
+void* operator new( size_t size )
+{
+    allocation_count++;
+    void* memory = malloc( size ? size : 1 );
+    if( memory == nullptr )
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete( void* memory ) noexcept
+{
+    free( memory );
+}
+
+// Counts the ISO14443-4 blocks and the APDUs reassembled from them, the APDUs are optionally printed.
+class ApduReplaySink : public ApduSink
+{
+  public:
+    ApduReplaySink( bool print_apdus ) : mPrintApdus( print_apdus )
+    {
+    }
+
+    void SetPrintApdus( bool print_apdus )
+    {
+        mPrintApdus = print_apdus;
+    }
+
+    void AddBlock( const BlockInfo& block )
+    {
+        mBlocksPerType[ U32( block.type ) ]++;
+    }
+
+    virtual void OnApdu( bool is_response, const U8* data, size_t length, U32 block_count, U64 start_sample, U64 end_sample )
+    {
+        mApdus++;
+        mApduBytes += length;
+        mMaxApduLength = std::max( mMaxApduLength, U64( length ) );
+        if( block_count > 1 )
+        {
+            mChainedApdus++;
+        }
+
+        if( mPrintApdus )
+        {
+            printf( "apdu,%llu,%llu,%s,%u,", start_sample, end_sample, is_response ? "PICC" : "PCD", block_count );
+            for( size_t i = 0; i < length; i++ )
+            {
+                printf( "%02X", data[ i ] );
+            }
+            printf( "\n" );
+        }
+    }
+
+    U64 mApdus{ 0U };
+    U64 mChainedApdus{ 0U };
+    U64 mApduBytes{ 0U };
+    U64 mMaxApduLength{ 0U };
+    U64 mBlocksPerType[ BLOCK_TYPE_COUNT ]{};
+
+  protected:
+    bool mPrintApdus;
+};
+
+// A result frame the way the analyzers store it, so the exports can be measured without the SDK.
+struct ResultFrameRecord
+{
+    enum class Type : U8
+    {
+        Sequence,
+        Soc,
+        Byte,
+        Eoc,
+    };
+
+    U64 start_sample;
+    U64 end_sample;
+    Type type;
+    U8 value;
+    U8 valid_bits;
+    bool parity_error;
+};
+
+// Counts everything the decoder reports and optionally prints the frames. The result frames the analyzers would add for the
+// chosen output format are counted as well, together with the commits they would need.
+class ReplaySink : public DecoderSink
+{
+  public:
+    ReplaySink( bool print_frames, bool output_bytes, ApduReplaySink& apdu_sink )
+        : mPrintFrames( print_frames ), mOutputBytes( output_bytes ), mApduSink( apdu_sink ), mBlockDecoder( apdu_sink )
+    {
+    }
+
+    void SetupCommits( U32 sample_rate_hz )
+    {
+        mCommitScheduler.Setup( sample_rate_hz / 100, COMMIT_MAX_PENDING_FRAMES );
+    }
+
+    void SetPrintFrames( bool print_frames )
+    {
+        mPrintFrames = print_frames;
+    }
+
+    // keeps the sequences and bytes for the export measurement, nullptr stops it
+    void SetResultFrameRecords( std::vector<ResultFrameRecord>* records )
+    {
+        mRecords = records;
+    }
+
+    // writes the bytes of every frame the way the analyzers export their result frames, nullptr stops it
+    void SetPcapngWriter( PcapngWriter* pcapng_writer )
+    {
+        mPcapngWriter = pcapng_writer;
+    }
+
+    // checks that the last sequence of every frame starts floor( n * samples per bit ) after its first one, within a sample
+    void SetupGridCheck( U32 sample_rate_hz, U32 carrier_hz )
+    {
+        mGridSampleRateHz = sample_rate_hz;
+        mGridCarrierHz = carrier_hz;
+    }
+
+    // tells the decoder of the responses when a UID CLn without CRC may come, nullptr stops it
+    void SetLoadmodDecoder( LoadmodDecoder* loadmod_decoder )
+    {
+        mLoadmodDecoder = loadmod_decoder;
+    }
+
+    // labels the frames as ISO14443-3 commands (PCD) or responses (PICC)
+    void SetupCommandDecoding( bool is_response )
+    {
+        mDecodeCommands = true;
+        mIsResponse = is_response;
+        mCommandDecoder.Reset();
+        mBlockDecoder.Reset();
+    }
+
+    virtual void OnMarker( U64 sample, MarkerType type )
+    {
+        mMarkers++;
+    }
+    virtual void OnSequence( U8 seq, U64 start_sample, U64 end_sample )
+    {
+        mSequences++;
+        if( mFrameSequences == 0 )
+        {
+            mFrameFirstSeqStart = start_sample;
+        }
+        mFrameLastSeqStart = start_sample;
+        mFrameSequences++;
+        if( !mOutputBytes )
+        {
+            AddResultFrame( end_sample );
+        }
+        Record( ResultFrameRecord::Type::Sequence, start_sample, end_sample, seq, 0, false );
+    }
+    virtual void OnStartOfCommunication( U64 start_sample, U64 end_sample )
+    {
+        if( mOutputBytes )
+        {
+            AddResultFrame( end_sample );
+        }
+        if( mPcapngWriter != nullptr )
+        {
+            mPcapngWriter->StartPacket( mIsResponse, start_sample );
+        }
+        Record( ResultFrameRecord::Type::Soc, start_sample, end_sample, 0, 0, false );
+    }
+    virtual void OnByte( U8 byte, U8 valid_bits, bool parity_error, U64 start_sample, U64 end_sample )
+    {
+        mBytes++;
+        if( mOutputBytes )
+        {
+            AddResultFrame( end_sample );
+        }
+        if( mPcapngWriter != nullptr )
+        {
+            mPcapngWriter->AddByte( mIsResponse, byte, valid_bits, parity_error );
+        }
+        Record( ResultFrameRecord::Type::Byte, start_sample, end_sample, byte, valid_bits, parity_error );
+    }
+    virtual void OnEndOfCommunication( U64 start_sample, U64 end_sample )
+    {
+        if( mOutputBytes )
+        {
+            AddResultFrame( end_sample );
+        }
+        if( mPcapngWriter != nullptr )
+        {
+            mPcapngWriter->EndPacket( mIsResponse );
+        }
+        Record( ResultFrameRecord::Type::Eoc, start_sample, end_sample, 0, 0, false );
+    }
+    virtual void OnResync( U64 start_sample, U64 end_sample, U64 skipped_edges )
+    {
+        mResyncs++;
+        mResyncSkippedSamples += end_sample - start_sample + 1;
+        mResyncSkippedEdges += skipped_edges;
+    }
+    virtual void OnFrame( const DecodedFrame& frame, U64 start_sample, U64 end_sample )
+    {
+        mFrames++;
+        mFramesPerBitRate[ U32( frame.bit_rate ) ]++;
+        mFramesPerCrcStatus[ U32( frame.crc ) ]++;
+        mResultFrames++;
+        mCommitScheduler.Flush( end_sample );
+        if( frame.error != DecodedFrame::Error::Ok )
+        {
+            mErrorFrames++;
+        }
+        if( ( mGridCarrierHz != 0 ) && ( mFrameSequences > 0 ) )
+        {
+            CheckGrid( frame.bit_rate );
+        }
+        mFrameSequences = 0;
+        if( mFrames == 1 )
+        {
+            mAllocationsAtFirstFrame = allocation_count;
+        }
+
+        CommandType type = CommandType::Unknown;
+        if( mDecodeCommands )
+        {
+            type = mIsResponse ? mCommandDecoder.DecodeResponse( frame ) : mCommandDecoder.DecodeCommand( frame );
+            mFramesPerCommandType[ U32( type ) ]++;
+            if( mLoadmodDecoder != nullptr )
+            {
+                mLoadmodDecoder->SetUidResponseExpected( mCommandDecoder.IsUidResponseExpected() );
+            }
+
+            BlockInfo block;
+            if( ( type == CommandType::Unknown ) && mBlockDecoder.DecodeBlock( frame, mIsResponse, start_sample, end_sample, block ) )
+            {
+                mApduSink.AddBlock( block );
+            }
+        }
+
+        if( mPrintFrames )
+        {
+            printf( "%llu,%llu,%s,%u,", start_sample, end_sample, GetFrameStatusString( frame.error ),
+                    U32( frame.data_valid_bits_in_last_byte ) );
+            for( U8 byte : frame.data )
+            {
+                printf( "%02X", byte );
+            }
+            printf( ",%s\n", GetCommandTypeString( type ) );
+        }
+    }
+
+    U64 mMarkers{ 0U };
+    U64 mSequences{ 0U };
+    U64 mBytes{ 0U };
+    U64 mFrames{ 0U };
+    U64 mErrorFrames{ 0U };
+    U64 mResultFrames{ 0U };
+    U64 mResyncs{ 0U };
+    U64 mResyncSkippedSamples{ 0U };
+    U64 mResyncSkippedEdges{ 0U };
+    U64 mFramesPerBitRate[ BIT_RATE_COUNT ]{};
+    U64 mFramesPerCrcStatus[ 3 ]{};
+    U64 mFramesPerCommandType[ COMMAND_TYPE_COUNT ]{};
+    U64 mGridErrors{ 0U };
+    U64 mAllocationsAtFirstFrame{ 0U };
+
+    U64 GetCommitCount() const
+    {
+        return mCommitScheduler.GetCommitCount();
+    }
+
+  protected:
+    void AddResultFrame( U64 end_sample )
+    {
+        mResultFrames++;
+        mCommitScheduler.AddFrame( end_sample );
+    }
+
+    void CheckGrid( BitRate bit_rate )
+    {
+        // a bit of 128 carrier periods at 106 kbit/s, half of it at every step up
+        U64 seq_num = mFrameSequences - 1;
+        U64 expected_sample = mFrameFirstSeqStart + seq_num * mGridSampleRateHz * ( 128 >> U32( bit_rate ) ) / mGridCarrierHz;
+        if( ( mFrameLastSeqStart + 1 < expected_sample ) || ( mFrameLastSeqStart > expected_sample + 1 ) )
+        {
+            mGridErrors++;
+            fprintf( stderr, "grid: sequence %llu of the frame at %llu starts at %llu instead of %llu\n", seq_num, mFrameFirstSeqStart,
+                     mFrameLastSeqStart, expected_sample );
+        }
+    }
+
+    void Record( ResultFrameRecord::Type type, U64 start_sample, U64 end_sample, U8 value, U8 valid_bits, bool parity_error )
+    {
+        if( mRecords != nullptr )
+        {
+            mRecords->push_back( ResultFrameRecord{ start_sample, end_sample, type, value, valid_bits, parity_error } );
+        }
+    }
+
+    bool mPrintFrames;
+    bool mOutputBytes;
+    CommitScheduler mCommitScheduler;
+
+    bool mDecodeCommands{ false };
+    bool mIsResponse{ false };
+    CommandDecoder mCommandDecoder;
+    ApduReplaySink& mApduSink;
+    BlockDecoder mBlockDecoder;
+    PcapngWriter* mPcapngWriter{ nullptr };
+    std::vector<ResultFrameRecord>* mRecords{ nullptr };
+    LoadmodDecoder* mLoadmodDecoder{ nullptr };
+
+    U32 mGridSampleRateHz{ 0U };
+    U32 mGridCarrierHz{ 0U };
+    U64 mFrameSequences{ 0U };
+    U64 mFrameFirstSeqStart{ 0U };
+    U64 mFrameLastSeqStart{ 0U };
+};
+
+// Counts the command/response pairs of the dual channel decoding and optionally prints them. The responses are also labelled
+// without their commands, as the LOADMOD analyzer does. Unless PCD frames were lost, the labels must be the same over all
+// sessions of the capture.
+class TransactionReplaySink : public TransactionSink
+{
+  public:
+    TransactionReplaySink( bool print_transactions, ApduReplaySink& apdu_sink )
+        : mPrintTransactions( print_transactions ), mApduSink( apdu_sink ), mBlockDecoder( apdu_sink )
+    {
+    }
+
+    void SetPrintTransactions( bool print_transactions )
+    {
+        mPrintTransactions = print_transactions;
+    }
+
+    void SetPcapngWriter( PcapngWriter* pcapng_writer )
+    {
+        mPcapngWriter = pcapng_writer;
+    }
+
+    void ResetCommandDecoding()
+    {
+        mCommandDecoder.Reset();
+        mResponseOnlyDecoder.Reset();
+        mBlockDecoder.Reset();
+    }
+
+    virtual void OnTransaction( const DecodedFrame* command, const DecodedFrame* response, U64 start_sample, U64 end_sample )
+    {
+        mTransactions++;
+        if( ( command != nullptr ) && ( response != nullptr ) )
+        {
+            mPairedTransactions++;
+        }
+
+        CommandType command_type = CommandType::Unknown;
+        CommandType response_type = CommandType::Unknown;
+        if( command != nullptr )
+        {
+            command_type = mCommandDecoder.DecodeCommand( *command );
+            mFramesPerCommandType[ U32( command_type ) ]++;
+        }
+        if( response != nullptr )
+        {
+            response_type = mCommandDecoder.DecodeResponse( *response );
+            mFramesPerCommandType[ U32( response_type ) ]++;
+
+            mResponses++;
+            if( mResponseOnlyDecoder.DecodeResponse( *response ) != response_type )
+            {
+                mResponseOnlyMismatches++;
+            }
+        }
+
+        BlockInfo block;
+        if( ( command != nullptr ) && ( command_type == CommandType::Unknown ) &&
+            mBlockDecoder.DecodeBlock( *command, false, command->frame_start_sample, command->frame_end_sample - 1, block ) )
+        {
+            mApduSink.AddBlock( block );
+        }
+        if( ( response != nullptr ) && ( response_type == CommandType::Unknown ) &&
+            mBlockDecoder.DecodeBlock( *response, true, response->frame_start_sample, response->frame_end_sample, block ) )
+        {
+            mApduSink.AddBlock( block );
+        }
+
+        if( mPcapngWriter != nullptr )
+        {
+            WritePacket( command, false );
+            WritePacket( response, true );
+        }
+
+        if( mPrintTransactions )
+        {
+            printf( "%llu,%llu,", start_sample, end_sample );
+            PrintFrame( command );
+            printf( "," );
+            PrintFrame( response );
+            printf( ",%s,%s\n", GetCommandTypeString( command_type ), GetCommandTypeString( response_type ) );
+        }
+    }
+
+    U64 mTransactions{ 0U };
+    U64 mPairedTransactions{ 0U };
+    U64 mFramesPerCommandType[ COMMAND_TYPE_COUNT ]{};
+    U64 mResponses{ 0U };
+    U64 mResponseOnlyMismatches{ 0U };
+
+  protected:
+    static void PrintFrame( const DecodedFrame* frame )
+    {
+        if( frame == nullptr )
+        {
+            printf( "NONE," );
+            return;
+        }
+
+        printf( "%s,", GetFrameStatusString( frame->error ) );
+        for( U8 byte : frame->data )
+        {
+            printf( "%02X", byte );
+        }
+    }
+
+    void WritePacket( const DecodedFrame* frame, bool is_response )
+    {
+        if( frame != nullptr )
+        {
+            const char* comment = frame->error != DecodedFrame::Error::Ok ? GetFrameStatusString( frame->error ) : nullptr;
+            mPcapngWriter->WritePacket( is_response, frame->frame_start_sample, frame->data.data(), frame->data.size(), comment );
+        }
+    }
+
+    bool mPrintTransactions;
+    CommandDecoder mCommandDecoder;
+    CommandDecoder mResponseOnlyDecoder;
+    ApduReplaySink& mApduSink;
+    BlockDecoder mBlockDecoder;
+    PcapngWriter* mPcapngWriter{ nullptr };
+};
+
+// Reads a digital channel exported by Logic 2 as CSV ("Time [s],Channel 0", one row per transition).
+static bool ReadLogicCsv( const char* file_name, U32 sample_rate_hz, EdgeStreamHeader& header, std::vector<U64>& edges )
+{
+    std::ifstream file_stream( file_name );
+    if( !file_stream )
+    {
+        return false;
+    }
+
+    std::string line;
+    std::getline( file_stream, line ); // column titles
+
+    bool first_row = true;
+    double first_time = 0.0;
+    while( std::getline( file_stream, line ) )
+    {
+        const char* separator = strchr( line.c_str(), ',' );
+        if( separator == nullptr )
+        {
+            continue;
+        }
+
+        double time = atof( line.c_str() );
+        if( first_row )
+        {
+            first_time = time;
+            header.initial_state = atoi( separator + 1 ) ? LINE_HIGH : LINE_LOW;
+            first_row = false;
+            continue;
+        }
+
+        edges.push_back( U64( llround( ( time - first_time ) * sample_rate_hz ) ) );
+    }
+
+    header.sample_rate_hz = sample_rate_hz;
+    return !first_row;
+}
+
+static bool ReadCapture( const char* file_name, U32 sample_rate_hz, EdgeStreamHeader& header, std::vector<U64>& edges )
+{
+    size_t name_length = strlen( file_name );
+    bool is_csv = ( name_length > 4 ) && ( strcmp( file_name + name_length - 4, ".csv" ) == 0 );
+    if( is_csv ? !ReadLogicCsv( file_name, sample_rate_hz, header, edges ) : !ReadEdgeFile( file_name, header, edges ) )
+    {
+        fprintf( stderr, "could not read capture %s\n", file_name );
+        return false;
+    }
+    if( header.sample_rate_hz == 0 )
+    {
+        fprintf( stderr, "unknown sample rate, use --sample-rate\n" );
+        return false;
+    }
+    return true;
+}
+
+// bit by bit CRC_A, the reference for the table driven kernel
+static U16 CalculateCrcABitwise( const U8* data, size_t length )
+{
+    U16 crc = CRC_A_PRESET;
+    for( size_t i = 0; i < length; i++ )
+    {
+        crc ^= data[ i ];
+        for( U32 bit = 0; bit < 8; bit++ )
+        {
+            crc = ( crc & 1 ) ? U16( ( crc >> 1 ) ^ 0x8408 ) : U16( crc >> 1 );
+        }
+    }
+    return crc;
+}
+
+// Measures the CRC_A kernel per byte on frames of the given length, the checksums are compared against the bit wise reference.
+static int RunCrcBenchmark( U32 frame_length, U32 repeat )
+{
+    static const U32 BUFFER_SIZE = 1 << 20;
+    if( frame_length == 0 )
+    {
+        frame_length = 1;
+    }
+    U32 frame_count = BUFFER_SIZE / frame_length;
+
+    std::vector<U8> buffer( size_t( frame_count ) * frame_length );
+    U32 random = 0x12345678;
+    for( U8& byte : buffer )
+    {
+        random = random * 1103515245 + 12345;
+        byte = U8( random >> 16 );
+    }
+
+    U16 table_sum = 0;
+    U16 bitwise_sum = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for( U32 pass = 0; pass < repeat; pass++ )
+    {
+        for( U32 frame = 0; frame < frame_count; frame++ )
+        {
+            table_sum ^= CalculateCrcA( &buffer[ size_t( frame ) * frame_length ], frame_length );
+        }
+    }
+    double table_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+
+    start_time = std::chrono::steady_clock::now();
+    for( U32 pass = 0; pass < repeat; pass++ )
+    {
+        for( U32 frame = 0; frame < frame_count; frame++ )
+        {
+            bitwise_sum ^= CalculateCrcABitwise( &buffer[ size_t( frame ) * frame_length ], frame_length );
+        }
+    }
+    double bitwise_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+
+    static const U8 check_data[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    bool matches = ( table_sum == bitwise_sum ) && ( CalculateCrcA( check_data, sizeof( check_data ) ) == 0xBF05 );
+
+    double bytes = double( buffer.size() ) * repeat;
+    fprintf( stderr, "frame length: %u bytes\n", frame_length );
+    fprintf( stderr, "bytes:        %.0f\n", bytes );
+    fprintf( stderr, "table:        %.2f ns/byte\n", table_s * 1e9 / bytes );
+    fprintf( stderr, "bitwise:      %.2f ns/byte\n", bitwise_s * 1e9 / bytes );
+    fprintf( stderr, "checksums:    %s\n", matches ? "match" : "MISMATCH" );
+    return matches ? 0 : 1;
+}
+
+// Writes the recorded result frames the way the analyzers export them (sequences, bytes or frames) and measures the rows per second.
+static bool RunExport( const std::vector<ResultFrameRecord>& records, const char* export_type, const char* file_name, U32 sample_rate_hz,
+                       bool is_ask )
+{
+    static const char* const ask_sequence_names[] = { "Y", "X", "Z" };
+    static const char* const loadmod_sequence_names[] = { "F", "E", "D" };
+    const char* const* sequence_names = is_ask ? ask_sequence_names : loadmod_sequence_names;
+    bool is_response = !is_ask;
+
+    ExportWriter writer;
+    if( !writer.Open( file_name, 0, sample_rate_hz, NumberFormat::Hexadecimal, false ) )
+    {
+        fprintf( stderr, "could not write %s\n", file_name );
+        return false;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    if( strcmp( export_type, "sequences" ) == 0 )
+    {
+        writer.WriteSequenceHeader();
+        for( const ResultFrameRecord& record : records )
+        {
+            if( record.type == ResultFrameRecord::Type::Sequence )
+            {
+                writer.WriteSequenceRow( record.start_sample, record.end_sample, is_response,
+                                         record.value < 3 ? sequence_names[ record.value ] : "ERROR" );
+            }
+        }
+    }
+    else if( strcmp( export_type, "bytes" ) == 0 )
+    {
+        writer.WriteByteHeader();
+        for( const ResultFrameRecord& record : records )
+        {
+            if( record.type == ResultFrameRecord::Type::Byte )
+            {
+                writer.WriteByteRow( record.start_sample, record.end_sample, is_response, record.value, record.valid_bits,
+                                     record.parity_error );
+            }
+        }
+    }
+    else
+    {
+        writer.WriteFrameHeader();
+        for( const ResultFrameRecord& record : records )
+        {
+            switch( record.type )
+            {
+                case ResultFrameRecord::Type::Soc:
+                    writer.StartFrame( is_response, record.start_sample, record.end_sample );
+                    break;
+                case ResultFrameRecord::Type::Byte:
+                    writer.AddByte( is_response, record.value, record.valid_bits, record.parity_error, record.end_sample );
+                    break;
+                case ResultFrameRecord::Type::Eoc:
+                    writer.EndFrame( is_response, record.end_sample );
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    bool written = writer.Close();
+    double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+
+    fprintf( stderr, "export:       %llu %s rows, %llu bytes in %.3f s", writer.GetRowCount(), export_type, writer.GetBytesWritten(),
+             elapsed_s );
+    if( elapsed_s > 0.0 )
+    {
+        fprintf( stderr, " (%.0f rows/s)", writer.GetRowCount() / elapsed_s );
+    }
+    fprintf( stderr, "\n" );
+    if( !written )
+    {
+        fprintf( stderr, "could not write %s\n", file_name );
+    }
+    return written;
+}
+
+// The calibration pre-pass: decodes the first frames of the capture until the decoder measured the carrier, the passes after
+// it decode the whole capture with the measured carrier, so a segmented decoding gives the same frames as a single pass.
+static U32 MeasureAskCarrier( const EdgeStreamHeader& header, const std::vector<U64>& edges, LineState idle_state,
+                              AskSequenceDetection detection, BitRate bit_rate, bool detect_bit_rate, U32 carrier_hz, U32 frame_count )
+{
+    ReplayEdgeSource source( edges.data(), edges.size(), header.initial_state );
+    DecoderSink sink;
+    AskDecoder decoder( source, sink );
+    decoder.Setup( header.sample_rate_hz, carrier_hz, idle_state, detection );
+    decoder.SetMarkerDetail( MarkerDetail::None );
+    decoder.SetBitRate( bit_rate );
+    decoder.SetBitRateDetection( detect_bit_rate );
+    decoder.SetCarrierCalibration( frame_count );
+    decoder.WaitForIdle();
+    while( decoder.IsCalibrating() && decoder.DecodeFrame() )
+    {
+    }
+    return decoder.GetCarrierHz();
+}
+
+static U32 MeasureLoadmodCarrier( const EdgeStreamHeader& header, const std::vector<U64>& edges, LineState idle_state,
+                                  LoadmodSequenceDetection detection, U32 carrier_hz, U32 frame_count )
+{
+    ReplayEdgeSource source( edges.data(), edges.size(), header.initial_state );
+    DecoderSink sink;
+    LoadmodDecoder decoder( source, sink );
+    decoder.Setup( header.sample_rate_hz, carrier_hz, idle_state, detection );
+    decoder.SetMarkerDetail( MarkerDetail::None );
+    decoder.SetCarrierCalibration( frame_count );
+    decoder.WaitForIdle();
+    while( decoder.IsCalibrating() && decoder.DecodeFrame() )
+    {
+    }
+    return decoder.GetCarrierHz();
+}
+
+static void PrintUsage()
+{
+    fprintf( stderr, "usage: Iso14443aReplay ask|loadmod <capture> [options]\n"
+                     "       Iso14443aReplay dual <ask capture> <loadmod capture> [options]\n"
+                     "       Iso14443aReplay crc <frame length> [--repeat <n>]\n"
+                     "  <capture>            edge stream (.edges) or Logic 2 digital CSV export (.csv)\n"
+                     "                       dual decodes both channels of a capture in one pass and pairs commands with responses\n"
+                     "  --idle high|low      idle state of the channel (default: high for ask, low for loadmod)\n"
+                     "  --sample-rate <hz>   sample rate of a CSV capture\n"
+                     "  --pause-edges        ask: classify the sequences by their pause edges instead of sampling points\n"
+                     "  --bit-rate 106|212|424|848|detect   ask: bit rate of the frames (default: 106)\n"
+                     "  --subcarrier-edges   loadmod: detect the subcarrier per bit half instead of counting edges between quarters\n"
+                     "  --envelope           loadmod: the capture is the demodulated envelope of the subcarrier\n"
+                     "  --carrier <hz>       carrier frequency of the reader (default: 13560000)\n"
+                     "  --calibrate <n>      measure the carrier on the first n frames without errors, needs the clock recovery\n"
+                     "  --fixed-grid         keep the nominal bit grid instead of re-anchoring it on the pause / subcarrier edges\n"
+                     "  --resync-gap <bits>  idle bits to skip to after a broken frame, 0 disables (default: 3 for ask, 2 for loadmod)\n"
+                     "  --markers none|errors|starts|all   marker detail level (default: all)\n"
+                     "  --output sequences|bytes   result frames the analyzer would add (default: bytes)\n"
+                     "  --repeat <n>         decode the capture n times (default: 1)\n"
+                     "  --threads <n>        ask/loadmod: decode segments between idle gaps on n threads (default: 0, one pass)\n"
+                     "  --print              print every decoded frame\n"
+                     "  --pcapng <file>      export the frames of the first pass as pcapng (LINKTYPE_ISO_14443)\n"
+                     "  --export sequences|bytes|frames <file>   ask/loadmod: csv export of the first pass, measures rows/s\n"
+                     "  --check-grid         ask/loadmod: exits with 2 unless every frame is decoded without errors and its last sequence\n"
+                     "                       starts floor( n * samples per bit ) +-1 after its first one, needs --fixed-grid\n"
+                     "  --check-allocations  ask/loadmod: exits with 2 if the first pass allocates after its first frame\n" );
+}
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 3 )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if( strcmp( argv[ 1 ], "crc" ) == 0 )
+    {
+        U32 crc_repeat = 16;
+        if( ( argc == 5 ) && ( strcmp( argv[ 3 ], "--repeat" ) == 0 ) )
+        {
+            crc_repeat = U32( strtoul( argv[ 4 ], nullptr, 10 ) );
+        }
+        else if( argc != 3 )
+        {
+            PrintUsage();
+            return 1;
+        }
+        return RunCrcBenchmark( U32( strtoul( argv[ 2 ], nullptr, 10 ) ), crc_repeat );
+    }
+
+    bool is_ask = strcmp( argv[ 1 ], "ask" ) == 0;
+    bool is_dual = strcmp( argv[ 1 ], "dual" ) == 0;
+    if( !is_ask && !is_dual && ( strcmp( argv[ 1 ], "loadmod" ) != 0 ) )
+    {
+        PrintUsage();
+        return 1;
+    }
+    if( is_dual && ( argc < 4 ) )
+    {
+        PrintUsage();
+        return 1;
+    }
+    const char* capture_file = argv[ 2 ];
+    const char* picc_capture_file = is_dual ? argv[ 3 ] : nullptr;
+
+    LineState idle_state = is_ask ? LINE_HIGH : LINE_LOW;
+    U32 sample_rate_hz = 0;
+    U32 repeat = 1;
+    U32 thread_count = 0;
+    bool print_frames = false;
+    bool output_bytes = true;
+    AskSequenceDetection ask_detection = AskSequenceDetection::SamplingPoints;
+    LoadmodSequenceDetection loadmod_detection = LoadmodSequenceDetection::SamplingPoints;
+    MarkerDetail marker_detail = MarkerDetail::SamplingPoints;
+    BitRate bit_rate = BitRate::Fc128;
+    bool detect_bit_rate = false;
+    S32 resync_gap_bits = -1;
+    bool clock_recovery = true;
+    U32 carrier_hz = NOMINAL_CARRIER_HZ;
+    U32 calibration_frames = 0;
+    const char* pcapng_file = nullptr;
+    const char* export_type = nullptr;
+    const char* export_file = nullptr;
+    bool check_grid = false;
+    bool check_allocations = false;
+    for( int i = is_dual ? 4 : 3; i < argc; i++ )
+    {
+        if( ( strcmp( argv[ i ], "--idle" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            idle_state = strcmp( argv[ ++i ], "low" ) == 0 ? LINE_LOW : LINE_HIGH;
+        }
+        else if( ( strcmp( argv[ i ], "--sample-rate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            sample_rate_hz = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--repeat" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            repeat = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--threads" ) == 0 ) && ( i + 1 < argc ) && !is_dual )
+        {
+            thread_count = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( strcmp( argv[ i ], "--pause-edges" ) == 0 )
+        {
+            ask_detection = AskSequenceDetection::PauseEdges;
+        }
+        else if( strcmp( argv[ i ], "--subcarrier-edges" ) == 0 )
+        {
+            loadmod_detection = LoadmodSequenceDetection::SubcarrierEdges;
+        }
+        else if( strcmp( argv[ i ], "--envelope" ) == 0 )
+        {
+            loadmod_detection = LoadmodSequenceDetection::Envelope;
+        }
+        else if( ( strcmp( argv[ i ], "--bit-rate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            i++;
+            detect_bit_rate = strcmp( argv[ i ], "detect" ) == 0;
+            for( U32 rate = 0; rate < BIT_RATE_COUNT; rate++ )
+            {
+                if( strtoul( argv[ i ], nullptr, 10 ) == GetBitRateKbps( BitRate( rate ) ) )
+                {
+                    bit_rate = BitRate( rate );
+                }
+            }
+        }
+        else if( ( strcmp( argv[ i ], "--carrier" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            carrier_hz = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--calibrate" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            calibration_frames = U32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( strcmp( argv[ i ], "--fixed-grid" ) == 0 )
+        {
+            clock_recovery = false;
+        }
+        else if( ( strcmp( argv[ i ], "--resync-gap" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            resync_gap_bits = S32( strtoul( argv[ ++i ], nullptr, 10 ) );
+        }
+        else if( ( strcmp( argv[ i ], "--markers" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            i++;
+            if( strcmp( argv[ i ], "none" ) == 0 )
+                marker_detail = MarkerDetail::None;
+            else if( strcmp( argv[ i ], "errors" ) == 0 )
+                marker_detail = MarkerDetail::Errors;
+            else if( strcmp( argv[ i ], "starts" ) == 0 )
+                marker_detail = MarkerDetail::SequenceStarts;
+            else
+                marker_detail = MarkerDetail::SamplingPoints;
+        }
+        else if( ( strcmp( argv[ i ], "--output" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            output_bytes = strcmp( argv[ ++i ], "sequences" ) != 0;
+        }
+        else if( strcmp( argv[ i ], "--print" ) == 0 )
+        {
+            print_frames = true;
+        }
+        else if( ( strcmp( argv[ i ], "--pcapng" ) == 0 ) && ( i + 1 < argc ) )
+        {
+            pcapng_file = argv[ ++i ];
+        }
+        else if( ( strcmp( argv[ i ], "--export" ) == 0 ) && ( i + 2 < argc ) && !is_dual )
+        {
+            export_type = argv[ ++i ];
+            export_file = argv[ ++i ];
+        }
+        else if( ( strcmp( argv[ i ], "--check-grid" ) == 0 ) && !is_dual )
+        {
+            check_grid = true;
+        }
+        else if( ( strcmp( argv[ i ], "--check-allocations" ) == 0 ) && !is_dual )
+        {
+            check_allocations = true;
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    EdgeStreamHeader header;
+    std::vector<U64> edges;
+    if( !ReadCapture( capture_file, sample_rate_hz, header, edges ) )
+    {
+        return 1;
+    }
+
+    EdgeStreamHeader picc_header;
+    std::vector<U64> picc_edges;
+    if( is_dual )
+    {
+        if( !ReadCapture( picc_capture_file, sample_rate_hz, picc_header, picc_edges ) )
+        {
+            return 1;
+        }
+        if( picc_header.sample_rate_hz != header.sample_rate_hz )
+        {
+            fprintf( stderr, "both captures must have the same sample rate\n" );
+            return 1;
+        }
+    }
+
+    if( !IsValidCarrier( carrier_hz ) )
+    {
+        fprintf( stderr, "--carrier must be between %u and %u Hz\n", MIN_CARRIER_HZ, MAX_CARRIER_HZ );
+        return 1;
+    }
+
+    if( ( calibration_frames > 0 ) && !clock_recovery )
+    {
+        fprintf( stderr, "--calibrate needs the clock recovery, it measures the edges the bit grid aligns to\n" );
+        return 1;
+    }
+
+    if( check_grid && clock_recovery )
+    {
+        fprintf( stderr, "--check-grid needs --fixed-grid, the clock recovery moves the bit grid to the edges\n" );
+        return 1;
+    }
+
+    if( check_allocations && ( thread_count > 0 ) )
+    {
+        fprintf( stderr, "--check-allocations needs a single pass without --threads, the segments allocate their own buffers\n" );
+        return 1;
+    }
+
+    // the PICC channel of a dual capture is measured on its own
+    U32 pcd_carrier_hz = carrier_hz;
+    U32 picc_carrier_hz = carrier_hz;
+    auto calibration_start_time = std::chrono::steady_clock::now();
+    if( calibration_frames > 0 )
+    {
+        if( is_dual )
+        {
+            pcd_carrier_hz = MeasureAskCarrier( header, edges, LINE_HIGH, ask_detection, bit_rate, detect_bit_rate, carrier_hz,
+                                                calibration_frames );
+            picc_carrier_hz = MeasureLoadmodCarrier( picc_header, picc_edges, LINE_LOW, loadmod_detection, carrier_hz, calibration_frames );
+        }
+        else if( is_ask )
+        {
+            pcd_carrier_hz = MeasureAskCarrier( header, edges, idle_state, ask_detection, bit_rate, detect_bit_rate, carrier_hz,
+                                                calibration_frames );
+        }
+        else
+        {
+            picc_carrier_hz = MeasureLoadmodCarrier( header, edges, idle_state, loadmod_detection, carrier_hz, calibration_frames );
+        }
+    }
+    double calibration_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - calibration_start_time ).count();
+
+    ApduReplaySink apdu_sink( print_frames );
+    ReplaySink sink( print_frames && !is_dual, output_bytes, apdu_sink );
+    TransactionReplaySink transaction_sink( print_frames, apdu_sink );
+    sink.SetupCommits( header.sample_rate_hz );
+    if( check_grid )
+    {
+        sink.SetupGridCheck( header.sample_rate_hz, is_ask ? pcd_carrier_hz : picc_carrier_hz );
+    }
+
+    PcapngWriter pcapng_writer;
+    if( pcapng_file != nullptr )
+    {
+        if( !pcapng_writer.Open( pcapng_file, header.sample_rate_hz ) )
+        {
+            fprintf( stderr, "could not write %s\n", pcapng_file );
+            return 1;
+        }
+        // the dual decoder reports both channels to one sink, the transactions know the direction
+        if( is_dual )
+        {
+            transaction_sink.SetPcapngWriter( &pcapng_writer );
+        }
+        else
+        {
+            sink.SetPcapngWriter( &pcapng_writer );
+        }
+    }
+
+    std::vector<ResultFrameRecord> records;
+    if( export_file != nullptr )
+    {
+        sink.SetResultFrameRecords( &records );
+    }
+
+    // a resync after a broken frame must end within the gap, so a segment never decodes into the next one
+    U64 split_gap_periods = std::max( U64( MIN_FRAME_DELAY_CARRIER_PERIODS ), U64( std::max( resync_gap_bits, 0 ) ) * 128 );
+    SegmentedDecoder segmented_decoder( thread_count );
+    segmented_decoder.Setup( split_gap_periods * header.sample_rate_hz / carrier_hz, idle_state );
+
+    U64 allocations_before_decoding = allocation_count;
+    U64 allocations_after_first_frame = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for( U32 pass = 0; pass < repeat; pass++ )
+    {
+        ReplayEdgeSource source( edges.data(), edges.size(), header.initial_state );
+        if( is_dual )
+        {
+            transaction_sink.ResetCommandDecoding();
+            // both channels report to the same sink, as both end up in the result store of one analyzer
+            ReplayEdgeSource picc_source( picc_edges.data(), picc_edges.size(), picc_header.initial_state );
+            DualDecoder decoder( source, picc_source, sink, sink, transaction_sink );
+            decoder.GetPcdDecoder().Setup( header.sample_rate_hz, pcd_carrier_hz, LINE_HIGH, ask_detection );
+            decoder.GetPcdDecoder().SetMarkerDetail( marker_detail );
+            decoder.GetPcdDecoder().SetBitRate( bit_rate );
+            decoder.GetPcdDecoder().SetBitRateDetection( detect_bit_rate );
+            decoder.GetPiccDecoder().Setup( header.sample_rate_hz, picc_carrier_hz, LINE_LOW, loadmod_detection );
+            decoder.GetPiccDecoder().SetMarkerDetail( marker_detail );
+            decoder.GetPcdDecoder().SetClockRecovery( clock_recovery );
+            decoder.GetPiccDecoder().SetClockRecovery( clock_recovery );
+            if( resync_gap_bits >= 0 )
+            {
+                decoder.GetPcdDecoder().SetResyncGap( U32( resync_gap_bits ) );
+                decoder.GetPiccDecoder().SetResyncGap( U32( resync_gap_bits ) );
+            }
+            decoder.Setup( header.sample_rate_hz / 1000 );
+            decoder.WaitForIdle();
+            while( decoder.DecodeFrame() )
+            {
+            }
+        }
+        else
+        {
+            SegmentedDecoder::SegmentDecodeFunction decode = [&]( EdgeSource& decoder_source, DecoderSink& decoder_sink ) {
+                if( is_ask )
+                {
+                    AskDecoder decoder( decoder_source, decoder_sink );
+                    decoder.Setup( header.sample_rate_hz, pcd_carrier_hz, idle_state, ask_detection );
+                    decoder.SetMarkerDetail( marker_detail );
+                    if( resync_gap_bits >= 0 )
+                    {
+                        decoder.SetResyncGap( U32( resync_gap_bits ) );
+                    }
+                    decoder.SetBitRate( bit_rate );
+                    decoder.SetBitRateDetection( detect_bit_rate );
+                    decoder.SetClockRecovery( clock_recovery );
+                    decoder.WaitForIdle();
+                    while( decoder.DecodeFrame() )
+                    {
+                    }
+                }
+                else
+                {
+                    LoadmodDecoder decoder( decoder_source, decoder_sink );
+                    decoder.Setup( header.sample_rate_hz, picc_carrier_hz, idle_state, loadmod_detection );
+                    decoder.SetMarkerDetail( marker_detail );
+                    if( resync_gap_bits >= 0 )
+                    {
+                        decoder.SetResyncGap( U32( resync_gap_bits ) );
+                    }
+                    decoder.SetClockRecovery( clock_recovery );
+                    // the command decoding of the sink tells the decoder when a UID CLn may come, segments are decoded without it
+                    bool follows_commands = &decoder_sink == &sink;
+                    if( follows_commands )
+                    {
+                        sink.SetLoadmodDecoder( &decoder );
+                    }
+                    decoder.WaitForIdle();
+                    while( decoder.DecodeFrame() )
+                    {
+                    }
+                    if( follows_commands )
+                    {
+                        sink.SetLoadmodDecoder( nullptr );
+                    }
+                }
+            };
+
+            sink.SetupCommandDecoding( !is_ask );
+            if( thread_count > 0 )
+            {
+                segmented_decoder.Decode( edges.data(), edges.size(), header.initial_state, decode, sink );
+            }
+            else
+            {
+                decode( source, sink );
+            }
+        }
+        if( ( pass == 0 ) && ( sink.mFrames > 0 ) )
+        {
+            allocations_after_first_frame = allocation_count - sink.mAllocationsAtFirstFrame;
+        }
+        sink.SetPrintFrames( false );
+        sink.SetPcapngWriter( nullptr );
+        sink.SetResultFrameRecords( nullptr );
+        transaction_sink.SetPrintTransactions( false );
+        transaction_sink.SetPcapngWriter( nullptr );
+        apdu_sink.SetPrintApdus( false );
+    }
+    double elapsed_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+    U64 decoding_allocations = allocation_count - allocations_before_decoding;
+
+    if( ( pcapng_file != nullptr ) && !pcapng_writer.Close() )
+    {
+        fprintf( stderr, "could not write %s\n", pcapng_file );
+        return 1;
+    }
+
+    U64 last_edge = edges.empty() ? 0 : edges.back();
+    if( !picc_edges.empty() )
+    {
+        last_edge = std::max( last_edge, picc_edges.back() );
+    }
+    double capture_s = double( last_edge ) / header.sample_rate_hz;
+    U64 total_edges = U64( edges.size() + picc_edges.size() ) * repeat;
+    fprintf( stderr, "edges:        %llu\n", total_edges );
+    if( calibration_frames > 0 )
+    {
+        if( is_dual )
+        {
+            fprintf( stderr, "carrier:      PCD %u Hz, PICC %u Hz (calibrated in %.3f s)\n", pcd_carrier_hz, picc_carrier_hz,
+                     calibration_s );
+        }
+        else
+        {
+            fprintf( stderr, "carrier:      %u Hz (calibrated in %.3f s)\n", is_ask ? pcd_carrier_hz : picc_carrier_hz, calibration_s );
+        }
+    }
+    fprintf( stderr, "frames:       %llu (%llu with errors)\n", sink.mFrames, sink.mErrorFrames );
+    for( U32 rate = 0; rate < BIT_RATE_COUNT; rate++ )
+    {
+        if( sink.mFramesPerBitRate[ rate ] > 0 )
+        {
+            fprintf( stderr, "  %3u kbit/s: %llu\n", GetBitRateKbps( BitRate( rate ) ), sink.mFramesPerBitRate[ rate ] );
+        }
+    }
+    fprintf( stderr, "crc:          %llu ok, %llu errors, %llu without crc\n",
+             sink.mFramesPerCrcStatus[ U32( DecodedFrame::CrcStatus::Ok ) ],
+             sink.mFramesPerCrcStatus[ U32( DecodedFrame::CrcStatus::Wrong ) ],
+             sink.mFramesPerCrcStatus[ U32( DecodedFrame::CrcStatus::NotPresent ) ] );
+    if( is_dual )
+    {
+        fprintf( stderr, "transactions: %llu (%llu with command and response)\n", transaction_sink.mTransactions,
+                 transaction_sink.mPairedTransactions );
+        fprintf( stderr, "picc only:    %s (%llu of %llu responses labelled differently)\n",
+                 transaction_sink.mResponseOnlyMismatches == 0 ? "match" : "MISMATCH", transaction_sink.mResponseOnlyMismatches,
+                 transaction_sink.mResponses );
+    }
+    const U64* frames_per_command_type = is_dual ? transaction_sink.mFramesPerCommandType : sink.mFramesPerCommandType;
+    fprintf( stderr, "types:       " );
+    for( U32 type = 0; type < COMMAND_TYPE_COUNT; type++ )
+    {
+        if( frames_per_command_type[ type ] > 0 )
+        {
+            fprintf( stderr, " %s %llu", GetCommandTypeString( CommandType( type ) ), frames_per_command_type[ type ] );
+        }
+    }
+    fprintf( stderr, "\n" );
+    fprintf( stderr, "blocks:      " );
+    for( U32 type = U32( BlockType::I ); type < BLOCK_TYPE_COUNT; type++ )
+    {
+        fprintf( stderr, " %s %llu", GetBlockTypeString( BlockType( type ) ), apdu_sink.mBlocksPerType[ type ] );
+    }
+    fprintf( stderr, "\n" );
+    fprintf( stderr, "apdus:        %llu (%llu chained, %llu bytes, longest %llu)\n", apdu_sink.mApdus, apdu_sink.mChainedApdus,
+             apdu_sink.mApduBytes, apdu_sink.mMaxApduLength );
+    fprintf( stderr, "resyncs:      %llu (skipped %llu samples, %llu edges)\n", sink.mResyncs, sink.mResyncSkippedSamples,
+             sink.mResyncSkippedEdges );
+    fprintf( stderr, "bytes:        %llu\n", sink.mBytes );
+    fprintf( stderr, "sequences:    %llu\n", sink.mSequences );
+    fprintf( stderr, "markers:      %llu\n", sink.mMarkers );
+    fprintf( stderr, "commits:      %llu (unbatched: %llu)\n", sink.GetCommitCount(), sink.mResultFrames );
+    fprintf( stderr, "allocations:  %llu (%llu after the first frame of the first pass)\n", decoding_allocations,
+             allocations_after_first_frame );
+    if( thread_count > 0 )
+    {
+        fprintf( stderr, "segments:     %llu on %u threads (%llu stolen)\n", segmented_decoder.GetSegmentCount(), thread_count,
+                 segmented_decoder.GetStolenSegments() );
+    }
+    fprintf( stderr, "elapsed:      %.3f s\n", elapsed_s );
+    if( elapsed_s > 0.0 )
+    {
+        fprintf( stderr, "edges/s:      %.0f\n", total_edges / elapsed_s );
+        fprintf( stderr, "realtime:     %.1fx\n", capture_s * repeat / elapsed_s );
+    }
+
+    if( ( export_file != nullptr ) && !RunExport( records, export_type, export_file, header.sample_rate_hz, is_ask ) )
+    {
+        return 1;
+    }
+
+    if( check_allocations && ( allocations_after_first_frame > 0 ) )
+    {
+        return 2;
+    }
+    if( check_grid )
+    {
+        fprintf( stderr, "grid:         %llu frames off the bit grid\n", sink.mGridErrors );
+        if( ( sink.mGridErrors > 0 ) || ( sink.mErrorFrames > 0 ) )
+        {
+            return 2;
+        }
+    }
+
+    return 0;
+}